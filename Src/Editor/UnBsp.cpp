@@ -102,6 +102,164 @@ INDEX		GLastCoplanar;	// Last coplanar beneath GNode at start of AddWorldToBrush
 INDEX		GNumNodes;		// Number of Bsp nodes at start of AddWorldToBrush.
 UModel		*GModel;		// Level map Model we're adding to.
 
+/*-----------------------------------------------------------------------------
+   Vertex welding index.
+-----------------------------------------------------------------------------*/
+
+//
+// A spatial hash over a point or vector table, for finding near-duplicates
+// without scanning the whole table. Entries are binned into cubic cells twice
+// as big as the largest threshold searched for, so every match lies in the
+// searched point's own cell or one of its 26 neighbors. Among the matches,
+// Find returns the lowest index, which is the one a linear scan finds first.
+//
+class FWeldIndex
+{
+public:
+	// Variables.
+	UVectors*	Table;		// Table being indexed, or NULL if inactive.
+	FLOAT		MaxThresh;	// Largest threshold which may be searched for.
+	FLOAT		RCell;		// 1.0 / cell size.
+	INT			Num;		// Number of table entries indexed so far.
+	INT			NumHash;	// Number of hash buckets, a power of two.
+	INT			MaxNext;	// Number of entries Next has room for.
+	INDEX*		Hash;		// First entry in each bucket, or INDEX_NONE.
+	INDEX*		Next;		// Next entry in the same bucket, or INDEX_NONE.
+
+	// Start indexing a table. No entries are indexed until Sync or Add.
+	void Init( UVectors *InTable, FLOAT InMaxThresh )
+	{
+		Table		= InTable;
+		MaxThresh	= InMaxThresh;
+		RCell		= 1.0 / (2.0 * InMaxThresh);
+		Num			= 0;
+		NumHash		= 1024;
+		MaxNext		= 0;
+		Hash		= (INDEX*)appMalloc( NumHash * sizeof(INDEX), "WeldHash" );
+		Next		= NULL;
+		memset( Hash, 0xff, NumHash * sizeof(INDEX) );
+	}
+
+	// Stop indexing and free the index.
+	void Exit()
+	{
+		if( Hash ) appFree( Hash );
+		if( Next ) appFree( Next );
+		Table = NULL;
+		Hash  = Next = NULL;
+		Num   = NumHash = MaxNext = 0;
+	}
+
+	// Forget all entries, for when the table has been rearranged.
+	void Reset()
+	{
+		Num = 0;
+		memset( Hash, 0xff, NumHash * sizeof(INDEX) );
+	}
+
+	// Index table entry i, which must be the next unindexed one.
+	void Add( INDEX i )
+	{
+		debugState(i==Num);
+		if( i >= MaxNext )
+		{
+			MaxNext = MaxNext*2 + 1024;
+			Next    = (INDEX*)appRealloc( Next, MaxNext * sizeof(INDEX), "WeldNext" );
+		}
+		if( i >= NumHash )
+		{
+			// Double the buckets and rehash everything indexed so far.
+			NumHash *= 2;
+			Hash     = (INDEX*)appRealloc( Hash, NumHash * sizeof(INDEX), "WeldHash" );
+			memset( Hash, 0xff, NumHash * sizeof(INDEX) );
+			for( INDEX j=0; j<i; j++ )
+				Insert( j );
+		}
+		Insert( i );
+		Num = i+1;
+	}
+
+	// Bring the index up to date with entries added to the table since the
+	// last call, starting over if the table has shrunk.
+	void Sync()
+	{
+		if( Table->Num < Num )
+			Reset();
+		while( Num < Table->Num )
+			Add( Num );
+	}
+
+	// Find the lowest indexed entry within Thresh of V along every axis or, if
+	// Sphere is set, within distance Thresh of V. Returns INDEX_NONE if none.
+	INDEX Find( const FVector &V, FLOAT Thresh, INT Sphere )
+	{
+		INDEX Best = INDEX_NONE;
+		INT X = Cell(V.X), Y = Cell(V.Y), Z = Cell(V.Z);
+		for( INT DX=-1; DX<=1; DX++ )
+		{
+			for( INT DY=-1; DY<=1; DY++ )
+			{
+				for( INT DZ=-1; DZ<=1; DZ++ )
+				{
+					for( INDEX i=Hash[Bucket(X+DX,Y+DY,Z+DZ)]; i!=INDEX_NONE; i=Next[i] )
+					{
+						if( Best!=INDEX_NONE && i>=Best )
+							continue;
+						const FVector &TableVect = Table->Element(i);
+						if( Sphere )
+						{
+							if( (TableVect - V).SizeSquared() < Thresh*Thresh )
+								Best = i;
+						}
+						else
+						{
+							FLOAT Temp=(V.X - TableVect.X);
+							if( (Temp > -Thresh) && (Temp < Thresh) )
+							{
+								Temp=(V.Y - TableVect.Y);
+								if( (Temp > -Thresh) && (Temp < Thresh) )
+								{
+									Temp=(V.Z - TableVect.Z);
+									if( (Temp > -Thresh) && (Temp < Thresh) )
+										Best = i;
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+		return Best;
+	}
+
+private:
+	// Cell coordinate along one axis.
+	INT Cell( FLOAT F )
+	{
+		return (INT)floor( F * RCell );
+	}
+
+	// Hash bucket of a cell.
+	INT Bucket( INT X, INT Y, INT Z )
+	{
+		return ((DWORD)X*73856093 ^ (DWORD)Y*19349663 ^ (DWORD)Z*83492791) & (NumHash-1);
+	}
+
+	// Link entry i into its bucket.
+	void Insert( INDEX i )
+	{
+		const FVector &V = Table->Element(i);
+		INT iBucket = Bucket( Cell(V.X), Cell(V.Y), Cell(V.Z) );
+		Next[i]       = Hash[iBucket];
+		Hash[iBucket] = i;
+	}
+};
+
+//
+// Welding indices of the model between bspWeldBegin and bspWeldEnd.
+//
+static FWeldIndex GWeldPoints, GWeldVectors;
+
 /*-----------------------------------------------------------------------------
    Point and Vector table functions.
 -----------------------------------------------------------------------------*/
@@ -112,7 +270,24 @@ UModel		*GModel;		// Level map Model we're adding to.
 //
 INDEX AddThing( UVectors::Ptr Vectors, FVector &V, FLOAT Thresh, int Check )
 {
-	if( Check )
+	// Use the welding index if this table has one.
+	FWeldIndex *Weld
+	=	GWeldPoints .Table==Vectors ? &GWeldPoints
+	:	GWeldVectors.Table==Vectors ? &GWeldVectors
+	:	NULL;
+	if( Weld && Thresh<=Weld->MaxThresh )
+	{
+		Weld->Sync();
+		INDEX i = Check ? Weld->Find( V, Thresh, 0 ) : INDEX_NONE;
+		if( i == INDEX_NONE )
+		{
+			i = Vectors->Add();
+			Vectors(i) = V;
+			Weld->Add( i );
+		}
+		return i;
+	}
+	else if( Check )
 	{
 		// See if this is very close to an existing point/vector.		
 		for( INDEX i=0; i<Vectors->Num; i++ )
@@ -183,6 +358,31 @@ INDEX FGlobalEditor::bspAddPoint( UModel *Model, FVector *V, int Exact )
 	unguard;
 }
 
+//
+// Keep welding indices for the model's points and vectors until bspWeldEnd,
+// so bspAddPoint and bspAddVector find near-duplicates without scanning the
+// tables. For use around rebuilds which add many points and vectors.
+//
+void FGlobalEditor::bspWeldBegin( UModel *Model )
+{
+	guard(FGlobalEditor::bspWeldBegin);
+	bspWeldEnd();
+	GWeldPoints .Init( Model->Points,  THRESH_POINTS_ARE_NEAR  );
+	GWeldVectors.Init( Model->Vectors, THRESH_VECTORS_ARE_NEAR );
+	unguard;
+}
+
+//
+// Free the welding indices.
+//
+void FGlobalEditor::bspWeldEnd()
+{
+	guard(FGlobalEditor::bspWeldEnd);
+	GWeldPoints .Exit();
+	GWeldVectors.Exit();
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	Adding polygons to the Bsp.
 ----------------------------------------------------------------------------*/
@@ -353,6 +553,162 @@ INDEX FGlobalEditor::bspAddNode
 	Bsp Splitting.
 -----------------------------------------------------------------------------*/
 
+//
+// A pool of polygons being scored as splitters by FindBestSplitFast. The
+// vertices of the polys which are tested against each candidate are kept in
+// structure-of-arrays form, so a candidate's plane is applied to all of them
+// in one straight pass.
+//
+struct FSplitPool
+{
+	FPoly**		PolyList;		// The pool.
+	INT			Balance;		// Balance of the Bsp build.
+	INT			NumSamples;		// Number of polys tested against each candidate.
+	INDEX*		iSamples;		// Index of each tested poly in PolyList.
+	INT*		First;			// Index of each tested poly's first vertex, and the end.
+	INT			NumVerts;		// Number of vertices of all tested polys.
+	FLOAT		*X, *Y, *Z;		// Vertices of all tested polys.
+	INT			NumCandidates;	// Number of candidate splitters.
+	INDEX*		iCandidates;	// Index of each candidate in PolyList.
+	FLOAT*		Scores;			// Score of each candidate, lower is better.
+};
+
+//
+// Score candidate splitter number iTask of an FSplitPool, the same way
+// FindBestSplit does.
+//
+void ScoreSplitTask( void *Arg, INT iTask, INT iThread )
+{
+	guard(ScoreSplitTask);
+	FSplitPool	&Pool	= *(FSplitPool*)Arg;
+	INDEX		iPoly	= Pool.iCandidates[iTask];
+	FPoly		*Poly	= Pool.PolyList[iPoly];
+	FPlane		Plane( Poly->Base, Poly->Normal );
+	FMemMark	Mark(GMem);
+	INT			i, j;
+
+	// Find the distance of every vertex from the plane.
+	FLOAT *Dist = new(GMem,Pool.NumVerts)FLOAT;
+	for( i=0; i<Pool.NumVerts; i++ )
+		Dist[i] = Plane.X*Pool.X[i] + Plane.Y*Pool.Y[i] + Plane.Z*Pool.Z[i] - Plane.W;
+
+	// Classify each tested poly as SplitWithPlaneFast would.
+	INT Splits=0, Front=0, Back=0;
+	for( j=0; j<Pool.NumSamples; j++ ) if( Pool.iSamples[j] != iPoly )
+	{
+		INT IsFront=0, IsBack=0;
+		for( i=Pool.First[j]; i<Pool.First[j+1]; i++ )
+		{
+			IsFront |= Dist[i] > +THRESH_SPLIT_POLY_WITH_PLANE;
+			IsBack  |= Dist[i] < -THRESH_SPLIT_POLY_WITH_PLANE;
+		}
+		if( IsFront && IsBack )
+		{
+			// Disfavor splitting polys that are zone portals.
+			if( !(Poly->PolyFlags & PF_Portal) )
+				Splits++;
+			else
+				Splits += 16;
+		}
+		else
+		{
+			Front += IsFront;
+			Back  += IsBack;
+		}
+	}
+	Pool.Scores[iTask] = Pool.Balance * Abs(Front-Back) + (100-Pool.Balance)*Splits;
+	Mark.Pop();
+	unguard;
+}
+
+//
+// Find the best splitting polygon like FindBestSplit, with the candidates
+// scored on all task threads. Picks exactly the poly FindBestSplit would,
+// the first of the candidates with the lowest score.
+//
+FPoly *FindBestSplitFast
+(
+	int					NumPolys,
+	FPoly				**PolyList,
+	int					Inc,
+	int					AllSemiSolids,
+	int					Balance
+)
+{
+	guard(FindBestSplitFast);
+	FMemMark Mark(GMem);
+	FSplitPool Pool;
+	INT i, j, k;
+
+	// Gather the polys which are tested against each candidate.
+	Pool.PolyList	= PolyList;
+	Pool.Balance	= Balance;
+	Pool.NumSamples	= 0;
+	Pool.NumVerts	= 0;
+	Pool.iSamples	= new(GMem,NumPolys/Inc+1)INDEX;
+	Pool.First		= new(GMem,NumPolys/Inc+2)INT;
+	for( j=0; j<NumPolys; j+=Inc )
+	{
+		Pool.iSamples[Pool.NumSamples++] = j;
+		Pool.NumVerts += PolyList[j]->NumVertices;
+	}
+
+	// Lay their vertices out as structure-of-arrays.
+	Pool.X = new(GMem,Pool.NumVerts)FLOAT;
+	Pool.Y = new(GMem,Pool.NumVerts)FLOAT;
+	Pool.Z = new(GMem,Pool.NumVerts)FLOAT;
+	for( j=k=0; j<Pool.NumSamples; j++ )
+	{
+		FPoly *Poly = PolyList[Pool.iSamples[j]];
+		Pool.First[j] = k;
+		for( i=0; i<Poly->NumVertices; i++,k++ )
+		{
+			Pool.X[k] = Poly->Vertex[i].X;
+			Pool.Y[k] = Poly->Vertex[i].Y;
+			Pool.Z[k] = Poly->Vertex[i].Z;
+		}
+	}
+	Pool.First[Pool.NumSamples] = k;
+
+	// Pick one candidate per stride: its first poly which isn't semisolid,
+	// unless all of them are.
+	Pool.NumCandidates	= 0;
+	Pool.iCandidates	= new(GMem,NumPolys/Inc+1)INDEX;
+	Pool.Scores			= new(GMem,NumPolys/Inc+1)FLOAT;
+	for( i=0; i<NumPolys; i+=Inc )
+	{
+		for( j=i; j<i+Inc && j<NumPolys; j++ )
+		{
+			if( AllSemiSolids || !(PolyList[j]->PolyFlags & PF_AddLast) )
+			{
+				Pool.iCandidates[Pool.NumCandidates++] = j;
+				break;
+			}
+		}
+	}
+
+	// Score the candidates, on the task threads if there's enough work.
+	if( Pool.NumCandidates * Pool.NumVerts >= 16384 )
+		GTaskPool.Run( ScoreSplitTask, &Pool, Pool.NumCandidates );
+	else for( i=0; i<Pool.NumCandidates; i++ )
+		ScoreSplitTask( &Pool, i, 0 );
+
+	// Take the first best one.
+	FPoly *Best      = NULL;
+	FLOAT BestScore = 0;
+	for( i=0; i<Pool.NumCandidates; i++ )
+	{
+		if( Pool.Scores[i]<BestScore || !Best )
+		{
+			Best      = PolyList[Pool.iCandidates[i]];
+			BestScore = Pool.Scores[i];
+		}
+	}
+	Mark.Pop();
+	return Best;
+	unguard;
+}
+
 //
 // Find the best splitting polygon within a pool of polygons, and return its
 // index (into the PolyList array).
@@ -387,6 +743,14 @@ FPoly *FindBestSplit
 			break;
 	AllSemiSolids = (i>=NumPolys);
 
+	// Use the parallel search if enabled.
+	if( GUnrealEditor.FastSplit )
+	{
+		Best = FindBestSplitFast( NumPolys, PolyList, Inc, AllSemiSolids, Balance );
+		checkOutput(Best);
+		return Best;
+	}
+
 	// Search through all polygons in the pool and find:
 	// A. The number of splits each poly would make.
 	// B. The number of front and back nodes the polygon would create.
@@ -2411,22 +2775,19 @@ void MergeNearPoints( UModel *Model, FLOAT Dist )
 	INDEX *PointRemap = new(GMem,Model->Points->Num)INDEX;
 	int Merged=0,Collapsed=0;
 
-	// Find nearer point for all points.
+	// Find the first earlier point near each point.
+	FWeldIndex Weld;
+	Weld.Init( Model->Points, Dist );
 	for( INDEX i=0; i<Model->Points->Num; i++ )
 	{
-		PointRemap[i] = i;
-		FVector &Point = Model->Points(i);
-		for( INDEX j=0; j<i; j++ )
-		{
-			FVector &TestPoint = Model->Points(j);
-			if( (TestPoint - Point).SizeSquared() < Dist*Dist )
-			{
-				PointRemap[i] = j;
-				Merged++;
-				break;
-			}
-		}
+		PointRemap[i] = Weld.Find( Model->Points(i), Dist, 1 );
+		if( PointRemap[i] != INDEX_NONE )
+			Merged++;
+		else
+			PointRemap[i] = i;
+		Weld.Add( i );
 	}
+	Weld.Exit();
 
 	// Remap VertPool.
 	for( i=0; i<Model->Verts->Num; i++ )
@@ -2730,6 +3091,12 @@ void FGlobalEditor::bspRefresh( UModel *Model, int NoRemapSurfs )
 	debugf( LOG_Info, "Vectors: %i -> %i", Model->Vectors->Num, n );
 	Model->Vectors->Num = n;
 
+	// Points and vectors have moved, so reindex them.
+	if( GWeldPoints.Table==Model->Points )
+		GWeldPoints.Reset();
+	if( GWeldVectors.Table==Model->Vectors )
+		GWeldVectors.Reset();
+
 	// Update Bsp surfs.
 	for( i=0; i<Model->Surfs->Num; i++ )
 	{
@@ -170,12 +170,128 @@ void FGlobalEditor::csgInvalidateBsp(ULevel *Level)
 	CSG Rebuilding
 -----------------------------------------------------------------------------*/
 
+//
+// What csgRebuild applied for one brush, to tell which brushes have changed
+// since the last rebuild.
+//
+struct FCsgRecord
+{
+	UModel			*Brush;		// The brush.
+	DWORD			Hash;		// Hash of everything the brush's CSG depends on.
+	FBoundingBox	Bound;		// World bounds of the brush.
+};
+
+//
+// Incremental rebuild state. The CSG of a brush commutes with that of any
+// later brush it doesn't touch, so a brush which no later brush overlaps can
+// be applied last. While such a brush is being edited, GCsgBase keeps the Bsp
+// of all the other brushes, and each rebuild copies it back and applies just
+// the edited brush.
+//
+static ULevel*		GCsgLevel		= NULL;	// Level of the last rebuild.
+static FCsgRecord*	GCsgRecords		= NULL;	// Record of each brush in the last rebuild.
+static INT			GCsgNumRecords	= 0;	// Number of brushes in the last rebuild.
+static UModel*		GCsgBase		= NULL;	// Bsp of all brushes except GCsgDeferred.
+static INT			GCsgDeferred	= 0;	// Brush left out of GCsgBase, or 0 if none.
+
+//
+// Hash a block of memory into a running hash.
+//
+static DWORD CsgHash( DWORD Hash, const void *Data, INT Size )
+{
+	const BYTE *Ptr = (const BYTE*)Data;
+	for( INT i=0; i<Size; i++ )
+		Hash = (Hash ^ Ptr[i]) * 16777619;
+	return Hash;
+}
+
+//
+// Record a brush's state for incremental rebuilding.
+//
+static void CsgRecordBrush( FCsgRecord &Record, UModel *Brush )
+{
+	guard(CsgRecordBrush);
+
+	Brush->BuildBound( 1 );
+	Record.Brush = Brush;
+	Record.Bound = Brush->TransformedBound;
+
+	DWORD Hash = 2166136261;
+	Hash = CsgHash( Hash, &Brush->Location,  sizeof(Brush->Location ) );
+	Hash = CsgHash( Hash, &Brush->Rotation,  sizeof(Brush->Rotation ) );
+	Hash = CsgHash( Hash, &Brush->PrePivot,  sizeof(Brush->PrePivot ) );
+	Hash = CsgHash( Hash, &Brush->Scale,     sizeof(Brush->Scale    ) );
+	Hash = CsgHash( Hash, &Brush->PostPivot, sizeof(Brush->PostPivot) );
+	Hash = CsgHash( Hash, &Brush->PostScale, sizeof(Brush->PostScale) );
+	Hash = CsgHash( Hash, &Brush->CsgOper,   sizeof(Brush->CsgOper  ) );
+	Hash = CsgHash( Hash, &Brush->PolyFlags, sizeof(Brush->PolyFlags) );
+
+	Brush->Lock(LOCK_Read);
+	Hash = CsgHash( Hash, &Brush->Polys->Num, sizeof(INT) );
+	for( INDEX i=0; i<Brush->Polys->Num; i++ )
+		Hash = CsgHash( Hash, &Brush->Polys(i), sizeof(FPoly) );
+	Brush->Unlock(LOCK_Read);
+
+	Record.Hash = Hash;
+	unguard;
+}
+
+//
+// See whether a brush's CSG can be applied after that of all later brushes,
+// because it's a plain add or subtract and no later brush comes near it.
+//
+static int CsgCanDefer( FCsgRecord *Records, INT NumRecords, INT iBrush )
+{
+	guard(CsgCanDefer);
+
+	FCsgRecord &Record = Records[iBrush];
+	if( Record.Brush->CsgOper!=CSG_Add && Record.Brush->CsgOper!=CSG_Subtract )
+		return 0;
+	if( !Record.Bound.IsValid )
+		return 0;
+
+	FBoundingBox Bound = Record.Bound.ExpandBy( 1.0 );
+	for( INT i=iBrush+1; i<NumRecords; i++ )
+	{
+		FBoundingBox &Other = Records[i].Bound;
+		if
+		(	Other.IsValid
+		&&	Other.Min.X<Bound.Max.X && Other.Max.X>Bound.Min.X
+		&&	Other.Min.Y<Bound.Max.Y && Other.Max.Y>Bound.Min.Y
+		&&	Other.Min.Z<Bound.Max.Z && Other.Max.Z>Bound.Min.Z )
+			return 0;
+	}
+	return 1;
+	unguard;
+}
+
+//
+// Copy the Bsp built by CSG from one model to another.
+//
+static void CsgCopyBsp( UModel *Dest, UModel *Src )
+{
+	guard(CsgCopyBsp);
+	Dest->Vectors->CopyDataFrom( Src->Vectors );
+	Dest->Points ->CopyDataFrom( Src->Points  );
+	Dest->Nodes  ->CopyDataFrom( Src->Nodes   );
+	Dest->Surfs  ->CopyDataFrom( Src->Surfs   );
+	Dest->Verts  ->CopyDataFrom( Src->Verts   );
+	Dest->Polys  ->CopyDataFrom( Src->Polys   );
+	Dest->Nodes->NumZones       = Src->Nodes->NumZones;
+	Dest->Verts->NumSharedSides = Src->Verts->NumSharedSides;
+	unguard;
+}
+
 //
 // Rebuild the level's Bsp from the level's CSG brushes
 //
 // Note: Needs to be expanded to defragment Bsp polygons as needed (by rebuilding
 // the Bsp), so that it doesn't slow down to a crawl on complex levels.
 //
+// With IncrementalCsg set, a rebuild after editing one brush which no later
+// brush overlaps only reapplies that brush, on top of a saved Bsp of all the
+// others. Anything else falls back to a full rebuild.
+//
 void FGlobalEditor::csgRebuild(ULevel *Level)
 {
 	guard(FGlobalEditor::csgRebuild);
@@ -183,6 +299,7 @@ void FGlobalEditor::csgRebuild(ULevel *Level)
 	UModel				*Brush;
 	int 				NodeCount,PolyCount,LastPolyCount;
 	char				TempStr [80];
+	int					i;
 
 	int n = Level->BrushArray->Num;
 
@@ -193,46 +310,114 @@ void FGlobalEditor::csgRebuild(ULevel *Level)
 	Level->Model->ModelFlags &= ~MF_InvalidBsp;	// Revalidate the Bsp.
 	MapEdit = 0;							// Turn map editing off.
 
-	// Empty the model out.
-	Level->Lock(LOCK_Trans);
-	Level->Model->EmptyModel(1,1);
-	Level->Unlock(LOCK_Trans);
+	// Record all brushes and find the ones which changed since the last rebuild.
+	FCsgRecord *Records = (FCsgRecord*)appMalloc( Max(n,1) * sizeof(FCsgRecord), "CsgRecords" );
+	int NumChanged=0, iChanged=0;
+	for( i=1; i<n; i++ )
+	{
+		CsgRecordBrush( Records[i], Level->BrushArray->Element(i) );
+		if
+		(	i>=GCsgNumRecords
+		||	Records[i].Brush!=GCsgRecords[i].Brush
+		||	Records[i].Hash !=GCsgRecords[i].Hash )
+		{
+			NumChanged++;
+			iChanged = i;
+		}
+	}
+
+	// See if one brush can be left out of a saved Bsp and applied last.
+	int Deferred = 0;
+	if( IncrementalCsg && Level==GCsgLevel && n==GCsgNumRecords && NumChanged<=1 )
+	{
+		int iBrush = NumChanged ? iChanged : GCsgDeferred;
+		if( iBrush && CsgCanDefer( Records, n, iBrush ) )
+			Deferred = iBrush;
+	}
 
-	LastPolyCount = 0;
-	for( int i=1; i<n; i++ )
+	// Start from the saved Bsp if it's of all brushes except that one.
+	if( Deferred && Deferred==GCsgDeferred )
 	{
-		sprintf(TempStr,"Applying brush %i of %i",i,n);
-		GApp->StatusUpdate(TempStr,i,n);
+		Level->Lock(LOCK_Trans);
+		CsgCopyBsp( Level->Model, GCsgBase );
+		Level->Unlock(LOCK_Trans);
+		bspWeldBegin(Level->Model);
+	}
+	else
+	{
+		// Empty the model out.
+		Level->Lock(LOCK_Trans);
+		Level->Model->EmptyModel(1,1);
+		Level->Unlock(LOCK_Trans);
 
-		// See if the Bsp has become badly fragmented and, if so, rebuild.
-		PolyCount = Level->Model->Surfs->Num;
-		NodeCount = Level->Model->Nodes->Num;
-		if( PolyCount>2000 && PolyCount>=3*LastPolyCount )
+		// Weld points and vectors through a spatial index for the whole rebuild.
+		bspWeldBegin(Level->Model);
+
+		LastPolyCount = 0;
+		for( i=1; i<n; i++ ) if( i!=Deferred )
 		{
-			strcat (TempStr,": Refreshing Bsp...");
-			GApp->StatusUpdate (TempStr,i,n);
+			sprintf(TempStr,"Applying brush %i of %i",i,n);
+			GApp->StatusUpdate(TempStr,i,n);
 
-			debug 				(LOG_Info,"Map: Rebuilding Bsp");
-			bspBuildFPolys		(Level->Model,1);
-			bspMergeCoplanars	(Level->Model,0,0);
-			bspBuild			(Level->Model,BSP_Lame,25,0);
-			debugf				(LOG_Info,"Map: Reduced nodes by %i%%, polys by %i%%",(100*(NodeCount-Level->Model->Nodes->Num))/NodeCount,(100*(PolyCount-Level->Model->Surfs->Num))/PolyCount);
+			// See if the Bsp has become badly fragmented and, if so, rebuild.
+			PolyCount = Level->Model->Surfs->Num;
+			NodeCount = Level->Model->Nodes->Num;
+			if( PolyCount>2000 && PolyCount>=3*LastPolyCount )
+			{
+				strcat (TempStr,": Refreshing Bsp...");
+				GApp->StatusUpdate (TempStr,i,n);
 
-			LastPolyCount = Level->Model->Surfs->Num;
+				debug 				(LOG_Info,"Map: Rebuilding Bsp");
+				bspBuildFPolys		(Level->Model,1);
+				bspMergeCoplanars	(Level->Model,0,0);
+				bspBuild			(Level->Model,BSP_Lame,25,0);
+				debugf				(LOG_Info,"Map: Reduced nodes by %i%%, polys by %i%%",(100*(NodeCount-Level->Model->Nodes->Num))/NodeCount,(100*(PolyCount-Level->Model->Surfs->Num))/PolyCount);
+
+				LastPolyCount = Level->Model->Surfs->Num;
+			}
+
+			// Perform this CSG operation.
+			Brush = Level->BrushArray->Element(i);
+			if( bspBrushCSG( Brush, Level->Model, Brush->PolyFlags, (ECsgOper)Brush->CsgOper, 0 ) > 1 )
+				debugf(" Problem was encountered in brush %i",i);
 		}
 
-		// Perform this CSG operation.
-		Brush = Level->BrushArray->Element(i);
+		// Save the Bsp of all brushes except the deferred one.
+		if( Deferred )
+		{
+			if( !GCsgBase )
+			{
+				GCsgBase = new("CsgBase",CREATE_Unique,RF_NotForClient|RF_NotForServer)UModel( 1, 1 );
+				EditorArray->AddItem(GCsgBase);
+			}
+			CsgCopyBsp( GCsgBase, Level->Model );
+		}
+	}
+
+	// Apply the deferred brush last.
+	if( Deferred )
+	{
+		debugf( LOG_Info, "Map: Incremental rebuild of brush %i", Deferred );
+		Brush = Level->BrushArray->Element(Deferred);
 		if( bspBrushCSG( Brush, Level->Model, Brush->PolyFlags, (ECsgOper)Brush->CsgOper, 0 ) > 1 )
-			debugf(" Problem was encountered in brush %i",i);
+			debugf(" Problem was encountered in brush %i",Deferred);
 	}
 
+	// Remember what was applied for the next rebuild.
+	if( GCsgRecords )
+		appFree( GCsgRecords );
+	GCsgLevel		= Level;
+	GCsgRecords		= Records;
+	GCsgNumRecords	= n;
+	GCsgDeferred	= Deferred;
+
 	// Build bounding volumes.
 	Level->Lock(LOCK_Trans);
 	bspBuildBounds(Level->Model);
 	Level->Unlock(LOCK_Trans);
 
 	// Done.
+	bspWeldEnd();
 	FastRebuild = 0;
 	GApp->EndSlowTask();
 	unguard;
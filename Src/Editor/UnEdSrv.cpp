@@ -502,6 +502,8 @@ int FGlobalEditor::Exec
 	//
 	else if( GetCMD( &Str, "BSP" ) )
 	{
+		if( GetONOFF( Str, "FASTSPLIT=", &FastSplit ) ) // Bsp FASTSPLIT=ON/OFF
+			Processed=1;
 		if( GetCMD( &Str, "REBUILD") ) // Bsp REBUILD [LAME/GOOD/OPTIMAL] [BALANCE=0-100] [LIGHTS] [MAPS] [REJECT]
 		{
 			GTrans->Reset("rebuilding Bsp"); // Not tracked transactionally
@@ -549,12 +551,75 @@ int FGlobalEditor::Exec
 
 			Processed=1;
 		}
+		else if( GetCMD( &Str, "BENCH" ) ) // Bsp BENCH [BALANCE=0-100]
+		{
+			GTrans->Reset("benchmarking Bsp"); // Not tracked transactionally
+			static const char *ModeNames[3] = {"Lame","Good","Optimal"};
+			int SavedFastSplit = FastSplit;
+
+			if( !GetWORD( Str, "BALANCE=", &Word2 ) )
+				Word2=50;
+
+			GApp->BeginSlowTask( "Benchmarking Bsp", 1, 0 );
+
+			// Build the polygons to partition as BSP REBUILD does.
+			bspBuildFPolys( Level->Model, 1 );
+			bspMergeCoplanars( Level->Model, 0, 0 );
+			int NumPolys = Level->Model->Polys->Num;
+			Out->Logf( "Bsp bench: %i polys, balance %i, %i threads", NumPolys, Word2, GTaskPool.NumThreads );
+
+			// Partition a copy of them in each mode, with the plain and the fast splitter search.
+			for( int Mode=BSP_Lame; Mode<=BSP_Optimal; Mode++ )
+			{
+				for( FastSplit=0; FastSplit<=1; FastSplit++ )
+				{
+					GApp->StatusUpdate( "Partitioning", Mode*2+FastSplit, 6 );
+
+					Level->Model->Lock( LOCK_Read );
+					TempModel->Lock( LOCK_ReadWrite );
+					TempModel->EmptyModel( 1, 1 );
+					for( int i=0; i<NumPolys; i++ )
+						TempModel->Polys->AddItem( Level->Model->Polys(i) );
+					TempModel->Unlock( LOCK_ReadWrite );
+					Level->Model->Unlock( LOCK_Read );
+
+					SQWORD Time = GApp->MicrosecondTime();
+					bspBuild( TempModel, (EBspOptimization)Mode, Word2, 1 );
+					Time = GApp->MicrosecondTime() - Time;
+
+					Out->Logf
+					(
+						"  %-7s %s: %9.1f msec, %i nodes, %i surfs, %i split fragments",
+						ModeNames[Mode],
+						FastSplit ? "fast " : "plain",
+						Time/1000.0,
+						TempModel->Nodes->Num,
+						TempModel->Surfs->Num,
+						TempModel->Nodes->Num - NumPolys
+					);
+				}
+			}
+			FastSplit = SavedFastSplit;
+
+			// Clean up.
+			TempModel->EmptyModel( 1, 1 );
+			Level->Lock( LOCK_ReadWrite );
+			Level->Model->Polys->Num = 0;
+			Level->Unlock( LOCK_ReadWrite );
+
+			GApp->EndSlowTask();
+			Processed=1;
+		}
 	}
 	//------------------------------------------------------------------------------------
 	// LIGHT
 	//
 	else if (GetCMD(&Str,"LIGHT"))
 		{
+		if (GetONOFF (Str,"PORTALS=", &PortalLighting)) // Skip light views the portal flood finds empty
+			{
+			Processed=1;
+			};
 		if (GetCMD(&Str,"APPLY")) // LIGHT APPLY [MESH=..] [SELECTED=..] [SMOOTH=..] [RADIOSITY=..]
 			{
 			DWord1 = 0; GetONOFF (Str,"SELECTED=",  &DWord1); // Light selected lights only
@@ -563,6 +628,15 @@ int FGlobalEditor::Exec
 			GCameraManager->RedrawLevel (Level);
 			//
 			Processed=1;
+			}
+		else if (GetCMD(&Str,"BENCH")) // LIGHT BENCH [SELECTED=..]
+			{
+			DWord1 = 0; GetONOFF (Str,"SELECTED=",  &DWord1); // Light selected lights only
+			//
+			shadowIlluminateBsp (Level,DWord1,Out);
+			GCameraManager->RedrawLevel (Level);
+			//
+			Processed=1;
 			};
 		}
 	//------------------------------------------------------------------------------------
@@ -585,6 +659,10 @@ int FGlobalEditor::Exec
 			//
 			Processed=1;
 			};
+		if (GetONOFF (Str,"INCREMENTAL=", &IncrementalCsg)) // Only reapply an edited brush when possible
+			{
+			Processed=1;
+			};
 		//
 		// Commands:
 		//
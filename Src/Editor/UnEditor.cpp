@@ -70,6 +70,9 @@ void FGlobalEditor::Init()
 	ShowVertices	= 0;
 	FastRebuild		= 0;
 	Bootstrapping	= 0;
+	FastSplit		= 1;
+	IncrementalCsg	= 0;
+	PortalLighting	= 1;
 
 	// Constraints.
 	constraintInit (&Constraints);
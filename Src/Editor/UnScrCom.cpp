@@ -5020,6 +5020,10 @@ int FGlobalEditor::MakeScripts( int MakeAll )
 	// Done with make.
 	Skip:
 	Compiler.ExitMake(Success);
+
+	// Cached virtual function lookups refer to the old code.
+	scriptFlushVfCache();
+
 	return Success;
 	unguard;
 }
@@ -5078,6 +5082,10 @@ int FGlobalEditor::CompileScript( UClass *Class, BOOL ObjectPropertiesAreValid,
 		}
 	}
 	Compiler.ExitMake(Success);
+
+	// Cached virtual function lookups refer to the old code.
+	scriptFlushVfCache();
+
 	return Success;
 	unguard;
 }
@@ -43,15 +43,23 @@ public:
 	UVectors::Ptr	Vectors;
 	UVectors::Ptr	Points;
 	int				NumLights,PolysLit,ActivePolys,RaysTraced,Pairs,Oversample;
+	INT*			MeshLights;		// Number of the last light added to each light mesh.
+	INT*			SurfLights;		// Number of the last light whose flood reached each surface.
+	INT				iLight;			// Number of the light being added.
 
 	// Functions.
 	void	AllocateLightCamera( ULevel *Level );
 	void	FreeLightCamera();
 	void	SetCameraView( int ViewNum, FVector *Location );
-	void	ComputeLightVisibility( AActor *Actor );
+	void	AddLight( AActor *Actor, INDEX iSurf, INDEX iNode );
+	INT		NodesInView( TTaskBuffer<INDEX> &Nodes );
+	void	ComputeLightVisibility( AActor *Actor, TTaskBuffer<INDEX> *Flooded=NULL );
 	int		ComputeAllLightVisibility(int Selected);
+	void	SetupBspSurf( INDEX iSurf );
+	void	AllocBspSurf( INDEX iSurf );
+	INT		TraceBspSurf( INDEX iSurf );
 	void	LightBspSurf( INDEX iSurf );
-	void	LightAllSurfs();
+	void	LightAllSurfs( FOutputDevice *Bench );
 	void	BuildSurfList( INDEX iNode );
 	void	InitLightMeshIndices();
 };
@@ -105,15 +113,77 @@ void FMeshIlluminator::SetCameraView(int ViewNum,FVector *Location)
 ---------------------------------------------------------------------------------------*/
 
 //
-// Compute per-polygon visibility of one light:
+// Add light number iLight to the surface iSurf seen at node iNode, if the
+// surface is lit by it and doesn't have it yet.
 //
-void FMeshIlluminator::ComputeLightVisibility( AActor *Actor )
+void FMeshIlluminator::AddLight( AActor *Actor, INDEX iSurf, INDEX iNode )
 {
-	guard(FMeshIlluminator::ComputeLightVisibility);
+	guard(FMeshIlluminator::AddLight);
+
+	FBspSurf &Poly = Level->Model->Surfs(iSurf);
+	FBspNode &Node = Level->Model->Nodes(iNode);
+	if( Poly.iLightMesh!=INDEX_NONE && 
+		(Actor->bSpecialLit ? (Poly.PolyFlags&PF_SpecialLit) : !(Poly.PolyFlags&PF_SpecialLit)))
+	{
+		if( Actor->LightRadius==0 || Abs(Node.Plane.PlaneDot(Actor->Location))<= Actor->WorldLightRadius() )
+		{
+			FLightMeshIndex* Index = &LightMesh(Poly.iLightMesh);
+			if( Index->NumStaticLights<Index->MAX_POLY_LIGHTS && MeshLights[Poly.iLightMesh]!=iLight )
+			{
+				Pairs++;
+				MeshLights[Poly.iLightMesh] = iLight;
+				Index->LightActor[Index->NumStaticLights++] = Actor;
+			}
+		}
+	}
+	unguard;
+}
+
+//
+// Return whether any of a list of nodes may be in the light camera's
+// current view. Errs on the side of yes.
+//
+INT FMeshIlluminator::NodesInView( TTaskBuffer<INDEX> &Nodes )
+{
+	guard(FMeshIlluminator::NodesInView);
+
+	UModel	*Model	= Level->Model;
+	FCoords	&Coords	= Camera->Coords;
+	FLOAT	Slope	= 1.01 * Camera->FX2 / Camera->ProjZ;
+	for( INT i=0; i<Nodes.Num; i++ )
+	{
+		// Outcode reject the node against the sides of the view pyramid.
+		FBspNode	&Node		= Model->Nodes(Nodes.Data[i]);
+		FVert		*VertPool	= &Model->Verts(Node.iVertPool);
+		DWORD		OutCode		= 1|2|4|8;
+		for( INT j=0; j<Node.NumVertices; j++ )
+		{
+			FVector	Delta		= Model->Points(VertPool[j].pVertex) - Coords.Origin;
+			FLOAT	X			= Delta | Coords.XAxis;
+			FLOAT	Y			= Delta | Coords.YAxis;
+			FLOAT	Z			= Slope * (Delta | Coords.ZAxis) + 1.0;
+			DWORD	ThisCode	= 0;
+			if( X >  Z ) ThisCode |= 1;
+			if( X < -Z ) ThisCode |= 2;
+			if( Y >  Z ) ThisCode |= 4;
+			if( Y < -Z ) ThisCode |= 8;
+			OutCode &= ThisCode;
+		}
+		if( !OutCode )
+			return 1;
+	}
+	return 0;
+	unguard;
+}
 
-	// Mark this actor as undeletable, so it can't be deleted at playtime, causing a
-	// dangling light pointer.
-	Actor->bNoDelete = 1;
+//
+// Compute per-polygon visibility of one light by rendering from it. If the
+// nodes the portal flood found for the light are given, views holding none
+// of them are skipped, and only surfaces the flood reached are lit.
+//
+void FMeshIlluminator::ComputeLightVisibility( AActor *Actor, TTaskBuffer<INDEX> *Flooded )
+{
+	guard(FMeshIlluminator::ComputeLightVisibility);
 
 	// Render six span occlusion frames looking up/down/n/s/e/w and tag all
 	// visibly polygons:
@@ -123,35 +193,14 @@ void FMeshIlluminator::ComputeLightVisibility( AActor *Actor )
 		FMemMark DynMemMark(GDynMem);
 
 		SetCameraView( i, &Actor->Location );
-		GEdRend->InitTransforms( Level->Model );
-		for( FBspDrawList *DrawList = GEdRend->OccludeBsp(Camera,NULL); DrawList != NULL; DrawList = DrawList->Next )
+		if( !Flooded || NodesInView(*Flooded) )
 		{
-			FBspSurf &Poly = Level->Model->Surfs(DrawList->iSurf);
-			FBspNode &Node = Level->Model->Nodes(DrawList->iNode);
-			if( Poly.iLightMesh!=INDEX_NONE && 
-				(Actor->bSpecialLit ? (Poly.PolyFlags&PF_SpecialLit) : !(Poly.PolyFlags&PF_SpecialLit)))
-			{
-				if( Actor->LightRadius==0 || Abs(Node.Plane.PlaneDot(Actor->Location))<= Actor->WorldLightRadius() )
-				{
-					FLightMeshIndex* Index = &LightMesh(Poly.iLightMesh);
-					if( Index->NumStaticLights < Index->MAX_POLY_LIGHTS )
-					{
-						int Duplicate=0;
-						for( INDEX j=0; j<Index->NumStaticLights; j++ )
-						{
-							if( Index->LightActor[j] == Actor )
-								Duplicate=1;
-						}
-						if( !Duplicate )
-						{
-							Pairs++;
-							Index->LightActor[Index->NumStaticLights++] = Actor;
-						}
-					}
-				}
-			}
+			GEdRend->InitTransforms( Level->Model );
+			for( FBspDrawList *DrawList = GEdRend->OccludeBsp(Camera,NULL); DrawList != NULL; DrawList = DrawList->Next )
+				if( !Flooded || SurfLights[DrawList->iSurf]==iLight )
+					AddLight( Actor, DrawList->iSurf, DrawList->iNode );
+			GEdRend->ExitTransforms();
 		}
-		GEdRend->ExitTransforms();
 		MemMark.Pop();
 		DynMemMark.Pop();
 	}
@@ -162,17 +211,25 @@ void FMeshIlluminator::ComputeLightVisibility( AActor *Actor )
 // Compute visibility between each light in the world and each polygon.
 // Returns number of lights to be applied.
 //
+// With portal lighting on, the surfaces each light may reach are first found
+// for all lights at once by flooding through the Bsp portals. The flood is
+// conservative, so it's only used to skip the views of each light which
+// hold none of those surfaces; the surfaces lit are still the ones the
+// rendered views see, in the same order, so the light meshes come out the
+// same either way. The views can't be dropped altogether: Which surfaces they
+// see depends on span buffer coverage at the views' resolution, which no
+// portal clip or ray test reproduces exactly.
+//
 int FMeshIlluminator::ComputeAllLightVisibility( int Selected )
 {
 	guard(FMeshIlluminator::ComputeAllLightVisibility);
-	int n=0;
+	FMemMark Mark(GMem);
+	AActor** Lights = new(GMem,Level->Num)AActor*;
+	int n=0, Flooded=0;
 	
 	SQWORD Time = GApp->MicrosecondTime();
 	for( int i=0; i<Level->Num; i++ )
 	{
-		if( (i&15)==0 )
-			GApp->StatusUpdate( "Computing visibility", i, Level->Num );
-
 		AActor *Actor = Level(i);
 		if( Actor && Actor->LightType!=LT_None && Actor->bStatic )
 		{
@@ -183,13 +240,45 @@ int FMeshIlluminator::ComputeAllLightVisibility( int Selected )
 			}
 			if( DoLight )
 			{
-				n++;
-				ComputeLightVisibility( Actor );
+				// Mark this actor as undeletable, so it can't be deleted at playtime, causing a
+				// dangling light pointer.
+				Actor->bNoDelete = 1;
+				Lights[n++] = Actor;
 			}
 		}
 	}
+
+	// Flood from all lights through the portals.
+	TTaskBuffer<INDEX>* LightNodes = new(GMem,MEM_Zeroed,n)TTaskBuffer<INDEX>;
+	if( GUnrealEditor.PortalLighting && n )
+	{
+		GApp->StatusUpdate( "Computing visibility", 0, n );
+		GUnrealEditor.LightVisibility( Level, Level->Model, n, Lights, LightNodes );
+	}
+
+	// Add the lights to the surfaces they see, in order.
+	MeshLights = new(GMem,MEM_Zeroed,LightMesh->Num)INT;
+	SurfLights = new(GMem,MEM_Zeroed,Level->Model->Surfs->Max)INT;
+	for( i=0; i<n; i++ )
+	{
+		if( (i&15)==0 )
+			GApp->StatusUpdate( "Computing visibility", i, n );
+
+		iLight = i+1;
+		if( LightNodes[i].Num )
+		{
+			// Only render where the flood reached.
+			for( INT j=0; j<LightNodes[i].Num; j++ )
+				SurfLights[Level->Model->Nodes(LightNodes[i].Data[j]).iSurf] = iLight;
+			ComputeLightVisibility( Lights[i], &LightNodes[i] );
+			Flooded++;
+		}
+		else ComputeLightVisibility( Lights[i] );
+		LightNodes[i].Free();
+	}
 	Time = GApp->MicrosecondTime() - Time;
-	debugf( "Occluded %i views in %f sec (%f msec per light)", n*6, (float)Time/1000000.0, (float)Time/1000.0/n/6 );
+	debugf( "Computed visibility of %i lights (%i flooded first) in %f sec (%f msec per light)", n, Flooded, (float)Time/1000000.0, (float)Time/1000.0/Max(n,1) );
+	Mark.Pop();
 	return n;
 	unguard;
 }
@@ -199,39 +288,16 @@ int FMeshIlluminator::ComputeAllLightVisibility( int Selected )
 ---------------------------------------------------------------------------------------*/
 
 //
-// Apply all lights to one poly, generating its lighting mesh and updating
-// the tables:
+// Size the light mesh of one poly to cover it at the poly's shadow detail.
 //
-void FMeshIlluminator::LightBspSurf( INDEX iSurf )
+void FMeshIlluminator::SetupBspSurf( INDEX iSurf )
 {
-	guard(FMeshIlluminator::LightBspSurf );
-
-	FBspSurf &Surf = Level->Model->Surfs(iSurf);
-	if( Surf.iLightMesh==INDEX_NONE )
-		appError( "Invalid lightmesh" );
+	guard(FMeshIlluminator::SetupBspSurf);
 
+	FBspSurf			&Surf	= Level->Model->Surfs(iSurf);
 	FLightMeshIndex		*Index	= &LightMesh(Surf.iLightMesh);
-	UModel				*Brush	= NULL;
-
-	if( iSurf >= Level->Model->Surfs->Num )
-	{
-		checkState(Surf.Actor!=NULL);
-		Brush = Surf.Actor->Brush;
-		checkState(Brush!=NULL);
-
-#if RAYTRACE_BRUSHES_PROPERLY
-		PBoolean Result(0);
-		Surf.Actor->Process( NAME_RaytraceBrush, &Result);
-		if( !Result.bBoolean )
-		{
-			Surf.iLightMesh = INDEX_NONE;
-			return;
-		}
-#endif
-	}
 
 	FVector		&Base     =  Points  (Surf.pBase);
-	FVector		&Normal   =  Vectors (Surf.vNormal);
 	FVector		TextureU  =  Vectors (Surf.vTextureU);
 	FVector		TextureV  =  Vectors (Surf.vTextureV);
 
@@ -266,6 +332,7 @@ void FMeshIlluminator::LightBspSurf( INDEX iSurf )
 	{
 		// Find extent of moving brush polygon from the original EdPoly that
 		// generated the surface.
+		UModel *Brush = Surf.Actor->Brush;
 		Brush->Lock(LOCK_ReadWrite);
 		for( int i=0; i<Brush->Polys->Num; i++ )
 		{
@@ -334,12 +401,39 @@ void FMeshIlluminator::LightBspSurf( INDEX iSurf )
 		Index->MeshShift++;
 		Index->MeshSpacing *= 2;
 	}
+	unguard;
+}
 
-	// Get some space for this shadow map.
+//
+// Get some space for one poly's shadow maps.
+//
+void FMeshIlluminator::AllocBspSurf( INDEX iSurf )
+{
+	guard(FMeshIlluminator::AllocBspSurf);
+	FLightMeshIndex *Index = &LightMesh(Level->Model->Surfs(iSurf).iLightMesh);
 	Index->DataOffset = LightMesh->Bits->Add
 	(
 		Index->NumStaticLights * ((Index->MeshUSize+7)>>3) * Index->MeshVSize
 	);
+	unguard;
+}
+
+//
+// Raytrace each of one poly's lights into its shadow maps, which must
+// already be sized and allocated. Only reads the Bsp, so polys may be
+// traced concurrently. Returns the number of rays traced.
+//
+INT FMeshIlluminator::TraceBspSurf( INDEX iSurf )
+{
+	guard(FMeshIlluminator::TraceBspSurf);
+
+	FBspSurf			&Surf	= Level->Model->Surfs(iSurf);
+	FLightMeshIndex		*Index	= &LightMesh(Surf.iLightMesh);
+	INT					Rays	= 0;
+
+	FVector		&Normal   =  Vectors (Surf.vNormal);
+	FVector		TextureU  =  Vectors (Surf.vTextureU);
+	FVector		TextureV  =  Vectors (Surf.vTextureV);
 
 	// Calculate new base point by moving polygon's base point forward by 4 units.
 	FVector		NewBase			= Points(Surf.pBase) + Normal * 4.0;
@@ -380,7 +474,7 @@ void FMeshIlluminator::LightBspSurf( INDEX iSurf )
 					//FCheckResult Hit; if( Level->Trace( Hit, Actor, Vertex, *Light, TRACE_All ) )
 						B |= M;
 					M = M << 1;
-					RaysTraced++;
+					Rays++;
 					Vertex += VertexDU;
 				}
 				*Data++ = B;
@@ -388,6 +482,42 @@ void FMeshIlluminator::LightBspSurf( INDEX iSurf )
 			Vertex0 += VertexDV;
 		}
 	}
+	return Rays;
+	unguard;
+}
+
+//
+// Apply all lights to one poly, generating its lighting mesh and updating
+// the tables:
+//
+void FMeshIlluminator::LightBspSurf( INDEX iSurf )
+{
+	guard(FMeshIlluminator::LightBspSurf );
+
+	FBspSurf &Surf = Level->Model->Surfs(iSurf);
+	if( Surf.iLightMesh==INDEX_NONE )
+		appError( "Invalid lightmesh" );
+
+	if( iSurf >= Level->Model->Surfs->Num )
+	{
+		checkState(Surf.Actor!=NULL);
+		checkState(Surf.Actor->Brush!=NULL);
+
+#if RAYTRACE_BRUSHES_PROPERLY
+		PBoolean Result(0);
+		Surf.Actor->Process( NAME_RaytraceBrush, &Result);
+		if( !Result.bBoolean )
+		{
+			Surf.iLightMesh = INDEX_NONE;
+			return;
+		}
+#endif
+	}
+
+	SetupBspSurf( iSurf );
+	AllocBspSurf( iSurf );
+	RaysTraced += TraceBspSurf( iSurf );
+
 #if RAYTRACE_BRUSHES_PROPERLY
 	if( iSurf >= Level->Model->Surfs->Num )
 		Surf.Actor->Process( NAME_RaytraceWorld, NULL );
@@ -395,18 +525,133 @@ void FMeshIlluminator::LightBspSurf( INDEX iSurf )
 	unguard;
 }
 
-void FMeshIlluminator::LightAllSurfs()
+//
+// Surface lighting jobs shared by the task threads. Each worker takes the
+// next surface in the list until there are none left.
+//
+struct FLightSurfPool
+{
+	FMeshIlluminator*	Illum;			// The illuminator.
+	INDEX*				iSurfs;			// Surfaces to light.
+	INT					Num;			// Number of surfaces.
+	INT					Trace;			// 0 to size their meshes, 1 to trace them.
+	INT					Done;			// Surfaces done before these, for status.
+	INT					Total;			// Surfaces to do in all, for status.
+	volatile INT		Next;			// Next surface to take.
+	INT					Rays[FTaskPool::MAX_TASK_THREADS]; // Rays traced by each worker.
+};
+
+//
+// A surface lighting worker. Each worker counts its own rays, and its
+// thread's GMem is its private scratch memory.
+//
+void LightSurfWorker( void *Arg, INT iWorker, INT iThread )
+{
+	guard(LightSurfWorker);
+	FLightSurfPool &Pool = *(FLightSurfPool*)Arg;
+	INT Rays = 0;
+	for( INT i=appInterlockedAdd(&Pool.Next,1); i<Pool.Num; i=appInterlockedAdd(&Pool.Next,1) )
+	{
+		if( Pool.Trace )
+		{
+			// Only the main thread may update the status.
+			if( iThread == 0 )
+				GApp->StatusUpdate( "Raytracing", Pool.Done+i, Pool.Total );
+			Rays += Pool.Illum->TraceBspSurf( Pool.iSurfs[i] );
+		}
+		else Pool.Illum->SetupBspSurf( Pool.iSurfs[i] );
+	}
+	Pool.Rays[iWorker] = Rays;
+	unguard;
+}
+
+//
+// Run one pass of surface lighting jobs on NumWorkers workers.
+// Returns the number of rays traced.
+//
+static INT RunLightSurfs( FLightSurfPool &Pool, INT Trace, INT NumWorkers )
+{
+	guard(RunLightSurfs);
+	Pool.Trace = Trace;
+	Pool.Next  = 0;
+	GTaskPool.Run( LightSurfWorker, &Pool, NumWorkers );
+
+	INT Rays = 0;
+	for( INT i=0; i<NumWorkers; i++ )
+		Rays += Pool.Rays[i];
+	return Rays;
+	unguard;
+}
+
+//
+// Light all surfaces. The static world surfaces are lit in parallel, since
+// the Bsp doesn't change while they're traced: Their meshes are sized on all
+// threads, their shadow maps are allocated in surface order, and then they're
+// traced on all threads, so the results don't depend on the thread count.
+// Moving brush surfaces move their brushes for raytracing, so they're lit
+// one at a time afterwards, as before.
+//
+// If Bench is given, the static surfaces are traced once with each thread
+// count up to the number of task threads, and the speeds are logged to it.
+//
+void FMeshIlluminator::LightAllSurfs( FOutputDevice *Bench )
 {
 	guard(FMeshIlluminator::LightAllSurfs);
+	FMemMark Mark(GMem);
 
 	int n=0,c=0;
 
-	// Count raytraceable surfs.
+	// Count raytraceable surfs, and list the static ones.
+	FLightSurfPool Pool;
+	Pool.Illum  = this;
+	Pool.iSurfs = new(GMem,Level->Model->Surfs->Num)INDEX;
+	Pool.Num    = 0;
 	for( INDEX i=0; i<Level->Model->Surfs->Max; i++ )
-		n += (Level->Model->Surfs(i).iLightMesh != INDEX_NONE);
+	{
+		if( Level->Model->Surfs(i).iLightMesh != INDEX_NONE )
+		{
+			if( i < Level->Model->Surfs->Num )
+				Pool.iSurfs[Pool.Num++] = i;
+			n++;
+		}
+	}
+	Pool.Done  = 0;
+	Pool.Total = n;
+
+	// Size the static surfs' meshes and allocate their shadow maps in order.
+	GApp->StatusUpdate( "Sizing meshes", 0, n );
+	RunLightSurfs( Pool, 0, GTaskPool.NumThreads );
+	for( i=0; i<Pool.Num; i++ )
+		AllocBspSurf( Pool.iSurfs[i] );
+
+	// Raytrace them on all threads, or on each thread count in turn if benchmarking.
+	if( Bench )
+		Bench->Logf( "Light bench: %i surfs, %i lights, %i pairs, %i threads", Pool.Num, NumLights, Pairs, GTaskPool.NumThreads );
+	INT NumWorkers = Bench ? 1 : GTaskPool.NumThreads;
+	for( ;; )
+	{
+		SQWORD Time = GApp->MicrosecondTime();
+		INT    Rays = RunLightSurfs( Pool, 1, NumWorkers );
+		Time        = Max( GApp->MicrosecondTime() - Time, (SQWORD)1 );
+		if( Bench ) Bench->Logf
+		(
+			"  %2i threads: %9.1f msec, %i rays, %.0f rays/sec",
+			NumWorkers,
+			Time/1000.0,
+			Rays,
+			Rays * 1000000.0 / Time
+		);
+		if( NumWorkers == GTaskPool.NumThreads )
+		{
+			RaysTraced += Rays;
+			break;
+		}
+		NumWorkers = Min( NumWorkers*2, GTaskPool.NumThreads );
+	}
+	c = Pool.Num;
 
-	// Raytrace each surf.
-	for( i=0; i<Level->Model->Surfs->Max; i++ )
+	// Raytrace each moving brush surf.
+	for( i=Level->Model->Surfs->Num; i<Level->Model->Surfs->Max; i++ )
 	{
 		if( Level->Model->Surfs(i).iLightMesh != INDEX_NONE )
 		{
@@ -414,6 +659,7 @@ void FMeshIlluminator::LightAllSurfs()
 			LightBspSurf(i);
 		}
 	}
+	Mark.Pop();
 	unguard;
 }
 
@@ -473,7 +719,11 @@ void FMeshIlluminator::InitLightMeshIndices()
    High-level lighting routine
 ---------------------------------------------------------------------------------------*/
 
-void FGlobalEditor::shadowIlluminateBsp(ULevel *Level, int Selected)
+//
+// Rebuild the lighting of a level. If Bench is given, the raytracing speed
+// with each number of threads is logged to it along the way.
+//
+void FGlobalEditor::shadowIlluminateBsp(ULevel *Level, int Selected, FOutputDevice *Bench)
 {
 	guard(FGlobalEditor::shadowIlluminateBsp);
 	FMeshIlluminator Illum;
@@ -548,7 +798,7 @@ void FGlobalEditor::shadowIlluminateBsp(ULevel *Level, int Selected)
 		Illum.NumLights = Illum.ComputeAllLightVisibility(Selected);
 
 		// Apply light to each polygon.
-		Illum.LightAllSurfs();
+		Illum.LightAllSurfs( Bench );
 
 		// Tell all actors that we're done raytracing the world.
 		guard(PostRaytrace);
@@ -708,6 +708,19 @@ SOURCE=.\UnSound.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\UnTask.cpp
+
+!IF  "$(CFG)" == "Engine - Win32 Release"
+
+# ADD CPP /GX /O2
+
+!ELSEIF  "$(CFG)" == "Engine - Win32 Debug"
+
+!ENDIF 
+
+# End Source File
+# Begin Source File
+
 SOURCE=.\UnTex.cpp
 
 !IF  "$(CFG)" == "Engine - Win32 Release"
@@ -28,12 +28,68 @@ INT FCollisionHash::HashZ[NUM_BUCKETS];
 // Global pool of available links.
 static FCollisionHash::FActorLink *GAvailable = NULL;
 
+// Changes deferred by each task thread, and their sequence counter.
+static TTaskBuffer<FCollisionHash::FDeferredLink> GDeferredLinks[FTaskPool::MAX_TASK_THREADS];
+static INT GDeferredSequence = 0;
+
 // Debugging.
 #define HASH_ALL_TO_SAME_BUCKET 0 /* Should be 0 */
 
 // Global statistics.
 static int GActorsAdded=0, GFragsAdded=0, GUsed=0, GChecks=0;
 
+/*-----------------------------------------------------------------------------
+	FCollisionVisit.
+-----------------------------------------------------------------------------*/
+
+//
+// The actors one collision check has already checked. On one thread, actors
+// are marked with a collision tag unique to the check. Task threads would
+// overwrite each other's tags, so while they're running, each check keeps
+// its own list of the actors it has checked instead.
+//
+class FCollisionVisit
+{
+public:
+	// Constructor.
+	FCollisionVisit()
+	:	Tag		( GTaskPool.Running ? 0 : ++FCollisionHash::CollisionTag )
+	,	List	( Local )
+	,	Num		( 0 )
+	,	Max		( ARRAY_COUNT(Local) )
+	{}
+
+	// Mark an actor as checked. Returns 1 if it already was.
+	INT Visit( AActor *Actor )
+	{
+		if( Tag )
+		{
+			if( Actor->CollisionTag == Tag )
+				return 1;
+			Actor->CollisionTag = Tag;
+			return 0;
+		}
+		for( INT i=0; i<Num; i++ )
+			if( List[i] == Actor )
+				return 1;
+		if( Num == Max )
+		{
+			AActor **NewList = new(GMem,Max*2)AActor*;
+			memcpy( NewList, List, Num*sizeof(AActor*) );
+			List = NewList;
+			Max *= 2;
+		}
+		List[Num++] = Actor;
+		return 0;
+	}
+
+private:
+	INT		Tag;
+	AActor	**List;
+	INT		Num, Max;
+	AActor	*Local[64];
+};
+
 /*-----------------------------------------------------------------------------
 	FCollisionHash init/exit.
 -----------------------------------------------------------------------------*/
@@ -69,8 +125,14 @@ void FCollisionHash::Init()
 	for( int i=0; i<NUM_BUCKETS; i++ )
 		Hash[i] = NULL;
 
+	// Init the grid if we're using it instead.
+	UseGrid = GDefaults.CollisionGrid;
+	if( UseGrid )
+		Grid.Init();
+
 	// Note that we're initialized.
 	CollisionInitialized = 1;
+	Deferring            = 0;
 
 	unguard;
 }
@@ -99,6 +161,8 @@ void FCollisionHash::Exit()
 		GAvailable       = GAvailable->Next;
 		delete Link;
 	}
+	if( UseGrid )
+		Grid.Exit();
 	CollisionInitialized = 0;
 	unguard;
 }
@@ -161,12 +225,36 @@ void FCollisionHash::AddActor( AActor *Actor )
 	checkInput(Actor->bCollideActors);
 	if( Actor->bDeleteMe )
 		return;
+	if( Deferring )
+	{
+		// Add it at the sync point.
+		FDeferredLink &Deferred = GDeferredLinks[appTaskThread()].Add();
+		Deferred.Actor     = Actor;
+		Deferred.Sequence  = appInterlockedAdd( &GDeferredSequence, 1 );
+		Deferred.Add       = 1;
+		Actor->ColLocation = Actor->Location;
+		return;
+	}
 	CheckActorNotReferenced( Actor );
 	GActorsAdded++;
 
 	// Add actor in all the specified places.
 	INT X0,Y0,Z0,X1,Y1,Z1;
 	GetActorExtent( Actor, X0, X1, Y0, Y1, Z0, Z1 );
+	if( UseGrid )
+		Grid.AddActor( Actor->GetIndex(), Actor, X0, X1, Y0, Y1, Z0, Z1 );
+	else
+		AddLinks( Actor, X0, X1, Y0, Y1, Z0, Z1 );
+	Actor->ColLocation = Actor->Location;
+	unguard;
+}
+
+//
+// Add links to an actor to the hash buckets in an extent.
+//
+void FCollisionHash::AddLinks( AActor *Actor, INT X0, INT X1, INT Y0, INT Y1, INT Z0, INT Z1 )
+{
+	guard(FCollisionHash::AddLinks);
 	for( INT X=X0; X<=X1; X++ )
 	{
 		for( INT Y=Y0; Y<=Y1; Y++ )
@@ -193,7 +281,6 @@ void FCollisionHash::AddActor( AActor *Actor )
 			}
 		}
 	}
-	Actor->ColLocation = Actor->Location;
 	unguard;
 }
 
@@ -210,10 +297,67 @@ void FCollisionHash::RemoveActor( AActor *Actor )
 	if( !GEditor && Actor->Location!=Actor->ColLocation )
 		appErrorf( "%s %s moved without proper hashing", Actor->GetClassName(), Actor->GetName() );
 
+	// Find where the actor is.
+	INT X0,Y0,Z0,X1,Y1,Z1;
+	GetActorExtent( Actor, X0, X1, Y0, Y1, Z0, Z1 );
+	if( Deferring )
+	{
+		// Remove it from here at the sync point.
+		FDeferredLink &Deferred = GDeferredLinks[appTaskThread()].Add();
+		Deferred.Actor     = Actor;
+		Deferred.Sequence  = appInterlockedAdd( &GDeferredSequence, 1 );
+		Deferred.Add       = 0;
+		Deferred.X0 = X0; Deferred.X1 = X1;
+		Deferred.Y0 = Y0; Deferred.Y1 = Y1;
+		Deferred.Z0 = Z0; Deferred.Z1 = Z1;
+		return;
+	}
+
 	// Remove actor.
+	if( UseGrid )
+		Grid.RemoveActor( Actor->GetIndex() );
+	else
+		RemoveLinks( Actor, X0, X1, Y0, Y1, Z0, Z1 );
+	CheckActorNotReferenced( Actor );
+	unguard;
+}
+
+//
+// Move an actor to a new location and rotation, updating the collision info.
+// With the grid, only the cells the actor entered or left are touched.
+//
+void FCollisionHash::MoveActor( AActor *Actor, FVector NewLocation, FRotation NewRotation )
+{
+	guard(FCollisionHash::MoveActor);
+	checkInput(Actor->bCollideActors);
+	checkState(CollisionInitialized);
+	if( !UseGrid || Deferring || Actor->bDeleteMe )
+	{
+		RemoveActor( Actor );
+		Actor->Location = NewLocation;
+		Actor->Rotation = NewRotation;
+		AddActor( Actor );
+		return;
+	}
+	if( !GEditor && Actor->Location!=Actor->ColLocation )
+		appErrorf( "%s %s moved without proper hashing", Actor->GetClassName(), Actor->GetName() );
+
+	// Update the grid.
 	INT X0,Y0,Z0,X1,Y1,Z1;
-	INT ExpectFrags=0, FoundFrags=0;
+	Actor->Location = NewLocation;
+	Actor->Rotation = NewRotation;
 	GetActorExtent( Actor, X0, X1, Y0, Y1, Z0, Z1 );
+	Grid.MoveActor( Actor->GetIndex(), X0, X1, Y0, Y1, Z0, Z1 );
+	Actor->ColLocation = Actor->Location;
+	unguard;
+}
+
+//
+// Remove all of an actor's links from the hash buckets in an extent.
+//
+void FCollisionHash::RemoveLinks( AActor *Actor, INT X0, INT X1, INT Y0, INT Y1, INT Z0, INT Z1 )
+{
+	guard(FCollisionHash::RemoveLinks);
 	for( INT X=X0; X<=X1; X++ )
 	{
 		for( INT Y=Y0; Y<=Y1; Y++ )
@@ -240,7 +384,333 @@ void FCollisionHash::RemoveActor( AActor *Actor )
 			}
 		}
 	}
-	CheckActorNotReferenced( Actor );
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	FCollisionHash deferred changes.
+-----------------------------------------------------------------------------*/
+
+//
+// Order deferred changes by actor, then by the order they were made in.
+//
+inline int Compare( const FCollisionHash::FDeferredLink &A, const FCollisionHash::FDeferredLink &B )
+{
+	if( A.Actor != B.Actor )
+		return A.Actor->GetIndex() - B.Actor->GetIndex();
+	return A.Sequence - B.Sequence;
+}
+
+//
+// Start deferring adds and removes, so that task threads can move actors
+// while other task threads check collision against the unchanged hash.
+//
+void FCollisionHash::BeginDeferred()
+{
+	guard(FCollisionHash::BeginDeferred);
+	checkState(CollisionInitialized);
+	checkState(!Deferring);
+
+	for( INT i=0; i<FTaskPool::MAX_TASK_THREADS; i++ )
+		GDeferredLinks[i].Empty();
+	Deferring = 1;
+
+	unguard;
+}
+
+//
+// Stop deferring, and bring the hash up to date with all the deferred
+// changes. Only each actor's net change is applied: it's removed from where
+// it was before it first moved, and added where it is now if its last change
+// was an add. Changes are applied in actor order so the resulting bucket
+// lists don't depend on thread timing.
+//
+void FCollisionHash::EndDeferred()
+{
+	guard(FCollisionHash::EndDeferred);
+	checkState(Deferring);
+	Deferring = 0;
+
+	// Gather all threads' changes.
+	FMemMark Mark(GMem);
+	INT i, j, Num=0;
+	for( i=0; i<FTaskPool::MAX_TASK_THREADS; i++ )
+		Num += GDeferredLinks[i].Num;
+	FDeferredLink *Links = new(GMem,Num)FDeferredLink, *Link=Links;
+	for( i=0; i<FTaskPool::MAX_TASK_THREADS; i++ )
+	{
+		for( j=0; j<GDeferredLinks[i].Num; j++ )
+			*Link++ = GDeferredLinks[i].Data[j];
+		GDeferredLinks[i].Empty();
+	}
+	QSort( Links, Num );
+
+	// Apply each actor's net change.
+	for( i=0; i<Num; i=j )
+	{
+		AActor *Actor = Links[i].Actor;
+		for( j=i+1; j<Num && Links[j].Actor==Actor; j++ );
+		if( UseGrid && !Links[i].Add && Links[j-1].Add && !Actor->bDeleteMe )
+		{
+			// The grid remembers where the actor was, so just move it.
+			INT X0,Y0,Z0,X1,Y1,Z1;
+			GetActorExtent( Actor, X0, X1, Y0, Y1, Z0, Z1 );
+			Grid.MoveActor( Actor->GetIndex(), X0, X1, Y0, Y1, Z0, Z1 );
+			Actor->ColLocation = Actor->Location;
+			continue;
+		}
+		if( !Links[i].Add )
+		{
+			if( UseGrid )
+				Grid.RemoveActor( Actor->GetIndex() );
+			else
+				RemoveLinks( Actor, Links[i].X0, Links[i].X1, Links[i].Y0, Links[i].Y1, Links[i].Z0, Links[i].Z1 );
+		}
+		if( Links[j-1].Add )
+			AddActor( Actor );
+	}
+	Mark.Pop();
+
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	FCollisionGrid.
+-----------------------------------------------------------------------------*/
+
+//
+// Initialize an empty grid.
+//
+void FCollisionGrid::Init()
+{
+	guard(FCollisionGrid::Init);
+
+	Cells     = NULL;
+	MaxCells  = 0;
+	Actors    = NULL;
+	MaxActors = 0;
+	Resize( MIN_CELLS );
+
+	unguard;
+}
+
+//
+// Free the grid.
+//
+void FCollisionGrid::Exit()
+{
+	guard(FCollisionGrid::Exit);
+
+	for( INT i=0; i<MaxCells; i++ )
+		if( Cells[i].More )
+			appFree( Cells[i].More );
+	appFree( Cells );
+	if( Actors )
+		appFree( Actors );
+	Cells  = NULL;
+	Actors = NULL;
+
+	unguard;
+}
+
+//
+// Rebuild the cell table with a new size, dropping cells which have emptied.
+//
+void FCollisionGrid::Resize( INT NewMaxCells )
+{
+	guard(FCollisionGrid::Resize);
+
+	FCell *OldCells    = Cells;
+	INT   OldMaxCells  = MaxCells;
+	Cells     = (FCell*)appMalloc( NewMaxCells * sizeof(FCell), "GridCells" );
+	MaxCells  = NewMaxCells;
+	NumCells  = 0;
+	for( HashShift=32; NewMaxCells>1; NewMaxCells>>=1 )
+		HashShift--;
+	for( INT i=0; i<MaxCells; i++ )
+	{
+		Cells[i].Key  = EMPTY_KEY;
+		Cells[i].Num  = Cells[i].Max = 0;
+		Cells[i].More = NULL;
+	}
+
+	// Move the occupied cells over.
+	for( i=0; i<OldMaxCells; i++ )
+	{
+		FCell &Old = OldCells[i];
+		if( Old.Num )
+		{
+			for( INT j=GetSlot(Old.Key); Cells[j].Key!=EMPTY_KEY; j=(j+1)&(MaxCells-1) );
+			Cells[j] = Old;
+			NumCells++;
+		}
+		else if( Old.More )
+		{
+			appFree( Old.More );
+		}
+	}
+	if( OldCells )
+		appFree( OldCells );
+
+	unguard;
+}
+
+//
+// Find a cell, creating it if it doesn't exist.
+//
+FCollisionGrid::FCell &FCollisionGrid::GetCell( INT X, INT Y, INT Z )
+{
+	guardSlow(FCollisionGrid::GetCell);
+	DWORD Key = GetKey( X, Y, Z );
+	for( INT i=GetSlot(Key); Cells[i].Key!=EMPTY_KEY; i=(i+1)&(MaxCells-1) )
+		if( Cells[i].Key == Key )
+			return Cells[i];
+
+	// Keep the table at most half full, so probe chains stay short.
+	if( 2*(NumCells+1) > MaxCells )
+	{
+		INT Occupied=0;
+		for( INT j=0; j<MaxCells; j++ )
+			if( Cells[j].Num )
+				Occupied++;
+		INT NewMaxCells = MIN_CELLS;
+		while( NewMaxCells < 4*(Occupied+1) )
+			NewMaxCells *= 2;
+		Resize( NewMaxCells );
+		for( i=GetSlot(Key); Cells[i].Key!=EMPTY_KEY; i=(i+1)&(MaxCells-1) );
+	}
+	Cells[i].Key = Key;
+	NumCells++;
+	return Cells[i];
+	unguardSlow;
+}
+
+//
+// Add an actor index to a cell.
+//
+void FCollisionGrid::AddToCell( FCell &Cell, INT iActor )
+{
+	guardSlow(FCollisionGrid::AddToCell);
+	if( Cell.Num < CELL_INLINE )
+	{
+		Cell.Inline[Cell.Num++] = iActor;
+		return;
+	}
+	if( Cell.Num-CELL_INLINE == Cell.Max )
+	{
+		checkState(Cell.Max<MAXWORD/2);
+		Cell.Max  = Cell.Max ? Cell.Max*2 : 8;
+		Cell.More = (INT*)appRealloc( Cell.More, Cell.Max*sizeof(INT), "GridCell" );
+	}
+	Cell.More[Cell.Num++ - CELL_INLINE] = iActor;
+	unguardSlow;
+}
+
+//
+// Remove an actor index from a cell, moving the cell's last actor into its place.
+//
+void FCollisionGrid::RemoveFromCell( FCell &Cell, INT iActor )
+{
+	guardSlow(FCollisionGrid::RemoveFromCell);
+	INT Last = Cell.Get( Cell.Num-1 );
+	for( INT i=0; i<Cell.Num; i++ )
+	{
+		if( Cell.Get(i) == iActor )
+		{
+			if( i<CELL_INLINE ) Cell.Inline[i]             = Last;
+			else                Cell.More[i-CELL_INLINE]   = Last;
+			Cell.Num--;
+			return;
+		}
+	}
+	appErrorf( "Actor %i missing from collision grid cell", iActor );
+	unguardSlow;
+}
+
+//
+// Add an actor to all cells in a range.
+//
+void FCollisionGrid::AddActor( INT iActor, AActor *Actor, INT X0, INT X1, INT Y0, INT Y1, INT Z0, INT Z1 )
+{
+	guard(FCollisionGrid::AddActor);
+
+	// Make room in the actor table.
+	if( iActor >= MaxActors )
+	{
+		INT NewMaxActors = ::Max( iActor+1, MaxActors*2 );
+		Actors = (FGridActor*)appRealloc( Actors, NewMaxActors*sizeof(FGridActor), "GridActors" );
+		memset( Actors+MaxActors, 0, (NewMaxActors-MaxActors)*sizeof(FGridActor) );
+		MaxActors = NewMaxActors;
+	}
+
+	// Remember where it is.
+	FGridActor &Info = Actors[iActor];
+	checkState(Info.Actor==NULL);
+	Info.Actor = Actor;
+	Info.X0 = X0; Info.X1 = X1;
+	Info.Y0 = Y0; Info.Y1 = Y1;
+	Info.Z0 = Z0; Info.Z1 = Z1;
+
+	// Add it.
+	for( INT X=X0; X<=X1; X++ )
+		for( INT Y=Y0; Y<=Y1; Y++ )
+			for( INT Z=Z0; Z<=Z1; Z++ )
+				AddToCell( GetCell(X,Y,Z), iActor );
+
+	unguard;
+}
+
+//
+// Remove an actor from all cells it occupies.
+//
+void FCollisionGrid::RemoveActor( INT iActor )
+{
+	guard(FCollisionGrid::RemoveActor);
+	checkState(Contains(iActor));
+
+	FGridActor &Info = Actors[iActor];
+	for( INT X=Info.X0; X<=Info.X1; X++ )
+		for( INT Y=Info.Y0; Y<=Info.Y1; Y++ )
+			for( INT Z=Info.Z0; Z<=Info.Z1; Z++ )
+				RemoveFromCell( GetCell(X,Y,Z), iActor );
+	Info.Actor = NULL;
+
+	unguard;
+}
+
+//
+// Move an actor to a new range of cells, only touching the cells it left
+// or entered.
+//
+void FCollisionGrid::MoveActor( INT iActor, INT X0, INT X1, INT Y0, INT Y1, INT Z0, INT Z1 )
+{
+	guard(FCollisionGrid::MoveActor);
+	checkState(Contains(iActor));
+
+	// Most moves stay within the same cells.
+	FGridActor &Info = Actors[iActor];
+	if( X0==Info.X0 && X1==Info.X1 && Y0==Info.Y0 && Y1==Info.Y1 && Z0==Info.Z0 && Z1==Info.Z1 )
+		return;
+
+	// Leave the cells outside the new range.
+	INT X,Y,Z;
+	for( X=Info.X0; X<=Info.X1; X++ )
+		for( Y=Info.Y0; Y<=Info.Y1; Y++ )
+			for( Z=Info.Z0; Z<=Info.Z1; Z++ )
+				if( X<X0 || X>X1 || Y<Y0 || Y>Y1 || Z<Z0 || Z>Z1 )
+					RemoveFromCell( GetCell(X,Y,Z), iActor );
+
+	// Enter the cells outside the old range.
+	for( X=X0; X<=X1; X++ )
+		for( Y=Y0; Y<=Y1; Y++ )
+			for( Z=Z0; Z<=Z1; Z++ )
+				if( X<Info.X0 || X>Info.X1 || Y<Info.Y0 || Y>Info.Y1 || Z<Info.Z0 || Z>Info.Z1 )
+					AddToCell( GetCell(X,Y,Z), iActor );
+
+	Info.X0 = X0; Info.X1 = X1;
+	Info.Y0 = Y0; Info.Y1 = Y1;
+	Info.Z0 = Z0; Info.Z1 = Z1;
+
 	unguard;
 }
 
@@ -248,6 +718,50 @@ void FCollisionHash::RemoveActor( AActor *Actor )
 	FCollisionHash collision checking.
 -----------------------------------------------------------------------------*/
 
+//
+// Iterates through the actors in one collision cell, whether the hash
+// is using its buckets or the grid. Bucket lists may also contain actors
+// from other cells which happen to hash to the same bucket.
+//
+class FCollisionCellIterator
+{
+public:
+	// Constructor.
+	FCollisionCellIterator( FCollisionHash &Hash, INT X, INT Y, INT Z )
+	:	Grid	( Hash.UseGrid ? &Hash.Grid : NULL )
+	,	Cell	( NULL )
+	,	Link	( NULL )
+	,	Index	( 0 )
+	{
+		INT iLocation;
+		if( Grid )
+			Cell = Grid->FindCell( X, Y, Z );
+		else
+			Link = Hash.GetHashLink( X, Y, Z, iLocation );
+	}
+
+	// Iterator interface.
+	operator BOOL()
+	{
+		return Grid ? (Cell && Index<Cell->Num) : (Link!=NULL);
+	}
+	void operator++()
+	{
+		if( Grid ) Index++;
+		else       Link = Link->Next;
+	}
+	AActor* operator()()
+	{
+		return Grid ? Grid->GetActor( Cell->Get(Index) ) : Link->Actor;
+	}
+
+private:
+	FCollisionGrid*					Grid;
+	const FCollisionGrid::FCell*	Cell;
+	FCollisionHash::FActorLink*		Link;
+	INT								Index;
+};
+
 //
 // Make a list of all actors which overlap with a cyllinder at Location
 // with the given collision size.
@@ -270,7 +784,7 @@ FCheckResult* FCollisionHash::PointCheck
 	GetHashIndices( Location - Extent, X0, Y0, Z0 );
 	GetHashIndices( Location + Extent, X1, Y1, Z1 );
 	FCheckResult *Result, **PrevLink = &Result;
-	CollisionTag++;
+	FCollisionVisit Visit;
 
 	// Check with level.
 	if( Level )
@@ -291,19 +805,18 @@ FCheckResult* FCollisionHash::PointCheck
 	{
 		for( INT X=X0; X<=X1; X++ ) for( INT Y=Y0; Y<=Y1; Y++ ) for( INT Z=Z0; Z<=Z1; Z++ )
 		{
-			INT iLocation;
-			for( FActorLink *Link = GetHashLink( X, Y, Z, iLocation ); Link; Link=Link->Next )
+			for( FCollisionCellIterator It(*this,X,Y,Z); It; ++It )
 			{
 				// Skip if we've already checked this actor.
-				if( Link->Actor->CollisionTag == CollisionTag )
+				AActor *Actor = It();
+				if( Visit.Visit(Actor) )
 					continue;
-				Link->Actor->CollisionTag = CollisionTag;
 
 				// Collision test.
 				FCheckResult TestHit(1.0);
-				if( Link->Actor->GetPrimitive()->PointCheck( TestHit, Link->Actor, Location, Extent, 0 )==0 )
+				if( Actor->GetPrimitive()->PointCheck( TestHit, Actor, Location, Extent, 0 )==0 )
 				{
-					checkState(TestHit.Actor==Link->Actor);
+					checkState(TestHit.Actor==Actor);
 					*PrevLink  = new(GMem)FCheckResult;
 					**PrevLink = TestHit;
 					PrevLink   = &(*PrevLink)->GetNext();
@@ -340,27 +853,26 @@ FCheckResult* FCollisionHash::EncroachmentCheck
 	INT X0,Y0,Z0,X1,Y1,Z1;
 	GetActorExtent( Actor, X0, X1, Y0, Y1, Z0, Z1 );
 	FCheckResult *Result, **PrevLink = &Result;
-	CollisionTag++;
+	FCollisionVisit Visit;
 
 	// Check all actors in this neighborhood.
 	for( INT X=X0; X<=X1; X++ ) for( INT Y=Y0; Y<=Y1; Y++ ) for( INT Z=Z0; Z<=Z1; Z++ )
 	{
-		INT iLocation;
-		for( FActorLink *Link = GetHashLink( X, Y, Z, iLocation ); Link; Link=Link->Next )
+		for( FCollisionCellIterator It(*this,X,Y,Z); It; ++It )
 		{
 			// Skip if we've already checked this actor.
-			if( Link->Actor->CollisionTag == CollisionTag )
+			AActor *Other = It();
+			if( Visit.Visit(Other) )
 				continue;
-			Link->Actor->CollisionTag = CollisionTag;
 
 			// Collision test.
 			FCheckResult TestHit(1.0);
 			if
-			(	!Link->Actor->Brush
-			&&	Link->Actor!=Actor
-			&&	Actor->GetPrimitive()->PointCheck( TestHit, Actor, Link->Actor->Location, Link->Actor->GetCollisionExtent(), 0 )==0 )
+			(	!Other->Brush
+			&&	Other!=Actor
+			&&	Actor->GetPrimitive()->PointCheck( TestHit, Actor, Other->Location, Other->GetCollisionExtent(), 0 )==0 )
 			{
-				TestHit.Actor     = Link->Actor;
+				TestHit.Actor     = Other;
 				TestHit.Primitive = NULL;
 				*PrevLink         = new(GMem)FCheckResult;
 				**PrevLink        = TestHit;
@@ -438,26 +950,114 @@ FCheckResult* FCollisionHash::LineCheck
 	guard(FCollisionHash::LineCheck);
 	checkState(CollisionInitialized);
 
-	// Update collision tag.
-	CollisionTag++;
+	// Check for collision with the level.
+	FCheckResult LevelHit(1.0);
+	if( LevelInfo && LevelInfo->XLevel->Model->LineCheck( LevelHit, NULL, Start, End, Size, 0 )==0 )
+	{
+		LevelHit.Actor = LevelInfo;
+		return LineCheckActors( Mem, Start, End, Size, &LevelHit );
+	}
+	return LineCheckActors( Mem, Start, End, Size, NULL );
+	unguard;
+}
+
+//
+// Perform a number of line checks as LineCheck does, returning an array of
+// the time-sorted hit lists of all of the rays, allocated in Mem. Each ray's
+// Hit and Clear are set to the result of its check against the level, or to
+// unblocked if there is no level. Actors are only checked if bCheckActors.
+//
+// The rays are checked against the level all at once, which is much faster
+// than one at a time when there are many coherent rays, such as when
+// checking the visibility of many points from one place.
+//
+FCheckResult** FCollisionHash::LineCheckBatch
+(
+	FMemStack		&Mem,
+	FLineCheckRay	*Rays,
+	INT				NumRays,
+	BOOL			bCheckActors,
+	ALevelInfo*		LevelInfo
+)
+{
+	guard(FCollisionHash::LineCheckBatch);
+	checkState(CollisionInitialized);
+
+	// Check for collision with the level.
+	INT i;
+	if( LevelInfo )
+	{
+		LevelInfo->XLevel->Model->LineCheckBatch( Rays, NumRays, 0 );
+	}
+	else for( i=0; i<NumRays; i++ )
+	{
+		Rays[i].Hit   = FCheckResult(1.0);
+		Rays[i].Clear = 1;
+	}
+
+	// Check for collision with actors.
+	FCheckResult **Results = new(Mem,NumRays)FCheckResult*;
+	for( i=0; i<NumRays; i++ )
+	{
+		FLineCheckRay &Ray = Rays[i];
+		FCheckResult  *LevelHit = NULL;
+		if( !Ray.Clear )
+		{
+			LevelHit        = new(Mem)FCheckResult;
+			*LevelHit       = Ray.Hit;
+			LevelHit->Actor = LevelInfo;
+		}
+		if( bCheckActors )
+		{
+			Results[i] = LineCheckActors( Mem, Ray.Start, Ray.End, Ray.Extent, LevelHit );
+		}
+		else
+		{
+			if( LevelHit )
+				LevelHit->GetNext() = NULL;
+			Results[i] = LevelHit;
+		}
+	}
+	return Results;
+	unguard;
+}
+
+//
+// Make a time-sorted list of all actors which overlap a cyllinder moving
+// along a line from Start to End, including LevelHit if the line hit the level,
+// in which case the line is culled at that hit.
+//
+FCheckResult* FCollisionHash::LineCheckActors
+(
+	FMemStack		&Mem,
+	FVector			Start,
+	FVector			End,
+	FVector			Size,
+	FCheckResult*	LevelHit
+)
+{
+	guard(FCollisionHash::LineCheckActors);
+
+	// Track the actors checked.
+	FCollisionVisit Visit;
 
-	// Get extent.
-	INT X0,Y0,Z0,X1,Y1,Z1;
-	FBoundingBox Box( FBoundingBox(0) + Start + End );
-	GetHashIndices( Box.Min - Size, X0, Y0, Z0 );
-	GetHashIndices( Box.Max + Size, X1, Y1, Z1 );
-	
 	// Init hits.
 	INT NumHits=0;
 	FCheckResult Hits[64];
 
-	// Check for collision with the level, and cull the end point.
-	if( LevelInfo && LevelInfo->XLevel->Model->LineCheck( Hits[NumHits], NULL, Start, End, Size, 0 )==0 )
+	// Include the level hit, and cull the end point.
+	if( LevelHit )
 	{
-		Hits[NumHits].Actor = LevelInfo;
+		Hits[NumHits] = *LevelHit;
 		End = Start + (End-Start) * Hits[NumHits++].Time;
 	}
 
+	// Get extent.
+	INT X0,Y0,Z0,X1,Y1,Z1;
+	FBoundingBox Box( FBoundingBox(0) + Start + End );
+	GetHashIndices( Box.Min - Size, X0, Y0, Z0 );
+	GetHashIndices( Box.Max + Size, X1, Y1, Z1 );
+
 	// Check all potentially colliding actors in the hash.
 	for( INT X=X0; X<=X1; X++ )
 	{
@@ -465,17 +1065,16 @@ FCheckResult* FCollisionHash::LineCheck
 		{
 			for( INT Z=Z0; Z<=Z1; Z++ )
 			{
-				INT iLocation;
-				for( FActorLink *Link = GetHashLink( X, Y, Z, iLocation ); Link; Link=Link->Next )
+				for( FCollisionCellIterator It(*this,X,Y,Z); It; ++It )
 				{
 					// Skip if we've already checked this actor.
-					if( Link->Actor->CollisionTag == CollisionTag )
+					AActor *Actor = It();
+					if( Visit.Visit(Actor) )
 						continue;
-					Link->Actor->CollisionTag = CollisionTag;
 
 					// Check collision.
 					Hits[NumHits].Actor = NULL;
-					if( Link->Actor->GetPrimitive()->LineCheck( Hits[NumHits], Link->Actor, Start, End, Size, 0 )==0 )
+					if( Actor->GetPrimitive()->LineCheck( Hits[NumHits], Actor, Start, End, Size, 0 )==0 )
 					{
 						checkState(Hits[NumHits].Actor!=NULL);
 						if( ++NumHits >= ARRAY_COUNT(Hits) )
@@ -503,6 +1102,126 @@ FCheckResult* FCollisionHash::LineCheck
 	unguard;
 }
 
+/*-----------------------------------------------------------------------------
+	FCollisionHash benchmark.
+-----------------------------------------------------------------------------*/
+
+//
+// A stand-in for an actor in the benchmark.
+//
+struct FBenchActor
+{
+	FVector	Location;
+	INT		X0,X1,Y0,Y1,Z0,Z1;
+};
+
+//
+// Compute a benchmark actor's extent in hash coordinates, as for a pawn.
+//
+static void GetBenchExtent( FCollisionHash &Hash, FBenchActor &Actor )
+{
+	FVector Extent(32,32,48);
+	Hash.GetHashIndices( Actor.Location - Extent, Actor.X0, Actor.Y0, Actor.Z0 );
+	Hash.GetHashIndices( Actor.Location + Extent, Actor.X1, Actor.Y1, Actor.Z1 );
+}
+
+//
+// Move a number of actors around at running speed, both with the hash buckets
+// and with the grid, and report the time spent updating the collision info
+// and gathering each actor's neighbors. No real actors are involved, so this
+// runs without a level.
+//
+void FCollisionHash::Bench( INT NumActors, INT Ticks, FOutputDevice *Out )
+{
+	guard(FCollisionHash::Bench);
+
+	FBenchActor *Actors = (FBenchActor*)appMalloc( NumActors*sizeof(FBenchActor), "HashBench" );
+	FCollisionHash *Hash = (FCollisionHash*)appMalloc( sizeof(FCollisionHash), "HashBench" );
+	FCollisionHash::FActorLink *SavedAvailable = GAvailable;
+	DWORD MoveTime[2], QueryTime[2];
+	INT   Candidates[2];
+
+	for( INT iMode=0; iMode<2; iMode++ )
+	{
+		// Scatter the actors over a large level, the same way for both.
+		memset( Hash, 0, sizeof(FCollisionHash) );
+		Hash->Init();
+		if( Hash->UseGrid != iMode )
+		{
+			if( iMode ) Hash->Grid.Init();
+			else        Hash->Grid.Exit();
+			Hash->UseGrid = iMode;
+		}
+		srand( 0x4321 );
+		for( INT i=0; i<NumActors; i++ )
+		{
+			Actors[i].Location = FVector( 32768.0*(frand()-0.5), 32768.0*(frand()-0.5), 4096.0*(frand()-0.5) );
+			GetBenchExtent( *Hash, Actors[i] );
+			if( iMode ) Hash->Grid.AddActor( i, (AActor*)&Actors[i], Actors[i].X0, Actors[i].X1, Actors[i].Y0, Actors[i].Y1, Actors[i].Z0, Actors[i].Z1 );
+			else       Hash->AddLinks     ( (AActor*)&Actors[i], Actors[i].X0, Actors[i].X1, Actors[i].Y0, Actors[i].Y1, Actors[i].Z0, Actors[i].Z1 );
+		}
+
+		// Tick.
+		MoveTime[iMode] = QueryTime[iMode] = 0;
+		Candidates[iMode] = 0;
+		for( INT Tick=0; Tick<Ticks; Tick++ )
+		{
+			// Move every actor up to 20 units, as a running pawn does in one tick.
+			clock(MoveTime[iMode]);
+			for( i=0; i<NumActors; i++ )
+			{
+				FBenchActor &Actor = Actors[i];
+				INT X0=Actor.X0, X1=Actor.X1, Y0=Actor.Y0, Y1=Actor.Y1, Z0=Actor.Z0, Z1=Actor.Z1;
+				Actor.Location += FVector( 40.0*(frand()-0.5), 40.0*(frand()-0.5), 10.0*(frand()-0.5) );
+				GetBenchExtent( *Hash, Actor );
+				if( iMode )
+				{
+					Hash->Grid.MoveActor( i, Actor.X0, Actor.X1, Actor.Y0, Actor.Y1, Actor.Z0, Actor.Z1 );
+				}
+				else
+				{
+					Hash->RemoveLinks( (AActor*)&Actor, X0, X1, Y0, Y1, Z0, Z1 );
+					Hash->AddLinks   ( (AActor*)&Actor, Actor.X0, Actor.X1, Actor.Y0, Actor.Y1, Actor.Z0, Actor.Z1 );
+				}
+			}
+			unclock(MoveTime[iMode]);
+
+			// Gather the candidates each actor would check collision against.
+			clock(QueryTime[iMode]);
+			for( i=0; i<NumActors; i++ )
+			{
+				FBenchActor &Actor = Actors[i];
+				for( INT X=Actor.X0; X<=Actor.X1; X++ ) for( INT Y=Actor.Y0; Y<=Actor.Y1; Y++ ) for( INT Z=Actor.Z0; Z<=Actor.Z1; Z++ )
+					for( FCollisionCellIterator It(*Hash,X,Y,Z); It; ++It )
+						Candidates[iMode]++;
+			}
+			unclock(QueryTime[iMode]);
+		}
+
+		// Clean up.
+		Hash->Exit();
+	}
+	GAvailable = SavedAvailable;
+	appFree( Hash );
+	appFree( Actors );
+
+	// Report.
+	Ticks = Max(Ticks,1);
+	Out->Logf
+	(
+		"Collision bench: %i actors, %i ticks: Hash move=%.3f query=%.3f msec/tick (%i candidates), Grid move=%.3f query=%.3f msec/tick (%i candidates)",
+		NumActors,
+		Ticks,
+		GApp->CpuToMilliseconds(MoveTime [0]) / Ticks,
+		GApp->CpuToMilliseconds(QueryTime[0]) / Ticks,
+		Candidates[0] / Ticks,
+		GApp->CpuToMilliseconds(MoveTime [1]) / Ticks,
+		GApp->CpuToMilliseconds(QueryTime[1]) / Ticks,
+		Candidates[1] / Ticks
+	);
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
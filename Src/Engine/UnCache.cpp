@@ -15,6 +15,9 @@ Revision history:
 
 #include "Unreal.h"
 
+// Cache whose operations are being recorded, if any.
+FMemCache *FMemCache::Recorder = NULL;
+
 /*-----------------------------------------------------------------------------
 	Init & Exit.
 -----------------------------------------------------------------------------*/
@@ -37,6 +40,16 @@ void FMemCache::Init
 	MemTotal   = BytesToAllocate;
 	ItemsTotal = MaxItems;
 
+	// Init time, stats and trace.
+	Time       = 0;
+	NumGets    = NumCreates = CreateTime = 0;
+	ItemsFresh = ItemsStale = MemFresh = MemStale = 0;
+	ItemsUsed  = ItemsNow = ItemsLast = 0;
+	MemUsed    = MemNow   = MemLast   = 0;
+	Engine     = CACHE_SizeClass;
+	Trace      = NULL;
+	NumTrace   = MaxTrace = TraceTicks = 0;
+
 	// Allocate cache memory.
 	if( Start )	CacheMemory = (BYTE *)Start;
 	else		CacheMemory = (BYTE *)appMalloc( BytesToAllocate, "CacheMemory" );
@@ -54,6 +67,14 @@ void FMemCache::Init
 	}
 	*PrevLink = NULL;
 
+	// Init the free lists and age buckets to empty.
+	for( i=0; i<NUM_SIZE_CLASSES; i++ )
+		ListInit( &FreeLists[i] );
+	for( i=0; i<AGE_BUCKETS; i++ )
+		ListInit( &AgeBuckets[i] );
+	ListInit( &AgeOld );
+	FreeMask = 0;
+
 	// Create one or more segments of free space in the cache memory.
 	if( SegmentSize==0 )
 	{
@@ -106,6 +127,14 @@ void FMemCache::Exit( int FreeMemory )
 	appFree( ItemMemory );
 	if( FreeMemory ) appFree( CacheMemory );
 
+	// Release the trace.
+	if( Recorder == this )
+		Recorder = NULL;
+	if( Trace )
+		appFree( Trace );
+	Trace    = NULL;
+	NumTrace = MaxTrace = 0;
+
 	// Success.
 	Initialized = 0;
 	unguard;
@@ -115,6 +144,100 @@ void FMemCache::Exit( int FreeMemory )
 	Internal functions.
 -----------------------------------------------------------------------------*/
 
+//
+// Add a newly claimed item to the used stats.
+//
+void FMemCache::Count( FCacheItem *Item )
+{
+	ItemsUsed++;
+	MemUsed += Item->Size;
+	ItemsNow++;
+	MemNow  += Item->Size;
+}
+
+//
+// Remove an item which is being flushed or merged from the used stats.
+//
+void FMemCache::Uncount( FCacheItem *Item )
+{
+	ItemsUsed--;
+	MemUsed -= Item->Size;
+	if( Item->Time == Time )
+	{
+		ItemsNow--;
+		MemNow  -= Item->Size;
+	}
+	else if( Item->Time == Time-1 )
+	{
+		ItemsLast--;
+		MemLast -= Item->Size;
+	}
+}
+
+//
+// Return the cost of flushing an item, decayed according to how long
+// ago it was last used.
+//
+INT FMemCache::GetCost( FCacheItem *Item )
+{
+	// Fraction of cost left after each number of stale ticks, out of 1024.
+	static INT Decay[256]={0};
+	if( !Decay[0] )
+	{
+		FLOAT Fraction = 1024.0;
+		for( INT i=0; i<(INT)ARRAY_COUNT(Decay); i++ )
+		{
+			Decay[i]  = (INT)Fraction;
+			Fraction *= 31.0/32.0;
+		}
+	}
+	if( Item->Id==0 || Item->Cost>=COST_INFINITE )
+		return Item->Cost;
+
+	INT Age = Time - Item->Time;
+	if( Age <= 1 )
+		return Item->Cost;
+	else if( Age-2 < (INT)ARRAY_COUNT(Decay) )
+		return Max( (INT)(((DWORD)(Item->Cost>>2) * Decay[Age-2]) >> 10), 1 );
+	else
+		return 1;
+}
+
+//
+// Link an item into the free list of its size class if it's free, or into
+// the age bucket of the time it was last used if it's used.
+//
+void FMemCache::LinkItem( FCacheItem *Item )
+{
+	if( Item->Id == 0 )
+	{
+		INT Class = SizeClass( Item->Size );
+		ListAdd( &FreeLists[Class], Item );
+		FreeMask |= (DWORD)1 << Class;
+	}
+	else
+	{
+		Item->Stamp = Item->Time;
+		ListAdd( Time - Item->Time < AGE_BUCKETS ? &AgeBuckets[Item->Time & (AGE_BUCKETS-1)] : &AgeOld, Item );
+	}
+}
+
+//
+// Unlink an item from its free list or age bucket. Must be called before
+// changing the size of a free item.
+//
+void FMemCache::UnlinkItem( FCacheItem *Item )
+{
+	Item->ListPrev->ListNext = Item->ListNext;
+	Item->ListNext->ListPrev = Item->ListPrev;
+	if( Item->Id == 0 )
+	{
+		INT Class = SizeClass( Item->Size );
+		if( FreeLists[Class].ListNext == &FreeLists[Class] )
+			FreeMask &= ~((DWORD)1 << Class);
+	}
+}
+
 //
 // Merge a cache item and its immediate successor into one
 // item, and remove the second. Returns the new merged item.
@@ -136,8 +259,11 @@ FMemCache::FCacheItem *FMemCache::MergeWithNext( FCacheItem *First )
 	debugInput( First->Data + First->Size == Second->Data );
 
 	// Absorb the second item into the first.
+	UnlinkItem( First );
+	UnlinkItem( Second );
 	First->Size       += Second->Size;
 	First->LinearNext  = Second->LinearNext;
+	LinkItem( First );
 
 	if( First->LinearNext != NULL )
 		First->LinearNext->LinearPrev = First;
@@ -152,12 +278,12 @@ FMemCache::FCacheItem *FMemCache::MergeWithNext( FCacheItem *First )
 }
 
 //
-// Flush a cache item and return the one immediately
-// following it in memory, or NULL if at end.
+// Flush a cache item and return the free space item
+// it was merged into.
 //
-FMemCache::FCacheItem *FMemCache::FlushItem( FCacheItem *Item )
+FMemCache::FCacheItem *FMemCache::FreeItem( FCacheItem *Item )
 {
-	guard(FMemCache::FlushItem);
+	guard(FMemCache::FreeItem);
 	debugInput( Item != NULL );
 	debugInput( Item->Id != 0 );
 
@@ -166,8 +292,11 @@ FMemCache::FCacheItem *FMemCache::FlushItem( FCacheItem *Item )
 		appErrorf( "Flushed locked cache object %x", Item->Id );
 
 	// Flush this one item.
+	UnlinkItem( Item );
+	Uncount( Item );
 	Item->Id	= 0;
 	Item->Cost	= 0;
+	LinkItem( Item );
 
 	// If previous item is free space, merge with it.
 	if( Item->LinearPrev && Item->LinearPrev->Id==0 && Item->Segment==Item->LinearPrev->Segment )
@@ -177,7 +306,18 @@ FMemCache::FCacheItem *FMemCache::FlushItem( FCacheItem *Item )
 	if( Item->LinearNext && Item->LinearNext->Id==0 && Item->Segment==Item->LinearNext->Segment )
 		Item = MergeWithNext( Item );
 
-	return Item->LinearNext;
+	return Item;
+	unguard;
+}
+
+//
+// Flush a cache item and return the one immediately
+// following it in memory, or NULL if at end.
+//
+FMemCache::FCacheItem *FMemCache::FlushItem( FCacheItem *Item )
+{
+	guard(FMemCache::FlushItem);
+	return FreeItem( Item )->LinearNext;
 	unguard;
 }
 
@@ -246,6 +386,47 @@ void FMemCache::CheckState()
 	}
 	checkState( ExpectedPointer == CacheMemory + MemTotal );
 
+	// Make sure the used stats are up to date.
+	INT CountUsed=0, CountNow=0, CountLast=0, CountMem=0;
+	for( Item=CacheItems; Item; Item=Item->LinearNext )
+	{
+		if( Item->Id )
+		{
+			CountUsed++;
+			CountNow  += (Item->Time == Time);
+			CountLast += (Item->Time == Time-1);
+			CountMem  += Item->Size;
+		}
+	}
+	checkState( CountUsed==ItemsUsed && CountNow==ItemsNow && CountLast==ItemsLast && CountMem==MemUsed );
+
+	// Make sure each free item is in the free list of its size class,
+	// and each used item is in an age bucket.
+	INT ListCount=0;
+	for( INT iList=0; iList<NUM_SIZE_CLASSES; iList++ )
+	{
+		FCacheItem *Sentinel = &FreeLists[iList];
+		checkState( ((FreeMask>>iList)&1) == (Sentinel->ListNext!=Sentinel) );
+		for( Item=Sentinel->ListNext; Item!=Sentinel; Item=Item->ListNext )
+		{
+			checkState( Item->Id == 0 );
+			checkState( SizeClass(Item->Size) == iList );
+			checkState( Item->ListNext->ListPrev == Item );
+			ListCount++;
+		}
+	}
+	for( iList=0; iList<=AGE_BUCKETS; iList++ )
+	{
+		FCacheItem *Sentinel = iList<AGE_BUCKETS ? &AgeBuckets[iList] : &AgeOld;
+		for( Item=Sentinel->ListNext; Item!=Sentinel; Item=Item->ListNext )
+		{
+			checkState( Item->Id != 0 );
+			checkState( Item->ListNext->ListPrev == Item );
+			ListCount++;
+		}
+	}
+	checkState( ListCount == ItemCount );
+
 	// Traverse all unused items.
 	for( Item=UnusedItems; Item; Item=Item->LinearNext )
 		ItemCount++;
@@ -300,13 +481,17 @@ void FMemCache::CreateNewFreeSpace
 	if( Prev && Prev->Id==0 && Prev->Segment==Segment )
 	{
 		// The previous item is free space, so merge with it.
+		UnlinkItem( Prev );
 		Prev->Size += End-Start;
+		LinkItem( Prev );
 	}
 	else if( Next && Next->Id==0 && Next->Segment==Segment )
 	{
 		// The next item is free space, so merge with it.
+		UnlinkItem( Next );
 		Next->Size += End-Start;
 		Next->Data  = Start;
+		LinkItem( Next );
 	}
 	else
 	{
@@ -336,6 +521,8 @@ void FMemCache::CreateNewFreeSpace
 
 		if( Next != NULL )
 			Next->LinearPrev = Item;
+
+		LinkItem( Item );
 	}
 	unguard;
 }
@@ -352,6 +539,8 @@ void FMemCache::CreateNewFreeSpace
 void FMemCache::Flush( DWORD Id, DWORD Mask )
 {
 	guard(FMemCache::Flush);
+	if( Recorder == this )
+		RecordOp( TRACE_Flush, Id, Mask );
 
 	if( Id == 0 )
 		// Flush all items.
@@ -412,28 +601,17 @@ void FMemCache::Flush( DWORD Id, DWORD Mask )
 -----------------------------------------------------------------------------*/
 
 //
-// Create an element in the cache.
+// Find the cheapest contiguous span of items with room for an item of
+// CreateSize, and merge it into one unhashed item.
 //
 // This is O(num_items_in_cache), sacrificing some speed in the
 // name of better cache efficiency. However there aren't any really
 // good algorithms for priority queues where most priorities change
 // every iteration this that I'm aware of.
 //
-BYTE *FMemCache::Create
-(
-	DWORD		Id, 
-	FCacheItem	*&Item, 
-	INT			CreateSize, 
-	INT			Alignment,
-	INT			MaxCreateSize
-)
+FMemCache::FCacheItem *FMemCache::FindLinear( DWORD Id, INT CreateSize, INT Alignment )
 {
-	guard(FMemCache::Create);
-	clock(CreateTime);
-	checkInput( CreateSize > 0 );
-	checkInput( MaxCreateSize==0 || MaxCreateSize>=CreateSize );
-	checkInput( Id != 0 );
-	NumCreates++;
+	guard(FMemCache::FindLinear);
 
 	// Best cost and starting element found thus far.
 	INT		   BestCost   = COST_INFINITE;
@@ -448,7 +626,7 @@ BYTE *FMemCache::Create
 	for( FCacheItem *Last = CacheItems; Last; Last = Last->LinearNext )
 	{
 		// Add the cost and size of new Last element to our accumulator.
-		Cost += Last->Cost;
+		Cost += GetCost( Last );
 		Size += Last->Size;
 
 		// While the interval from First to Last (inclusive) contains
@@ -465,7 +643,7 @@ BYTE *FMemCache::Create
 			}
 
 			// Subtract the cost and size from the element we're passing:
-			Cost -= First->Cost;
+			Cost -= GetCost( First );
 			Size -= First->Size;
 
 			// Go to next First.
@@ -486,71 +664,209 @@ BYTE *FMemCache::Create
 		appErrorf( "Create %08x failed: Size=%i Align=%i NumLocked=%i BytesLocked=%i", Id, Size, Alignment, ItemsLocked, BytesLocked );
 	}
 
-	// Merge all items from Start to End into one bigger item,
-	// while unhashing them all.
-	while( BestLast != BestFirst )
+	// Unhash all items from Start to End, and merge them into
+	// one bigger item.
+	for( FCacheItem *Item=BestFirst; ; Item=Item->LinearNext )
 	{
-		if( BestLast->Id != 0 ) Unhash( BestLast->Id );
+		if( Item->Id != 0 )
+		{
+			Unhash( Item->Id );
+			Uncount( Item );
+		}
+		if( Item == BestLast )
+			break;
+	}
+	while( BestLast != BestFirst )
 		BestLast = MergeWithNext( BestLast->LinearPrev );
+
+	return BestFirst;
+	unguard;
+}
+
+//
+// Find a free item with room for an item of CreateSize, making one by
+// evicting the least recently used items if needed. Returns NULL if this
+// takes too many evictions, and the linear search should be used instead.
+//
+// Taking a free item is O(log size). Evicting looks only at the oldest
+// age buckets; items found there which were used after being bucketed
+// are moved to the bucket they now belong in, so each Get is paid for
+// at most once.
+//
+FMemCache::FCacheItem *FMemCache::FindSizeClass( INT CreateSize, INT Alignment )
+{
+	guard(FMemCache::FindSizeClass);
+
+	// Look at a few free items of the size class which may have room.
+	INT Class = SizeClass( CreateSize + Alignment - 1 );
+	INT Count = 0;
+	FCacheItem *Sentinel = &FreeLists[Class];
+	for( FCacheItem *Item=Sentinel->ListNext; Item!=Sentinel && Count<8; Item=Item->ListNext,Count++ )
+		if( Fits( Item, CreateSize, Alignment ) )
+			return Item;
+
+	// Any free item of a bigger size class has room.
+	DWORD Mask = FreeMask & ~(((DWORD)2 << Class) - 1);
+	if( Mask )
+	{
+		for( Class++; !(Mask & ((DWORD)1<<Class)); Class++ );
+		return FreeLists[Class].ListNext;
+	}
+
+	// Evict items from the oldest bucket to the one used two ticks ago,
+	// since items used last tick may still be in use, as Evictable says.
+	INT Evictions = 0;
+	for( INT Age=AGE_BUCKETS; Age>1; Age-- )
+	{
+		Sentinel = Age==AGE_BUCKETS ? &AgeOld : &AgeBuckets[(Time-Age) & (AGE_BUCKETS-1)];
+		Item = Sentinel->ListNext;
+		while( Item != Sentinel )
+		{
+			FCacheItem *Next = Item->ListNext;
+			if( Item->Time != Item->Stamp )
+			{
+				// Used since it was bucketed, so move it to its new bucket.
+				UnlinkItem( Item );
+				LinkItem( Item );
+				Item = Next;
+				continue;
+			}
+			if( !Evictable( Item, Item->Segment ) )
+			{
+				// Locked, so leave it where it is.
+				Item = Next;
+				continue;
+			}
+
+			// Evict it, along with stale neighbours until there's room.
+			Unhash( Item->Id );
+			FCacheItem *Block = FreeItem( Item );
+			while( !Fits( Block, CreateSize, Alignment ) )
+			{
+				FCacheItem *Other = Block->LinearNext;
+				if( !Evictable( Other, Block->Segment ) )
+				{
+					Other = Block->LinearPrev;
+					if( !Evictable( Other, Block->Segment ) )
+						break;
+				}
+				Unhash( Other->Id );
+				Block = FreeItem( Other );
+			}
+			if( Fits( Block, CreateSize, Alignment ) )
+				return Block;
+			if( ++Evictions >= MAX_EVICTIONS )
+				return NULL;
+
+			// Neighbours may have left the bucket too, so start it over.
+			Item = Sentinel->ListNext;
+		}
 	}
-	if( BestFirst->Id != 0 ) Unhash( BestFirst->Id );
+	return NULL;
+	unguard;
+}
 
-	// Now we have a big free memory block from BestFirst->Data to 
-	// BestFirst->Data + BestFirst->Size.
-	BYTE *Result = Align( BestFirst->Data, Alignment );
-	debugLogic( Result + CreateSize <= BestFirst->Data + BestFirst->Size );
+//
+// Claim an unhashed item with enough room for a new cache item,
+// lock it, and chop off the space it doesn't need.
+//
+BYTE *FMemCache::Claim( FCacheItem *Item, DWORD Id, INT CreateSize, INT Alignment, INT MaxCreateSize )
+{
+	guard(FMemCache::Claim);
+
+	// We have a big free memory block from Item->Data to 
+	// Item->Data + Item->Size.
+	BYTE *Result = Align( Item->Data, Alignment );
+	debugLogic( Result + CreateSize <= Item->Data + Item->Size );
 	debugLogic( ((int)Result & (Alignment-1)) == 0 );
 
 	// If a nonzero MaxCreateSize was specified, the caller wants to take
 	// more than CreateSize bytes of memory if it's available.
 	if( MaxCreateSize )
-		CreateSize = Min(MaxCreateSize, BestFirst->Size - (Result - BestFirst->Data) );
+		CreateSize = Min(MaxCreateSize, Item->Size - (Result - Item->Data) );
 
-	// Claim BestFirst for the block we're creating, and lock it.
-	BestFirst->Time = Time;
-	BestFirst->Id   = Id;
-	BestFirst->Cost = CreateSize + COST_INFINITE;
+	// Claim Item for the block we're creating, and lock it.
+	UnlinkItem( Item );
+	Item->Time = Time;
+	Item->Id   = Id;
+	Item->Cost = CreateSize + COST_INFINITE;
+	LinkItem( Item );
 
 	// Hash it.
 	FCacheItem **HashPtr	= &HashItems[Id % HASH_COUNT];
-	BestFirst->HashNext		= *HashPtr;
-	*HashPtr				= BestFirst;
+	Item->HashNext			= *HashPtr;
+	*HashPtr				= Item;
 
 	// Create free space past the end of the newly allocated block.
-	if( UnusedItems && (Result + CreateSize < BestFirst->Data + BestFirst->Size))
+	if( UnusedItems && (Result + CreateSize < Item->Data + Item->Size))
 	{
 		CreateNewFreeSpace
 		(
 			Result + CreateSize, 
-			BestFirst->Data + BestFirst->Size,
-			BestFirst,
-			BestFirst->LinearNext,
-			BestFirst->Segment
+			Item->Data + Item->Size,
+			Item,
+			Item->LinearNext,
+			Item->Segment
 		);
 
 		// Chop the new free space off this item.
-		BestFirst->Size = Result + CreateSize - BestFirst->Data;
+		Item->Size = Result + CreateSize - Item->Data;
 	}
 
 	// Create free space before the beginning of the newly allocated.
-	if( UnusedItems && (Result - BestFirst->Data) >= IGNORE_SIZE )
+	if( UnusedItems && (Result - Item->Data) >= IGNORE_SIZE )
 	{
 		CreateNewFreeSpace
 		(
-			BestFirst->Data, 
+			Item->Data, 
 			Result,
-			BestFirst->LinearPrev,
-			BestFirst,
-			BestFirst->Segment
+			Item->LinearPrev,
+			Item,
+			Item->Segment
 		);
 
 		// Chop the new free space off this item.
-		BestFirst->Size -= Result - BestFirst->Data;
-		BestFirst->Data  = Result;
+		Item->Size -= Result - Item->Data;
+		Item->Data  = Result;
 	}
+	Count( Item );
+	return Result;
+	unguard;
+}
+
+//
+// Create an element in the cache.
+//
+BYTE *FMemCache::Create
+(
+	DWORD		Id, 
+	FCacheItem	*&Item, 
+	INT			CreateSize, 
+	INT			Alignment,
+	INT			MaxCreateSize
+)
+{
+	guard(FMemCache::Create);
+	clock(CreateTime);
+	checkInput( CreateSize > 0 );
+	checkInput( MaxCreateSize==0 || MaxCreateSize>=CreateSize );
+	checkInput( Id != 0 );
+	NumCreates++;
+	if( Recorder == this )
+		RecordOp( TRACE_Create, Id, CreateSize, Alignment, MaxCreateSize );
+
+	// Find room for the item.
+	FCacheItem *Block = NULL;
+	if( Engine == CACHE_SizeClass )
+		Block = FindSizeClass( CreateSize, Alignment );
+	if( Block == NULL )
+		Block = FindLinear( Id, CreateSize, Alignment );
+
+	// Claim it.
+	BYTE *Result = Claim( Block, Id, CreateSize, Alignment, MaxCreateSize );
 
 	// Set the resulting Item.
-	Item = BestFirst;
+	Item = Block;
 
 	ConditionalCheckState();
 	unclock(CreateTime);
@@ -570,42 +886,276 @@ void FMemCache::Tick()
 	guard(FMemCache::Tick);
 	ConditionalCheckState();
 
-	// Init memory stats.
-	MemFresh = MemStale = 0;
-	ItemsFresh = ItemsStale = 0;
+	// Record the tick, and stop recording after the requested number.
+	if( Recorder == this )
+	{
+		RecordOp( TRACE_Tick, 0 );
+		if( --TraceTicks <= 0 )
+		{
+			Recorder = NULL;
+			debugf( LOG_Info, "Recorded %i cache operations", NumTrace );
+		}
+	}
 
-	// Check each item.
+	// Make sure no items are locked.
 	for( FCacheItem *Item = CacheItems; Item; Item=Item->LinearNext )
+		if( Item->Id!=0 && Item->Cost>=COST_INFINITE )
+			appErrorf( "Cache item %08X still locked in call to Tick", Item->Id );
+
+	// Publish the stats of the tick that's ending.
+	MemFresh   = MemNow;
+	ItemsFresh = ItemsNow;
+	MemStale   = MemUsed   - MemNow   - MemLast;
+	ItemsStale = ItemsUsed - ItemsNow - ItemsLast;
+
+	// Update the cache's time. Items used this tick now belong to the last.
+	Time++;
+	ItemsLast = ItemsNow;
+	MemLast   = MemNow;
+	ItemsNow  = MemNow = 0;
+
+	// Move the age bucket which has just become too old to have its
+	// own time into the old bucket.
+	FCacheItem *Sentinel = &AgeBuckets[Time & (AGE_BUCKETS-1)];
+	if( Sentinel->ListNext != Sentinel )
 	{
-		if( Item->Id != 0 )
+		Sentinel->ListNext->ListPrev = AgeOld.ListPrev;
+		AgeOld.ListPrev->ListNext    = Sentinel->ListNext;
+		Sentinel->ListPrev->ListNext = &AgeOld;
+		AgeOld.ListPrev              = Sentinel->ListPrev;
+		ListInit( Sentinel );
+	}
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	Trace recording and benchmark.
+-----------------------------------------------------------------------------*/
+
+//
+// Append an operation to the trace.
+//
+void FMemCache::RecordOp( INT Op, DWORD Id, INT Size, INT Alignment, INT MaxSize )
+{
+	guard(FMemCache::RecordOp);
+
+	// Task threads may be using the cache concurrently, so leave them out.
+	if( GTaskPool.Running )
+		return;
+
+	if( NumTrace == MaxTrace )
+	{
+		MaxTrace = MaxTrace*2 + 4096;
+		Trace    = (FTraceOp *)appRealloc( Trace, MaxTrace*sizeof(FTraceOp), "CacheTrace" );
+	}
+	FTraceOp &T = Trace[NumTrace++];
+	T.Op		= Op;
+	T.Id		= Id;
+	T.Size		= Size;
+	T.Alignment	= Alignment;
+	T.MaxSize	= MaxSize;
+
+	unguard;
+}
+
+//
+// Record unlocking an item, if it belongs to this cache.
+//
+void FMemCache::RecordUnlock( FCacheItem *Item )
+{
+	guard(FMemCache::RecordUnlock);
+	if( Item>=UnusedItemMemory && Item<UnusedItemMemory+ItemsTotal )
+		RecordOp( TRACE_Unlock, Item->Id );
+	unguard;
+}
+
+//
+// Make up a trace of a view sweeping slowly across a set of differently
+// sized items, such as textures, with a few items used from anywhere.
+//
+void FMemCache::SynthesizeTrace( INT Frames, INT NumIds, INT PerFrame )
+{
+	guard(FMemCache::SynthesizeTrace);
+
+	NumTrace    = 0;
+	DWORD Seed  = 0x2545F491;
+	INT  Window = Max( NumIds/8, 1 );
+	for( INT Frame=0; Frame<Frames; Frame++ )
+	{
+		INT Start = (Frame * 7) % NumIds;
+		for( INT i=0; i<PerFrame; i++ )
 		{
-			// Make sure no items are locked.
-			if( Item->Cost >= COST_INFINITE )
-			{
-				appErrorf( "Cache item %08X still locked in call to Tick", Item->Id );
-			}
-			else if( Time - Item->Time > 1)
-			{
-				// Exponentially decrease Cost for stale items.
-				Item->Cost -= Item->Cost >> 5;
-				MemStale   += Item->Size;
-				ItemsStale ++;
-			}
-			else if( Time - Item->Time == 1)
-			{
-				// Cut Cost by 1/4th as soon as it first becomes stale.
-				Item->Cost = Item->Cost >> 2;
-			}
-			else
-			{
-				MemFresh   += Item->Size;
-				ItemsFresh ++;
-			}
+			Seed         = Seed * 1664525 + 1013904223;
+			DWORD Random = Seed >> 8;
+			DWORD Index  = (Random % 5) ? (Start + (Random/5) % Window) % NumIds : (Random/5) % NumIds;
+			DWORD Hash   = Index * 2654435761;
+			DWORD Id     = 0xCA000000 + Index;
+			RecordOp( TRACE_Get,    Id, 0, DEFAULT_ALIGNMENT );
+			RecordOp( TRACE_Create, Id, (128 << ((Hash>>27) % 10)) + (Hash & 1023), DEFAULT_ALIGNMENT );
+			RecordOp( TRACE_Unlock, Id );
 		}
+		RecordOp( TRACE_Tick, 0 );
 	}
+	unguard;
+}
 
-	// Update the cache's time.
-	Time++;
+//
+// Replay the trace on a new cache of the same size using the given
+// engine. Creates items on a Get miss if the trace knows their size.
+// Returns the replay time in milliseconds.
+//
+DOUBLE FMemCache::ReplayTrace( INT InEngine, INT &Misses, INT &Creates )
+{
+	guard(FMemCache::ReplayTrace);
+	FMemMark Mark(GMem);
+	Misses = Creates = 0;
+
+	// Hash the first create of each id.
+	INT HashSize = 256;
+	while( HashSize < NumTrace )
+		HashSize *= 2;
+	INT *CreateHash = new(GMem,MEM_Oned,HashSize)INT;
+	INT i, j;
+	for( i=0; i<NumTrace; i++ )
+	{
+		if( Trace[i].Op == TRACE_Create )
+		{
+			for( j=Trace[i].Id & (HashSize-1); CreateHash[j]>=0 && Trace[CreateHash[j]].Id!=Trace[i].Id; j=(j+1) & (HashSize-1) );
+			if( CreateHash[j] < 0 )
+				CreateHash[j] = i;
+		}
+	}
+	FCacheItem **Locked = new(GMem,NumTrace)FCacheItem*;
+	INT        NumLocked = 0;
+
+	// Make the cache.
+	FMemCache *Cache = new FMemCache;
+	Cache->Init( MemTotal, ItemsTotal );
+	Cache->Engine = InEngine;
+
+	// Replay.
+	QWORD StartTime = GApp->MicrosecondTime();
+	for( i=0; i<NumTrace; i++ )
+	{
+		FTraceOp   &T = Trace[i];
+		FCacheItem *Item;
+		switch( T.Op )
+		{
+			case TRACE_Get:
+				if( Cache->Get( T.Id, Item, T.Alignment ) )
+				{
+					Locked[NumLocked++] = Item;
+				}
+				else
+				{
+					Misses++;
+					for( j=T.Id & (HashSize-1); CreateHash[j]>=0 && Trace[CreateHash[j]].Id!=T.Id; j=(j+1) & (HashSize-1) );
+					if( CreateHash[j] >= 0 )
+					{
+						FTraceOp &C = Trace[CreateHash[j]];
+						Cache->Create( C.Id, Item, C.Size, C.Alignment, C.MaxSize );
+						Locked[NumLocked++] = Item;
+						Creates++;
+					}
+				}
+				break;
+			case TRACE_Create:
+				for( j=NumLocked-1; j>=0 && Locked[j]->Id!=T.Id; j-- );
+				if( j < 0 )
+				{
+					if( !Cache->Get( T.Id, Item, T.Alignment ) )
+					{
+						Cache->Create( T.Id, Item, T.Size, T.Alignment, T.MaxSize );
+						Creates++;
+					}
+					Locked[NumLocked++] = Item;
+				}
+				break;
+			case TRACE_Unlock:
+				for( j=NumLocked-1; j>=0 && Locked[j]->Id!=T.Id; j-- );
+				if( j >= 0 )
+				{
+					Locked[j]->Unlock();
+					Locked[j] = Locked[--NumLocked];
+				}
+				break;
+			case TRACE_Tick:
+			case TRACE_Flush:
+				// Release items this replay locked but the original didn't.
+				while( NumLocked > 0 )
+					Locked[--NumLocked]->Unlock();
+				if( T.Op == TRACE_Tick )
+					Cache->Tick();
+				else
+					Cache->Flush( T.Id, T.Size );
+				break;
+		}
+	}
+	while( NumLocked > 0 )
+		Locked[--NumLocked]->Unlock();
+	DOUBLE Msec = (SQWORD)(GApp->MicrosecondTime() - StartTime) / 1000.0;
+
+	// Clean up.
+	Cache->Exit( 1 );
+	delete Cache;
+	Mark.Pop();
+	return Msec;
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	Command line.
+-----------------------------------------------------------------------------*/
+
+//
+// Execute a cache command.
+//
+INT FMemCache::Exec( const char *Cmd, FOutputDevice *Out )
+{
+	guard(FMemCache::Exec);
+	const char *Str = Cmd;
+
+	if( !GetCMD(&Str,"CACHE") )
+		return 0;
+
+	if( GetCMD(&Str,"RECORD") )
+	{
+		// Record the operations of the following ticks.
+		TraceTicks = 350;
+		GetINT(Str,"TICKS=",&TraceTicks);
+		NumTrace   = 0;
+		Recorder   = TraceTicks>0 ? this : NULL;
+		Out->Logf( "Recording cache operations for %i ticks", TraceTicks );
+		return 1;
+	}
+	else if( GetCMD(&Str,"BENCH") )
+	{
+		// Replay the recorded trace, or a synthetic one, with both engines.
+		Recorder = NULL;
+		if( GetCMD(&Str,"SYNTH") || NumTrace==0 )
+		{
+			INT Frames=1000, Ids=4000, PerFrame=150;
+			GetINT(Str,"FRAMES=",&Frames);
+			GetINT(Str,"IDS=",&Ids);
+			GetINT(Str,"PERFRAME=",&PerFrame);
+			SynthesizeTrace( Max(Frames,1), Max(Ids,1), Max(PerFrame,1) );
+		}
+		INT LinearMisses, LinearCreates, SizeMisses, SizeCreates;
+		DOUBLE LinearMsec = ReplayTrace( CACHE_Linear,    LinearMisses, LinearCreates );
+		DOUBLE SizeMsec   = ReplayTrace( CACHE_SizeClass, SizeMisses,   SizeCreates   );
+		Out->Logf( "Replayed %i cache operations on %iK", NumTrace, MemTotal/1024 );
+		Out->Logf( "Linear:     %8.1f msec, %i misses, %i creates", LinearMsec, LinearMisses, LinearCreates );
+		Out->Logf( "Size class: %8.1f msec, %i misses, %i creates", SizeMsec,   SizeMisses,   SizeCreates   );
+		return 1;
+	}
+	else if( GetCMD(&Str,"ENGINE") )
+	{
+		if     ( GetCMD(&Str,"LINEAR")    ) Engine = CACHE_Linear;
+		else if( GetCMD(&Str,"SIZECLASS") ) Engine = CACHE_SizeClass;
+		Out->Logf( "Cache engine is %s", Engine==CACHE_Linear ? "linear" : "size class" );
+		return 1;
+	}
+	return 0;
 	unguard;
 }
 
@@ -634,6 +1184,56 @@ void FMemCache::Status( char *StatusText )
 	NumGets = NumCreates = CreateTime = 0;
 }
 
+//
+// Report the memory used by the items of each cache id base, such as
+// CID_ShadowMap, and by free space.
+//
+void FMemCache::DumpCategories( FOutputDevice *Out, INT Csv )
+{
+	guard(FMemCache::DumpCategories);
+
+	// Total up the items of each base, by the base's top byte.
+	INT Items[256], Bytes[256], FreeItems=0, FreeBytes=0;
+	for( INT i=0; i<256; i++ )
+		Items[i] = Bytes[i] = 0;
+	for( FCacheItem *Item=CacheItems; Item; Item=Item->LinearNext )
+	{
+		if( Item->Id )
+		{
+			Items[Item->Id >> 24]++;
+			Bytes[Item->Id >> 24] += Item->Size;
+		}
+		else
+		{
+			FreeItems++;
+			FreeBytes += Item->Size;
+		}
+	}
+
+	// Report them.
+	if( !Csv )
+		Out->Logf( "Cache by id (%iK):", MemTotal/1024 );
+	for( i=0; i<=256; i++ )
+	{
+		char Temp[32];
+		const char *Name = i<256 ? GetCacheIDName( (DWORD)i << 24 ) : "Free";
+		INT  Count       = i<256 ? Items[i] : FreeItems;
+		INT  Size        = i<256 ? Bytes[i] : FreeBytes;
+		if( !Name )
+		{
+			sprintf( Temp, "0x%02X", i );
+			Name = Temp;
+		}
+		if( !Count )
+			continue;
+		if( Csv )
+			Out->Logf( "Cache,%s,%i,%i,0,0", Name, Count, Size );
+		else
+			Out->Logf( "  %-24s %8iK in %6i items", Name, Size/1024, Count );
+	}
+	unguard;
+}
+
 //
 // Draw the cache layout to a frame buffer.
 //
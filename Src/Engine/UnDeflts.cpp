@@ -43,6 +43,26 @@ void FGlobalDefaults::Init( char *ThisCmdLine )
 	// Audio properties.
 	AudioActive	= 1; GetONOFF (CmdLine,"AUDIO=",&AudioActive);
 
+	// Task threads: 1 = just the main thread, 0 = one per processor.
+	TaskThreads = GApp->GetProfileInteger("Engine","TaskThreads",1);
+	GetINT (CmdLine,"THREADS=",&TaskThreads);
+
+	// Load swappable object data on first use.
+	LazyLoad = GApp->GetProfileInteger("Engine","LazyLoad",1);
+	GetONOFF (CmdLine,"LAZY=",&LazyLoad);
+
+	// Collect garbage a little per tick during play.
+	IncrementalGC = GApp->GetProfileInteger("Engine","IncrementalGC",0);
+	GetONOFF (CmdLine,"GC=",&IncrementalGC);
+
+	// Collision properties.
+	CollisionGrid = GApp->GetProfileInteger("Engine","CollisionGrid",0);
+	GetONOFF (CmdLine,"GRID=",&CollisionGrid);
+
+	// Animate meshes from unpacked keyframe streams.
+	MeshStreams = GApp->GetProfileInteger("Engine","MeshStreams",1);
+	GetONOFF (CmdLine,"STREAMS=",&MeshStreams);
+
 	// Transaction tracking.
 	MaxTrans     	= 80;
 	MaxChanges		= 12000;
@@ -24,8 +24,9 @@ UNENGINE_API FGlobalUnrealServer	GServer;
 UNENGINE_API FGlobalDefaults		GDefaults;
 UNENGINE_API FGlobalTopicTable		GTopics;
 UNENGINE_API FMemCache				GCache;
-UNENGINE_API FMemStack				GMem;
+UNENGINE_API FMemStack				GMainMem;
 UNENGINE_API FMemStack				GDynMem;
+UNENGINE_API FMemChunkPool			GChunkPool;
 UNENGINE_API FGlobalMath			GMath;
 UNENGINE_API FGlobalGfx				GGfx;
 
@@ -94,8 +95,9 @@ int FGlobalUnrealEngine::Init
 
 	// Init memory subsystem.
 	GCache.Init					(1024*1024*(GEditor ? 10 : 6),2048);
-	GMem.Init					(GCache,16384,65536);
-	GDynMem.Init				(GCache,16384,65536);
+	GMainMem.Init				(GCache,16384,65536,"Main");
+	GDynMem.Init				(GCache,16384,65536,"Dynamic");
+	GTaskPool.Init				(GDefaults.TaskThreads);
 
 	// Init major subsystems.
 	GObj.Init					();         // Start object manager.
@@ -162,8 +164,10 @@ void FGlobalUnrealEngine::Exit()
 	GServer.Exit();
 	GTopics.Exit();
 	GObj.Exit();
+	GTaskPool.Exit();
+	GChunkPool.Exit();
 	GCache.Exit(1);
-	GMem.Exit();
+	GMainMem.Exit();
 	GDynMem.Exit();
 	GDefaults.Exit();
 
@@ -402,6 +406,7 @@ int FGlobalUnrealEngine::Exec(const char *Cmd,FOutputDevice *Out)
 	if (GEditor && GEditor->Exec				(Cmd,Out)) return 1;
 	if (GRend->Exec								(Cmd,Out)) return 1;
 	if (GAudio.Exec								(Cmd,Out)) return 1;
+	if (GCache.Exec								(Cmd,Out)) return 1;
 
 	// Handle engine command line.
 	if( GetCMD(&Str,"FLUSH") )
@@ -410,6 +415,36 @@ int FGlobalUnrealEngine::Exec(const char *Cmd,FOutputDevice *Out)
 		Out->Log("Flushed memory caches");
 		return 1;
 	}
+	else if( GetCMD(&Str,"MESH") )
+	{
+		if( GetCMD(&Str,"BENCH") )
+		{
+			// Animate many copies of a mesh with packed and unpacked keyframes.
+			UMesh *Mesh;
+			if( !GetUMesh(Str,"NAME=",Mesh) )
+			{
+				Out->Log(LOG_ExecError,"Missing mesh name");
+				return 1;
+			}
+			INT Meshes=500; GetINT(Str,"MESHES=",&Meshes);
+			INT Frames=100; GetINT(Str,"FRAMES=",&Frames);
+			UMesh::Bench( Mesh, Max(Meshes,1), Max(Frames,1), Out );
+			return 1;
+		}
+		else if( GetCMD(&Str,"STREAMS") )
+		{
+			// Switch between packed and unpacked keyframe animation.
+			if     ( GetCMD(&Str,"ON")  ) GDefaults.MeshStreams = 1;
+			else if( GetCMD(&Str,"OFF") ) GDefaults.MeshStreams = 0;
+			else                          GDefaults.MeshStreams ^= 1;
+			GCache.Flush( CID_MeshFrame,   CID_MAX );
+			GCache.Flush( CID_MeshNormals, CID_MAX );
+			Out->Log( GDefaults.MeshStreams ? "Mesh keyframe streams enabled" : "Mesh keyframe streams disabled" );
+			return 1;
+		}
+		Out->Log(LOG_ExecError,"Unrecognized mesh command");
+		return 1;
+	}
 	else if( GetCMD(&Str,"_HELP") )
 	{
 		return 1;
@@ -142,6 +142,9 @@ AActor *ULevel::SpawnActor
 	guard(ULevel::SpawnActor);
 	checkState(IsLocked());
 
+	// Trees whose scripts can spawn actors are never ticked in parallel.
+	checkState(!Deferring);
+
 	// Make sure this class is spawnable.
 	if( !Class )
 	{
@@ -287,6 +290,14 @@ int ULevel::DestroyActor( AActor *ThisActor )
 		// If already on list to be deleted, pretend the call was successful.
 		if( ThisActor->bDeleteMe )
 			return 1;
+
+		// During a parallel tick, just flag the actor and destroy it at the sync point.
+		if( Deferring )
+		{
+			ThisActor->bDeleteMe = 1;
+			DeferCommand( TICKCMD_Destroy, ThisActor );
+			return 1;
+		}
 	}
 
 	// Get index.
@@ -985,10 +996,15 @@ int ULevel::MoveActor
 		return 0;
 
 	// Update the location.
-	if( Actor->bCollideActors ) Hash.RemoveActor( Actor );
-	Actor->Location += FinalDelta;
-	Actor->Rotation  = NewRotation;
-	if( Actor->bCollideActors ) Hash.AddActor( Actor );
+	if( Actor->bCollideActors )
+	{
+		Hash.MoveActor( Actor, Actor->Location + FinalDelta, NewRotation );
+	}
+	else
+	{
+		Actor->Location += FinalDelta;
+		Actor->Rotation  = NewRotation;
+	}
 
 	// Handle bump and touch notifications.
 	if( !bTest )
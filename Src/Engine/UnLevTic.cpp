@@ -72,7 +72,12 @@ void ULevel::Tick( int CamerasOnly, AActor *ActiveLocalPlayer, FLOAT DeltaSecond
 	// parent has been updated.  The result is that parent actors are always updated
 	// before their children.
 	clock(GServer.ActorTickTime);
-	for( UpdatePlayers=0; UpdatePlayers<2; UpdatePlayers++ ) do
+	if( ParallelTick && !CamerasOnly )
+	{
+		// Tick independent actors on all task threads.
+		TickParallel( ActiveLocalPlayer, DeltaSeconds, Ticked );
+	}
+	else for( UpdatePlayers=0; UpdatePlayers<2; UpdatePlayers++ ) do
 	{
 		NumUpdated = 0;
 		NumSkipped = 0;
@@ -103,266 +108,789 @@ void ULevel::Tick( int CamerasOnly, AActor *ActiveLocalPlayer, FLOAT DeltaSecond
 						continue;
 				}
 
-				// Update all animation, including multiple passes if necessary.
-				INT Iterations = 0;
-				FLOAT Seconds  = DeltaSeconds;
-				while( Actor->AnimSequence!=NAME_None && Actor->AnimRate!=0.0 && Seconds!=0.0 && ++Iterations < 32 )
+				// Tick it.
+				INT Result = TickActor( Actor, CamerasOnly, ActiveLocalPlayer, DeltaSeconds );
+				if( Result == TICK_Updated )
+				{
+					Actor->bTicked = Ticked;
+					NumUpdated++;
+				}
+				else if( Result == TICK_Skipped )
 				{
-					// Remember the old frame.
-					FLOAT OldAnimFrame = Actor->AnimFrame;
+					NumSkipped++;
+				}
+			}
+			else
+			{
+				// Skip this actor.
+				NumSkipped++;
+			}
+		}
+		NumIter++;
+	} while( NumUpdated && NumSkipped );
 
-					// Update animation, and possibly overflow it.
-					if( Actor->AnimRate >= 0.0 )
-					{
-						// Update regular animation.
-						Actor->AnimFrame += Actor->AnimRate * Seconds;
-					}
-					else
-					{
-						// Update velocity-scaled animation.
-						Actor->AnimFrame += ::Max( Actor->AnimMinRate, Actor->Velocity.Size() * -Actor->AnimRate ) * Seconds;
-					}
+	unclock(GServer.ActorTickTime);
 
-					// Handle all animation sequence notifys.
-					if( Actor->Mesh && Actor->bAnimNotify )
-					{
-						const FMeshAnimSeq* Seq = Actor->Mesh->GetAnimSeq( Actor->AnimSequence );
-						if( Seq )
-						{
-							FLOAT                 BestElapsedFrames  = 100000.0;
-							FMeshAnimNotify*      BestNotify         = NULL;
-							UMeshAnimNotifys::Ptr Notifys            = Actor->Mesh->Notifys;
-							for( int i=Seq->StartNotify; i<Seq->StartNotify+Seq->NumNotifys; i++ )
-							{
-								FMeshAnimNotify &Notify = Notifys(i);
-								if( OldAnimFrame<Notify.Time && Actor->AnimFrame>=Notify.Time )
-								{
-									FLOAT ElapsedFrames = Notify.Time - OldAnimFrame;
-									if( BestNotify==NULL || ElapsedFrames<BestElapsedFrames )
-									{
-										BestElapsedFrames = ElapsedFrames;
-										BestNotify        = &Notify;
-									}
-								}
-							}
-							if( BestNotify )
-							{
-								Seconds          = Seconds * (Actor->AnimFrame - BestNotify->Time) / (Actor->AnimFrame - OldAnimFrame);
-								Actor->AnimFrame = BestNotify->Time;
-								Actor->Process( BestNotify->Function, NULL );
-								continue;
-							}
-						}
-					}
+	// Unlock everything.
+	SkipUpdate:
+	Unlock(LOCK_ReadWrite);
 
-					// Handle end of animation sequence.
-					if( Actor->AnimFrame<Actor->AnimEnd || (Actor->bAnimLoop && OldAnimFrame>Actor->AnimEnd && Actor->AnimFrame<1.0) )
-					{
-						// We have finished the animation updating for this tick.
-						Seconds = 0.0;
-					}
-					else if( Actor->bAnimLoop && OldAnimFrame<=1.0 && Actor->AnimFrame>1.0 )
-					{
-						// Just past end, so loop it.
-						Seconds          = Seconds * (Actor->AnimFrame - 1.0) / (Actor->AnimFrame - OldAnimFrame);
-						Actor->AnimFrame = 0.0;
-					}
-					else if( OldAnimFrame<=Actor->AnimEnd )
+	Mark.Pop();
+	unclock(GServer.LevelTickTime);
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	Actor ticking.
+-----------------------------------------------------------------------------*/
+
+//
+// Tick one actor: Update its animation, tick it, run its state code, timers
+// and physics. Returns TICK_Updated if the actor was ticked, TICK_Skipped if
+// it wasn't, and TICK_Destroyed if it destroyed itself along the way.
+//
+int ULevel::TickActor( AActor *Actor, int CamerasOnly, AActor *ActiveLocalPlayer, FLOAT DeltaSeconds )
+{
+	guard(ULevel::TickActor);
+
+	// See if this is a pawn.
+	APawn *Pawn = Actor->IsA("Pawn") ? (APawn*)Actor : NULL;
+
+	// Update all animation, including multiple passes if necessary.
+	INT Iterations = 0;
+	FLOAT Seconds  = DeltaSeconds;
+	while( Actor->AnimSequence!=NAME_None && Actor->AnimRate!=0.0 && Seconds!=0.0 && ++Iterations < 32 )
+	{
+		// Remember the old frame.
+		FLOAT OldAnimFrame = Actor->AnimFrame;
+
+		// Update animation, and possibly overflow it.
+		if( Actor->AnimRate >= 0.0 )
+		{
+			// Update regular animation.
+			Actor->AnimFrame += Actor->AnimRate * Seconds;
+		}
+		else
+		{
+			// Update velocity-scaled animation.
+			Actor->AnimFrame += ::Max( Actor->AnimMinRate, Actor->Velocity.Size() * -Actor->AnimRate ) * Seconds;
+		}
+
+		// Handle all animation sequence notifys.
+		if( Actor->Mesh && Actor->bAnimNotify )
+		{
+			const FMeshAnimSeq* Seq = Actor->Mesh->GetAnimSeq( Actor->AnimSequence );
+			if( Seq )
+			{
+				FLOAT                 BestElapsedFrames  = 100000.0;
+				FMeshAnimNotify*      BestNotify         = NULL;
+				UMeshAnimNotifys::Ptr Notifys            = Actor->Mesh->Notifys;
+				for( int i=Seq->StartNotify; i<Seq->StartNotify+Seq->NumNotifys; i++ )
+				{
+					FMeshAnimNotify &Notify = Notifys(i);
+					if( OldAnimFrame<Notify.Time && Actor->AnimFrame>=Notify.Time )
 					{
-						// Just passed end-minus-one frame.
-						Seconds = Seconds * (Actor->AnimFrame - Actor->AnimEnd) / (Actor->AnimFrame - OldAnimFrame);
-						if( !Actor->bAnimLoop )
+						FLOAT ElapsedFrames = Notify.Time - OldAnimFrame;
+						if( BestNotify==NULL || ElapsedFrames<BestElapsedFrames )
 						{
-							// End the one-shot animation.
-							Actor->AnimFrame	 = Actor->AnimEnd;
-							Actor->bAnimFinished = 1;
-							Actor->AnimRate      = 0.0;
+							BestElapsedFrames = ElapsedFrames;
+							BestNotify        = &Notify;
 						}
-						Actor->Process( NAME_AnimEnd, NULL );
 					}
 				}
-
-				// This actor is tickable.
-				FLOAT ThisDeltaSeconds = DeltaSeconds;
-				if( Actor->TickRate>=0.0 && (Actor->TickCounter+=DeltaSeconds)>=Actor->TickRate )
+				if( BestNotify )
 				{
-					if( Actor->TickRate != 0.0 )
-					{
-						// Adjust the tick count.
-						ThisDeltaSeconds   = Actor->TickCounter;
-						Actor->TickCounter = 0;
-					}
+					Seconds          = Seconds * (Actor->AnimFrame - BestNotify->Time) / (Actor->AnimFrame - OldAnimFrame);
+					Actor->AnimFrame = BestNotify->Time;
+					Actor->Process( BestNotify->Function, NULL );
+					continue;
+				}
+			}
+		}
 
-					// Tick the actor.
-					if( Pawn && Pawn->Camera )
-					{
-						// This is a player.
-						if( !(Pawn->ShowFlags & SHOW_PlayerCtrl) )
-							goto Skip;
+		// Handle end of animation sequence.
+		if( Actor->AnimFrame<Actor->AnimEnd || (Actor->bAnimLoop && OldAnimFrame>Actor->AnimEnd && Actor->AnimFrame<1.0) )
+		{
+			// We have finished the animation updating for this tick.
+			Seconds = 0.0;
+		}
+		else if( Actor->bAnimLoop && OldAnimFrame<=1.0 && Actor->AnimFrame>1.0 )
+		{
+			// Just past end, so loop it.
+			Seconds          = Seconds * (Actor->AnimFrame - 1.0) / (Actor->AnimFrame - OldAnimFrame);
+			Actor->AnimFrame = 0.0;
+		}
+		else if( OldAnimFrame<=Actor->AnimEnd )
+		{
+			// Just passed end-minus-one frame.
+			Seconds = Seconds * (Actor->AnimFrame - Actor->AnimEnd) / (Actor->AnimFrame - OldAnimFrame);
+			if( !Actor->bAnimLoop )
+			{
+				// End the one-shot animation.
+				Actor->AnimFrame	 = Actor->AnimEnd;
+				Actor->bAnimFinished = 1;
+				Actor->AnimRate      = 0.0;
+			}
+			Actor->Process( NAME_AnimEnd, NULL );
+		}
+	}
 
-							// Camera: Add keystrokes/mouse from local input.
-						if( Actor==ActiveLocalPlayer && Pawn->Camera->Current )
-						{
-							// This player is the active local player, so we update him based
-							// on his input.
-							PPlayerTick PlayerTick( ThisDeltaSeconds );
-							Pawn->Camera->ReadInput( PlayerTick, DeltaSeconds, Pawn->Camera );
-							Pawn->inputCopyFrom( PlayerTick );
-							Actor->Process( NAME_PlayerTick, &PlayerTick );
-							GAudio.SetOrigin( &Actor->Location, &Pawn->ViewRotation );
-
-							//if (!Actor->IsProbing(NAME_PlayerTick) //then do player control here
-							//	Pawn.PlayerControl();
-						}
-						else
-						{
-							// This player is an inactive local player, so we update him
-							// with an empty movement packet.
-							PPlayerTick PlayerTick( ThisDeltaSeconds );
-							Pawn->inputCopyFrom( PlayerTick );
-							Actor->Process( NAME_PlayerTick, &PlayerTick );
+	// This actor is tickable.
+	FLOAT ThisDeltaSeconds = DeltaSeconds;
+	if( Actor->TickRate>=0.0 && (Actor->TickCounter+=DeltaSeconds)>=Actor->TickRate )
+	{
+		if( Actor->TickRate != 0.0 )
+		{
+			// Adjust the tick count.
+			ThisDeltaSeconds   = Actor->TickCounter;
+			Actor->TickCounter = 0;
+		}
 
-						}
-					}
-					else if( Pawn && 0 /* ActorIsARemoteNetworkPlayer() */ )
-					{
-						// This is a remote network player.  He may have one or more movement
-						// packets coming in from the network.  Here we should merge thim into
-						// one input packet and tick him:
-						//
-						//FetchTheRemotePlayersInputPacketsFromTheIncomingStream();
-						//RemoteMovementPacket.ThisDeltaTime = Info->GameTickRate;
-						//SendMessage(iActor,NAME_PlayerTick,RemoteMovementPacket);
-						//
-						// Sending the network player response packets containing what he sees
-						// happens elsewhere, just as rendering the local players' camera views
-						// happens elsewhere.
-					}
-					else
-					{
-						// If only updating cameras, skip nonplayers.
-						if( CamerasOnly )
-							goto Skip;
+		// Tick the actor.
+		if( Pawn && Pawn->Camera )
+		{
+			// This is a player.
+			if( !(Pawn->ShowFlags & SHOW_PlayerCtrl) )
+				return TICK_Skipped;
 
-						// Tick the nonplayer.
-						PTick Tick( ThisDeltaSeconds );
-						Actor->Process( NAME_Tick, &Tick );
-					}
+				// Camera: Add keystrokes/mouse from local input.
+			if( Actor==ActiveLocalPlayer && Pawn->Camera->Current )
+			{
+				// This player is the active local player, so we update him based
+				// on his input.
+				PPlayerTick PlayerTick( ThisDeltaSeconds );
+				Pawn->Camera->ReadInput( PlayerTick, DeltaSeconds, Pawn->Camera );
+				Pawn->inputCopyFrom( PlayerTick );
+				Actor->Process( NAME_PlayerTick, &PlayerTick );
+				GAudio.SetOrigin( &Actor->Location, &Pawn->ViewRotation );
+
+				//if (!Actor->IsProbing(NAME_PlayerTick) //then do player control here
+				//	Pawn.PlayerControl();
+			}
+			else
+			{
+				// This player is an inactive local player, so we update him
+				// with an empty movement packet.
+				PPlayerTick PlayerTick( ThisDeltaSeconds );
+				Pawn->inputCopyFrom( PlayerTick );
+				Actor->Process( NAME_PlayerTick, &PlayerTick );
 
-					// If actor destroyed itself, stop processing it.
-					if( Actor->bDeleteMe ) continue;
+			}
+		}
+		else if( Pawn && 0 /* ActorIsARemoteNetworkPlayer() */ )
+		{
+			// This is a remote network player.  He may have one or more movement
+			// packets coming in from the network.  Here we should merge thim into
+			// one input packet and tick him:
+			//
+			//FetchTheRemotePlayersInputPacketsFromTheIncomingStream();
+			//RemoteMovementPacket.ThisDeltaTime = Info->GameTickRate;
+			//SendMessage(iActor,NAME_PlayerTick,RemoteMovementPacket);
+			//
+			// Sending the network player response packets containing what he sees
+			// happens elsewhere, just as rendering the local players' camera views
+			// happens elsewhere.
+		}
+		else
+		{
+			// If only updating cameras, skip nonplayers.
+			if( CamerasOnly )
+				return TICK_Skipped;
 
-					// Update the actor's script state code.
-					guard(StateExec);
-					debugState(Actor->MainStack.Object == Actor);
+			// Tick the nonplayer.
+			PTick Tick( ThisDeltaSeconds );
+			Actor->Process( NAME_Tick, &Tick );
+		}
 
-					// Create a work area for UnrealScript.
-					BYTE Buffer[MAX_CONST_SIZE], *Addr;
-					*(FLOAT*)Buffer = ThisDeltaSeconds;
+		// If actor destroyed itself, stop processing it.
+		if( Actor->bDeleteMe )
+			return TICK_Destroyed;
 
-					// If a latent action is in progress, update it.
-					if( Actor->MainStack.Code && Actor->LatentAction )
-					{
-						(*GIntrinsics[Actor->LatentAction])( Actor->MainStack, NULL, Addr=Buffer );
-						if( Actor->bDeleteMe )
-							continue;
-					}
+		// Update the actor's script state code.
+		guard(StateExec);
+		debugState(Actor->MainStack.Object == Actor);
 
-					// Execute code.
-					while( Actor->MainStack.Code && !Actor->LatentAction )
-						(*GIntrinsics[*Actor->MainStack.Code++])( Actor->MainStack, Actor, Addr=Buffer );
-					if( Actor->bDeleteMe )
-						continue;
-					unguard;
+		// Create a work area for UnrealScript.
+		BYTE Buffer[MAX_CONST_SIZE], *Addr;
+		*(FLOAT*)Buffer = ThisDeltaSeconds;
 
-					// Update the actor's audio.
-					Actor->UpdateSound();
-				}
+		// If a latent action is in progress, update it.
+		if( Actor->MainStack.Code && Actor->LatentAction )
+		{
+			(*GIntrinsics[Actor->LatentAction])( Actor->MainStack, NULL, Addr=Buffer );
+			if( Actor->bDeleteMe )
+				return TICK_Destroyed;
+		}
 
-				// Update timers.
-				if( Actor->TimerRate>0.0 && (Actor->TimerCounter+=DeltaSeconds)>=Actor->TimerRate )
-				{
-					// Normalize the timer count.
-					int TimerTicksPassed = 1;
-					if( Actor->TimerRate > 0.0 )
-					{
-						TimerTicksPassed     = (int)(Actor->TimerCounter/Actor->TimerRate);
-						Actor->TimerCounter -= Actor->TimerRate * TimerTicksPassed;
-						if( TimerTicksPassed && !Actor->bTimerLoop )
-						{
-							// Only want a one-shot timer message.
-							TimerTicksPassed = 1;
-							Actor->TimerRate = 0.0;
-						}
-					}
+		// Execute code.
+		while( Actor->MainStack.Code && !Actor->LatentAction )
+			scriptEval( Actor->MainStack, Actor, Addr=Buffer );
+		if( Actor->bDeleteMe )
+			return TICK_Destroyed;
+		unguard;
+
+		// Update the actor's audio, at the sync point if task threads are ticking.
+		if( Deferring )
+			DeferCommand( TICKCMD_Sound, Actor );
+		else
+			Actor->UpdateSound();
+	}
+
+	// Update timers.
+	if( Actor->TimerRate>0.0 && (Actor->TimerCounter+=DeltaSeconds)>=Actor->TimerRate )
+	{
+		// Normalize the timer count.
+		int TimerTicksPassed = 1;
+		if( Actor->TimerRate > 0.0 )
+		{
+			TimerTicksPassed     = (int)(Actor->TimerCounter/Actor->TimerRate);
+			Actor->TimerCounter -= Actor->TimerRate * TimerTicksPassed;
+			if( TimerTicksPassed && !Actor->bTimerLoop )
+			{
+				// Only want a one-shot timer message.
+				TimerTicksPassed = 1;
+				Actor->TimerRate = 0.0;
+			}
+		}
 
-					// Call timer routine with count of timer events that have passed.
-					Actor->Process( NAME_Timer, NULL );
-					if( Actor->bDeleteMe )
-						continue;
-				}
+		// Call timer routine with count of timer events that have passed.
+		Actor->Process( NAME_Timer, NULL );
+		if( Actor->bDeleteMe )
+			return TICK_Destroyed;
+	}
 
-				// Update LifeSpan.
-				if( Actor->GetClass() && Actor->LifeSpan!=0.0 )
-				{
-					if( (Actor->LifeSpan -= DeltaSeconds) <= 0.0 )
-					{
-						// Actor's LifeSpan expired.
-						Actor->Process( NAME_Expired, NULL );
-						if( !Actor->bDeleteMe )
-							DestroyActor( Actor );
-						continue;
-					}
-				}
-	
-				// Perform physics.
-				// Save old location for AI purposes.
-				Actor->OldLocation = Actor->Location;
+	// Update LifeSpan.
+	if( Actor->GetClass() && Actor->LifeSpan!=0.0 )
+	{
+		if( (Actor->LifeSpan -= DeltaSeconds) <= 0.0 )
+		{
+			// Actor's LifeSpan expired.
+			Actor->Process( NAME_Expired, NULL );
+			if( !Actor->bDeleteMe )
+				DestroyActor( Actor );
+			return TICK_Destroyed;
+		}
+	}
 
-				if ( Actor->Physics!=PHYS_None )
-					Actor->performPhysics(DeltaSeconds);
+	// Perform physics.
+	// Save old location for AI purposes.
+	Actor->OldLocation = Actor->Location;
 
-				// update eyeheight and send visibility updates
-				// with PVS, monsters look for other monsters, rather than sending msgs
-				if (Pawn)
-				{
-					if (Pawn->SightCounter < 0.0)
-						Pawn->SightCounter = 0.2; //FIXME - make as big as possible 
-					Pawn->SightCounter = Pawn->SightCounter - DeltaSeconds; 
-					if (Pawn->bIsPlayer)
-					{
-						Actor->Process( NAME_UpdateEyeHeight, &PFloat(DeltaSeconds) );
-						Pawn->ShowSelf();
-					}
-					else if ((Pawn->SightCounter < 0.0) && (frand() < 0.1))
-					//monsters should showself to each other occasionally (every 2 sec)
-						Pawn->ShowSelf();
+	if ( Actor->Physics!=PHYS_None )
+		Actor->performPhysics(DeltaSeconds);
 
-					if ((Pawn->SightCounter < 0.0) && Pawn->IsProbing(NAME_EnemyNotVisible))
-						Pawn->CheckEnemyVisible();
-				}
+	// update eyeheight and send visibility updates
+	// with PVS, monsters look for other monsters, rather than sending msgs
+	if (Pawn)
+	{
+		if (Pawn->SightCounter < 0.0)
+			Pawn->SightCounter = 0.2; //FIXME - make as big as possible 
+		Pawn->SightCounter = Pawn->SightCounter - DeltaSeconds; 
+		if (Pawn->bIsPlayer)
+		{
+			Actor->Process( NAME_UpdateEyeHeight, &PFloat(DeltaSeconds) );
+			Pawn->ShowSelf();
+		}
+		else if ((Pawn->SightCounter < 0.0) && (frand() < 0.1))
+		//monsters should showself to each other occasionally (every 2 sec)
+			Pawn->ShowSelf();
+
+		if ((Pawn->SightCounter < 0.0) && Pawn->IsProbing(NAME_EnemyNotVisible))
+			Pawn->CheckEnemyVisible();
+	}
+	return TICK_Updated;
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	Parallel ticking.
+-----------------------------------------------------------------------------*/
+
+//
+// An actor in the owner forest built by TickParallel. Self-contained
+// actors only change themselves, their owners and the actors they own, so
+// each tree of such actors can be ticked on a different task thread.
+//
+struct FTickNode
+{
+	AActor	*Actor;				// The actor.
+	INT		iFirstChild;		// First actor it owns, or INDEX_NONE.
+	INT		iNextSibling;		// Next actor with the same owner, or INDEX_NONE.
+};
+
+//
+// Whether an actor is self-contained: Neither its class's script nor any
+// script it inherits reaches outside its owner tree, so it only calls
+// intrinsics which change itself, like GotoState or SetTimer, can't spawn,
+// and can't read or change other actors, and it doesn't collide with
+// actors, so it can't touch or bump them.
+//
+static INT IsSelfContained( AActor *Actor )
+{
+	guard(IsSelfContained);
+	if( Actor->bCollideActors )
+		return 0;
+	for( UClass *Class=Actor->GetClass(); Class; Class=Class->ParentClass )
+		if( Class->Script && Class->Script->ReachesOtherObjects() )
+			return 0;
+	return 1;
+	unguard;
+}
 
-                Actor->bTicked = Ticked;
-				NumUpdated++;
+//
+// Whether every actor in a tree of the owner forest is self-contained.
+//
+static INT IsTreeSelfContained( FTickNode *Nodes, INT iNode )
+{
+	if( !IsSelfContained(Nodes[iNode].Actor) )
+		return 0;
+	for( INT iChild=Nodes[iNode].iFirstChild; iChild!=INDEX_NONE; iChild=Nodes[iChild].iNextSibling )
+		if( !IsTreeSelfContained( Nodes, iChild ) )
+			return 0;
+	return 1;
+}
+
+//
+// Actor-to-node lookup entry, sorted by actor.
+//
+struct FTickNodeRef
+{
+	AActor	*Actor;
+	INT		iNode;
+};
+inline int Compare( const FTickNodeRef &A, const FTickNodeRef &B )
+{
+	return A.Actor<B.Actor ? -1 : A.Actor>B.Actor ? 1 : 0;
+}
+
+//
+// Everything the task threads need to tick the forest.
+//
+struct FParallelTick
+{
+	ULevel		*Level;
+	FTickNode	*Nodes;
+	INT			*Roots;
+	AActor		*ActiveLocalPlayer;
+	FLOAT		DeltaSeconds;
+	DWORD		Ticked;
+};
+
+// Commands deferred by each task thread, and their global order.
+static TTaskBuffer<FTickCommand> GTickCommands[FTaskPool::MAX_TASK_THREADS];
+static INT GTickSequence = 0;
+
+//
+// Compare deferred commands so that they replay in actor order, and in
+// the order they were issued for each actor.
+//
+inline int Compare( const FTickCommand &A, const FTickCommand &B )
+{
+	INT Diff = A.Actor->GetIndex() - B.Actor->GetIndex();
+	return Diff ? Diff : A.Sequence - B.Sequence;
+}
+
+//
+// Find an actor's node, or return INDEX_NONE if it isn't being ticked.
+//
+static INT FindTickNode( FTickNodeRef *Refs, INT Num, AActor *Actor )
+{
+	INT Min=0, Max=Num;
+	while( Min < Max )
+	{
+		INT Mid = (Min+Max)/2;
+		if( Refs[Mid].Actor < Actor )
+			Min = Mid+1;
+		else
+			Max = Mid;
+	}
+	return (Min<Num && Refs[Min].Actor==Actor) ? Refs[Min].iNode : INDEX_NONE;
+}
+
+//
+// Tick an actor, and if that succeeds, all of the actors it owns.
+//
+static void TickSubtree( FParallelTick &Tick, INT iNode )
+{
+	guard(TickSubtree);
+	FTickNode &Node = Tick.Nodes[iNode];
+	if( !Node.Actor->bDeleteMe )
+	{
+		if( Tick.Level->TickActor( Node.Actor, 0, Tick.ActiveLocalPlayer, Tick.DeltaSeconds ) == TICK_Updated )
+		{
+			Node.Actor->bTicked = Tick.Ticked;
+			for( INT iChild=Node.iFirstChild; iChild!=INDEX_NONE; iChild=Tick.Nodes[iChild].iNextSibling )
+				TickSubtree( Tick, iChild );
+		}
+	}
+	unguard;
+}
+
+//
+// Task function: Tick one tree of the owner forest.
+//
+static void TickTreeTask( void *Arg, INT iTask, INT iThread )
+{
+	FParallelTick &Tick = *(FParallelTick*)Arg;
+	TickSubtree( Tick, Tick.Roots[iTask] );
+}
+
+//
+// Defer a level change made by a task thread until the sync point at the end
+// of the parallel tick.
+//
+void ULevel::DeferCommand( ETickCommand Type, AActor *Actor )
+{
+	guard(ULevel::DeferCommand);
+	checkState(Deferring);
+
+	FTickCommand &Command = GTickCommands[appTaskThread()].Add();
+	Command.Actor    = Actor;
+	Command.Sequence = appInterlockedAdd( &GTickSequence, 1 );
+	Command.Type     = Type;
+
+	unguard;
+}
+
+//
+// Tick all actors which haven't been ticked yet, spreading the independent
+// trees of self-contained actors across all task threads. Changes which
+// other actors could see mid-tick, like collision hash updates and
+// destruction, are deferred and replayed in actor order at the sync point,
+// so collision checks see where actors were at the start of the tick.
+// Trees with any actor that could change other actors, then players and the
+// actors they own, are ticked afterwards on this thread, as in the serial
+// tick.
+//
+void ULevel::TickParallel( AActor *ActiveLocalPlayer, FLOAT DeltaSeconds, DWORD Ticked )
+{
+	guard(ULevel::TickParallel);
+	FMemMark Mark(GMem);
+	DWORD NotTicked = !Ticked;
+
+	// Gather the actors to tick.
+	FTickNode    *Nodes    = new(GMem,Num)FTickNode;
+	FTickNodeRef *Refs     = new(GMem,Num)FTickNodeRef;
+	INT          NumNodes  = 0;
+	for( INDEX iActor=0; iActor<Num; iActor++ )
+	{
+		AActor *Actor = Element(iActor);
+		if
+		(	Actor
+		&& !Actor->bStatic
+		&& !Actor->bDeleteMe
+		&& Actor->bTicked==NotTicked )
+		{
+			Nodes[NumNodes].Actor        = Actor;
+			Nodes[NumNodes].iFirstChild  = INDEX_NONE;
+			Nodes[NumNodes].iNextSibling = INDEX_NONE;
+			Refs [NumNodes].Actor        = Actor;
+			Refs [NumNodes].iNode        = NumNodes;
+			NumNodes++;
+		}
+	}
+	QSort( Refs, NumNodes );
+
+	// Sort them into the owner forest. Linking in reverse keeps each actor's
+	// children in actor order. Players are left out for now.
+	INT *Owners = new(GMem,NumNodes)INT;
+	for( INT i=NumNodes-1; i>=0; i-- )
+	{
+		AActor *Actor = Nodes[i].Actor;
+		APawn  *Pawn  = Actor->IsA("Pawn") ? (APawn*)Actor : NULL;
+		Owners[i]     = Actor->Owner ? FindTickNode( Refs, NumNodes, Actor->Owner ) : INDEX_NONE;
+		if( Owners[i]!=INDEX_NONE && !(Pawn && Pawn->Camera) )
+		{
+			Nodes[i].iNextSibling         = Nodes[Owners[i]].iFirstChild;
+			Nodes[Owners[i]].iFirstChild  = i;
+		}
+	}
+
+	// Find the roots: Actors with no owner, or whose owner was already ticked.
+	// Actors whose owner won't be ticked this time are skipped, as in the
+	// serial tick. Trees which aren't self-contained are ticked serially.
+	INT *Roots   = new(GMem,NumNodes)INT, NumRoots=0;
+	INT *Serial  = new(GMem,NumNodes)INT, NumSerial=0;
+	INT *Players = new(GMem,NumNodes)INT, NumPlayers=0;
+	for( i=0; i<NumNodes; i++ )
+	{
+		AActor *Actor = Nodes[i].Actor;
+		APawn  *Pawn  = Actor->IsA("Pawn") ? (APawn*)Actor : NULL;
+		if( Pawn && Pawn->Camera )
+			Players[NumPlayers++] = i;
+		else if( Owners[i]==INDEX_NONE && (!Actor->Owner || Actor->Owner->bTicked==Ticked) )
+		{
+			if( IsTreeSelfContained( Nodes, i ) )
+				Roots[NumRoots++] = i;
+			else
+				Serial[NumSerial++] = i;
+		}
+	}
+
+	// Tick the trees on all task threads.
+	FParallelTick Tick;
+	Tick.Level             = this;
+	Tick.Nodes             = Nodes;
+	Tick.Roots             = Roots;
+	Tick.ActiveLocalPlayer = ActiveLocalPlayer;
+	Tick.DeltaSeconds      = DeltaSeconds;
+	Tick.Ticked            = Ticked;
+	for( i=0; i<FTaskPool::MAX_TASK_THREADS; i++ )
+		GTickCommands[i].Empty();
+	Hash.BeginDeferred();
+	Deferring = 1;
+	GTaskPool.Run( TickTreeTask, &Tick, NumRoots );
+	Deferring = 0;
+
+	// Sync point: Apply the collision hash changes, then replay the deferred
+	// commands in actor order.
+	Hash.EndDeferred();
+	INT NumCommands = 0;
+	for( i=0; i<FTaskPool::MAX_TASK_THREADS; i++ )
+		NumCommands += GTickCommands[i].Num;
+	FTickCommand *Commands = new(GMem,NumCommands)FTickCommand;
+	for( NumCommands=i=0; i<FTaskPool::MAX_TASK_THREADS; i++ )
+	{
+		memcpy( Commands+NumCommands, GTickCommands[i].Data, GTickCommands[i].Num*sizeof(FTickCommand) );
+		NumCommands += GTickCommands[i].Num;
+	}
+	QSort( Commands, NumCommands );
+	for( i=0; i<NumCommands; i++ )
+	{
+		AActor *Actor = Commands[i].Actor;
+		if( Commands[i].Type == TICKCMD_Destroy )
+		{
+			// The actor was only flagged for deletion.
+			Actor->bDeleteMe = 0;
+			DestroyActor( Actor );
+		}
+		else if( Commands[i].Type==TICKCMD_Sound && !Actor->bDeleteMe )
+		{
+			Actor->UpdateSound();
+		}
+	}
+
+	// Tick the trees which could change other actors, then the players and
+	// everything they own.
+	for( i=0; i<NumSerial; i++ )
+		TickSubtree( Tick, Serial[i] );
+	for( i=0; i<NumPlayers; i++ )
+		TickSubtree( Tick, Players[i] );
+
+	Mark.Pop();
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	Parallel tick testing.
+-----------------------------------------------------------------------------*/
+
+//
+// Saved state of all actors in a level.
+//
+struct FActorSnapshot
+{
+	INT		Num;			// Number of actor slots.
+	AActor	**Actors;		// Actor in each slot.
+	BYTE	**Bins;			// Copy of each actor's per-object properties.
+};
+
+//
+// Size of an actor's per-object properties, excluding the UObject header.
+//
+static INT ActorBinSize( AActor *Actor )
+{
+	return Actor->GetClass()->Bins[PROPBIN_PerObject]->Num - sizeof(UObject);
+}
+
+//
+// Compute a checksum of an actor's saved properties. Engine-internal transient
+// properties are skipped, and objects are identified by class, since actors
+// spawned during the test differ from run to run.
+//
+static DWORD ActorCrc( AActor *Actor )
+{
+	guard(ActorCrc);
+	DWORD Crc = Actor->bDeleteMe;
+	for( FPropertyIterator It(Actor->GetClass()); It; ++It )
+	{
+		FProperty &Property = It();
+		if( Property.Bin!=PROPBIN_PerObject || (Property.Flags & CPF_Transient) )
+			continue;
+		for( INT i=0; i<Property.ArrayDim; i++ )
+		{
+			BYTE  *Ptr = (BYTE*)Actor->ObjectPropertyPtr( Property, i );
+			DWORD Value;
+			if( Property.Type == CPT_Bool )
+			{
+				Value = (*(DWORD*)Ptr & Property.BitMask) != 0;
+			}
+			else if( Property.Type == CPT_Object )
+			{
+				UObject *Object = *(UObject**)Ptr;
+				Value = Object ? Object->GetClass()->GetIndex() : INDEX_NONE;
+			}
+			else if( Property.Type == CPT_String )
+			{
+				Value = memcrc( Ptr, strlen((char*)Ptr) );
 			}
 			else
 			{
-				// Skip this actor.
-				Skip:
-				NumSkipped++;
+				Value = memcrc( Ptr, Property.ElementSize );
 			}
+			Crc = ((Crc << 1) | (Crc >> 31)) ^ Value;
 		}
-		NumIter++;
-	} while( NumUpdated && NumSkipped );
+	}
+	return Crc;
+	unguard;
+}
 
-	unclock(GServer.ActorTickTime);
+//
+// Put a level's actors back the way they were when the snapshot was taken,
+// killing any actors spawned since then.
+//
+static void RestoreActors( ULevel *Level, FActorSnapshot &Snapshot )
+{
+	guard(RestoreActors);
+	FMemMark Mark(GMem);
+	Level->Lock( LOCK_ReadWrite );
+
+	// Take the actors destroyed since the snapshot off the deleted chain,
+	// before restoring properties overwrites the chain.
+	INT NumDead=0;
+	for( AActor *Dead=Level->FirstDeleted; Dead; Dead=Dead->Deleted )
+		NumDead++;
+	AActor **DeadActors = new(GMem,NumDead)AActor*;
+	for( NumDead=0, Dead=Level->FirstDeleted; Dead; Dead=Dead->Deleted )
+		DeadActors[NumDead++] = Dead;
+	Level->FirstDeleted = NULL;
+
+	// Chain up the spawned actors which are still alive.
+	for( INT i=0; i<Level->Num; i++ )
+	{
+		AActor *Actor = Level->Element(i);
+		if( Actor && (i>=Snapshot.Num || Actor!=Snapshot.Actors[i]) )
+		{
+			Level->Element(i)   = NULL;
+			Actor->bDeleteMe    = 1;
+			Actor->Deleted      = Level->FirstDeleted;
+			Level->FirstDeleted = Actor;
+		}
+	}
 
-	// Unlock everything.
-	SkipUpdate:
-	Unlock(LOCK_ReadWrite);
+	// Restore the original actors.
+	for( i=0; i<Snapshot.Num; i++ )
+	{
+		AActor *Actor = Level->Element(i) = Snapshot.Actors[i];
+		if( Actor )
+			memcpy( (BYTE*)Actor + sizeof(UObject), Snapshot.Bins[i], ActorBinSize(Actor) );
+	}
+	Level->Num = Snapshot.Num;
+
+	// Chain up the spawned actors which were destroyed.
+	for( i=0; i<NumDead; i++ )
+	{
+		for( INT j=0; j<Snapshot.Num; j++ )
+			if( Snapshot.Actors[j] == DeadActors[i] )
+				break;
+		if( j == Snapshot.Num )
+		{
+			DeadActors[i]->Deleted = Level->FirstDeleted;
+			Level->FirstDeleted    = DeadActors[i];
+		}
+	}
+
+	// Kill the spawned actors and rebuild the collision hash.
+	Level->KeepDestroyed = 0;
+	Level->Unlock( LOCK_ReadWrite );
+	Level->KeepDestroyed = 1;
+	Level->Hash.Exit();
+	Level->InitCollision();
 
 	Mark.Pop();
-	unclock(GServer.LevelTickTime);
+	unguard;
+}
+
+//
+// Tick the level a number of times both serially and in parallel, starting
+// from the same state, and report which actors ended up differently. Since
+// random numbers are drawn in a different order, some differences are
+// expected; this is for finding actor classes which aren't safe to tick in
+// parallel.
+//
+void ULevel::TestParallelTick( INT Ticks, FOutputDevice *Out )
+{
+	guard(ULevel::TestParallelTick);
+	if( GetState() != LEVEL_UpPlay )
+	{
+		Out->Log( LOG_ExecError, "Parallel tick test requires a level being played" );
+		return;
+	}
+	BOOL OldParallelTick = ParallelTick;
+
+	// Save the state of all actors.
+	FActorSnapshot Snapshot;
+	Snapshot.Num    = Num;
+	Snapshot.Actors = (AActor**)appMalloc( Num * sizeof(AActor*), "ActorSnapshot" );
+	Snapshot.Bins   = (BYTE  **)appMalloc( Num * sizeof(BYTE  *), "ActorSnapshot" );
+	DWORD *SerialCrc = (DWORD *)appMalloc( Num * sizeof(DWORD  ), "ActorSnapshot" );
+	for( INT i=0; i<Num; i++ )
+	{
+		AActor *Actor     = Snapshot.Actors[i] = Element(i);
+		Snapshot.Bins[i]  = NULL;
+		if( Actor )
+		{
+			Snapshot.Bins[i] = (BYTE*)appMalloc( ActorBinSize(Actor), "ActorSnapshot" );
+			memcpy( Snapshot.Bins[i], (BYTE*)Actor + sizeof(UObject), ActorBinSize(Actor) );
+		}
+	}
+
+	// Tick serially, keeping destroyed actors around for comparison.
+	KeepDestroyed = 1;
+	ParallelTick  = 0;
+	for( i=0; i<Ticks; i++ )
+		Tick( 0, NULL, 1.0/35.0 );
+	for( i=0; i<Snapshot.Num; i++ )
+		if( Snapshot.Actors[i] )
+			SerialCrc[i] = ActorCrc( Snapshot.Actors[i] );
+	INT SerialNum = Num;
+	RestoreActors( this, Snapshot );
+
+	// Tick in parallel and compare.
+	ParallelTick = 1;
+	for( i=0; i<Ticks; i++ )
+		Tick( 0, NULL, 1.0/35.0 );
+	INT Compared=0, Differed=0;
+	for( i=0; i<Snapshot.Num; i++ )
+	{
+		AActor *Actor = Snapshot.Actors[i];
+		if( Actor )
+		{
+			Compared++;
+			if( ActorCrc(Actor) != SerialCrc[i] )
+			{
+				if( ++Differed <= 16 )
+					Out->Logf( "   %s %s differs", Actor->GetClassName(), Actor->GetName() );
+			}
+		}
+	}
+	Out->Logf
+	(
+		"Parallel tick test: %i tick(s) on %i thread(s), %i actor(s) compared, %i differ, %i/%i slots serial/parallel",
+		Ticks, GTaskPool.NumThreads, Compared, Differed, SerialNum, Num
+	);
+
+	// Put everything back the way it was.
+	RestoreActors( this, Snapshot );
+	KeepDestroyed = 0;
+	ParallelTick  = OldParallelTick;
+	for( i=0; i<Snapshot.Num; i++ )
+		if( Snapshot.Bins[i] )
+			appFree( Snapshot.Bins[i] );
+	appFree( Snapshot.Actors );
+	appFree( Snapshot.Bins );
+	appFree( SerialCrc );
+
 	unguard;
 }
 
@@ -138,7 +138,8 @@ INT ULevel::Lock(DWORD NewLockType)
 
 	// Init deleted chain.
 	guard(3);
-	FirstDeleted = NULL;
+	if( !KeepDestroyed )
+		FirstDeleted = NULL;
 	unguard;
 
 	guard(4);
@@ -175,7 +176,8 @@ void ULevel::Unlock(DWORD OldLockType)
 
 	// Clean up deleted actors.
 	guard(1);
-	CleanupDestroyed();
+	if( !KeepDestroyed )
+		CleanupDestroyed();
 	unguard;
 
 	// Unlock stuff.
@@ -737,6 +739,56 @@ int ULevel::Exec(const char *Cmd,FOutputDevice *Out)
 			Results->Logf("Success: Level validation succeeded!\r\n");
 			return 1;
 		}
+		else if( GetCMD(&Str,"HASH") )
+		{
+			if( GetCMD(&Str,"BENCH") )
+			{
+				// Compare the collision hash buckets and grid.
+				INT Actors=5000; GetINT(Str,"ACTORS=",&Actors);
+				INT Ticks=100;   GetINT(Str,"TICKS=",&Ticks);
+				FCollisionHash::Bench( Max(Actors,1), Max(Ticks,1), Out );
+				return 1;
+			}
+			else if( GetCMD(&Str,"GRID") )
+			{
+				// Switch between the collision hash buckets and grid.
+				if     ( GetCMD(&Str,"ON")  ) GDefaults.CollisionGrid = 1;
+				else if( GetCMD(&Str,"OFF") ) GDefaults.CollisionGrid = 0;
+				else                          GDefaults.CollisionGrid ^= 1;
+				if( Hash.CollisionInitialized )
+				{
+					Hash.Exit();
+					InitCollision();
+				}
+				Out->Log( GDefaults.CollisionGrid ? "Collision grid enabled" : "Collision grid disabled" );
+				return 1;
+			}
+			else return 0;
+		}
+		else if( GetCMD(&Str,"TRACEBATCH") )
+		{
+			// Compare batched line checks against single ones.
+			INT Rays=1000; GetINT(Str,"RAYS=",&Rays);
+			Model->TestLineCheckBatch( Max(Rays,1), 0, Out );
+			return 1;
+		}
+		else if( GetCMD(&Str,"PARALLEL") )
+		{
+			if( GetCMD(&Str,"TEST") )
+			{
+				// Compare parallel ticking against serial ticking.
+				INT Ticks=35; GetINT(Str,"TICKS=",&Ticks);
+				TestParallelTick( Ticks, Out );
+				return 1;
+			}
+
+			// Switch between parallel and serial ticking.
+			if     ( GetCMD(&Str,"ON")  ) ParallelTick = 1;
+			else if( GetCMD(&Str,"OFF") ) ParallelTick = 0;
+			else                          ParallelTick ^= 1;
+			Out->Logf( ParallelTick ? "Parallel ticking enabled on %i thread(s)" : "Parallel ticking disabled", GTaskPool.NumThreads );
+			return 1;
+		}
 		else
 		{
 			return 0;
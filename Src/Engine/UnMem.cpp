@@ -23,6 +23,11 @@ Subsystem relationships:
 	memory into large, LRU-purged chunks.  This enables almost all memory allocated in
 	Unreal to be allocated from one place, and enables everything to be cached together.
 
+	The memory stacks of task threads instead take chunks from GChunkPool, which
+	hands out fixed-size chunks of its own memory without locking, so that tasks
+	don't contend for the cache. Each stack keeps high water marks of its chunk
+	usage, reported by MEM STACKS, for sizing the pool.
+
 	Callers use FMemMark objects to mark the current position of their FMemStack, and
 	use its Pop() function to restore the state of the FMemStack.
 
@@ -60,23 +65,170 @@ Revision history:
 -----------------------------------------------------------------------------*/
 
 BYTE FMemStack::InstanceCount = 0;
+FMemStack *FMemStack::FirstStack = NULL;
+
+/*-----------------------------------------------------------------------------
+	FMemChunkPool implementation.
+-----------------------------------------------------------------------------*/
+
+//
+// Take a chunk of at least MinSize bytes from the pool. Safe to call
+// from any task thread.
+//
+FMemChunkPool::FPoolChunk *FMemChunkPool::Alloc( INT MinSize )
+{
+	guard(FMemChunkPool::Alloc);
+
+	// Find the size class.
+	INT Class = 0;
+	while( (MIN_CHUNK_SIZE << Class) < MinSize )
+		if( ++Class >= NUM_CHUNK_CLASSES )
+			appErrorf( "Memory stack chunk of %i bytes is too large for the pool", MinSize );
+	INT Size = MIN_CHUNK_SIZE << Class;
+
+	// Pop a free chunk of this class.
+	FPoolChunk *Chunk = NULL;
+	for( ;; )
+	{
+		INT Old   = FreeHeads[Class];
+		INT Index = (Old & 0xFFFF) - 1;
+		if( Index < 0 )
+			break;
+		INT New   = ((Old + 0x10000) & 0xFFFF0000) + (Chunks[Index].Next + 1);
+		if( appInterlockedCompareExchange( &FreeHeads[Class], New, Old ) == Old )
+		{
+			Chunk = &Chunks[Index];
+			break;
+		}
+	}
+
+	// The class is empty, so make a new chunk.
+	if( !Chunk )
+	{
+		INT Index = appInterlockedAdd( &NumChunks, 1 );
+		checkState( Index < MAX_POOL_CHUNKS );
+		Chunk = &Chunks[Index];
+		if( GTaskPool.Running )
+			GTaskPool.AllocLock.Lock();
+		Chunk->Data = (BYTE *)appMalloc( Size, "MemStackChunk" );
+		if( GTaskPool.Running )
+			GTaskPool.AllocLock.Unlock();
+		Chunk->Size = Size;
+		Chunk->Next = INDEX_NONE;
+		appInterlockedAdd( &BytesTotal, Size );
+	}
+
+	// Update the high water mark.
+	INT InUse = appInterlockedAdd( &BytesInUse, Size ) + Size;
+	for( INT Peak=BytesPeak; InUse>Peak; Peak=BytesPeak )
+		if( appInterlockedCompareExchange( &BytesPeak, InUse, Peak ) == Peak )
+			break;
+
+	return Chunk;
+	unguard;
+}
+
+//
+// Return a chunk to the pool. Safe to call from any task thread.
+//
+void FMemChunkPool::Free( FPoolChunk *Chunk )
+{
+	guard(FMemChunkPool::Free);
+
+	INT Class = 0;
+	while( (MIN_CHUNK_SIZE << Class) < Chunk->Size )
+		Class++;
+	INT Index = Chunk - Chunks;
+	for( ;; )
+	{
+		INT Old     = FreeHeads[Class];
+		Chunk->Next = (Old & 0xFFFF) - 1;
+		INT New     = ((Old + 0x10000) & 0xFFFF0000) + (Index + 1);
+		if( appInterlockedCompareExchange( &FreeHeads[Class], New, Old ) == Old )
+			break;
+	}
+	appInterlockedAdd( &BytesInUse, -Chunk->Size );
+
+	unguard;
+}
+
+//
+// Free all chunks. They must all have been returned.
+//
+void FMemChunkPool::Exit()
+{
+	guard(FMemChunkPool::Exit);
+	checkState( BytesInUse == 0 );
+
+	for( INT i=0; i<NumChunks; i++ )
+		appFree( Chunks[i].Data );
+	for( i=0; i<NUM_CHUNK_CLASSES; i++ )
+		FreeHeads[i] = 0;
+	NumChunks = BytesTotal = BytesPeak = 0;
+
+	unguard;
+}
+
+//
+// Report the pool's size and usage.
+//
+void FMemChunkPool::Status( FOutputDevice *Out )
+{
+	guard(FMemChunkPool::Status);
+	Out->Logf
+	(
+		"Chunk pool: %i chunks, %iK total, %iK in use, %iK peak",
+		NumChunks,
+		BytesTotal/1024,
+		BytesInUse/1024,
+		BytesPeak/1024
+	);
+	unguard;
+}
 
 /*-----------------------------------------------------------------------------
 	FMemStack implementation.
 -----------------------------------------------------------------------------*/
 
 //
-// Initialize this memory stack.
+// Initialize this memory stack to take chunks from a memory cache.
 //
-void FMemStack::Init(FMemCache &InCache, int InMinChunkSize, int InMaxChunkSize)
+void FMemStack::Init(FMemCache &InCache, int InMinChunkSize, int InMaxChunkSize, const char *InName)
 {
-	guard(FMemStack::AllocateStack);
+	guard(FMemStack::Init);
+
+	GCache = &InCache;
+	Pool   = NULL;
+	InitStack( InMinChunkSize, InMaxChunkSize, InName );
+
+	unguard;
+}
+
+//
+// Initialize this memory stack to take chunks from a chunk pool.
+//
+void FMemStack::Init(FMemChunkPool &InPool, int InMinChunkSize, int InMaxChunkSize, const char *InName)
+{
+	guard(FMemStack::Init);
+
+	GCache = NULL;
+	Pool   = &InPool;
+	InitStack( InMinChunkSize, InMaxChunkSize, InName );
+
+	unguard;
+}
+
+//
+// Init the variables common to both kinds of stack.
+//
+void FMemStack::InitStack(int InMinChunkSize, int InMaxChunkSize, const char *InName)
+{
+	guard(FMemStack::InitStack);
 
 	// Create a unique instance number for cache identity.
 	Instance = InstanceCount++;
 
 	// Init variables.
-	GCache			= &InCache;
 	MinChunkSize	= InMinChunkSize - DEFAULT_ALIGNMENT;
 	MaxChunkSize	= InMaxChunkSize - DEFAULT_ALIGNMENT;
 
@@ -86,6 +238,15 @@ void FMemStack::Init(FMemCache &InCache, int InMinChunkSize, int InMaxChunkSize)
 	End				= NULL;
 	Top				= NULL;
 
+	// Init high water marks, and add to the list of stacks.
+	mystrncpy( Name, InName, ARRAY_COUNT(Name) );
+	ChunkBytes		= 0;
+	PeakChunks		= 0;
+	PeakBytes		= 0;
+	NumAllocs		= 0;
+	NextStack		= FirstStack;
+	FirstStack		= this;
+
 	unguard;
 }
 
@@ -109,6 +270,16 @@ void FMemStack::Exit()
 {
 	guard(FMemStack::FreeStack);
 	Tick();
+
+	// Remove from the list of stacks.
+	for( FMemStack **Link=&FirstStack; *Link; Link=&(*Link)->NextStack )
+	{
+		if( *Link == this )
+		{
+			*Link = NextStack;
+			break;
+		}
+	}
 	unguard;
 }
 
@@ -123,16 +294,46 @@ int FMemStack::GetByteCount()
 
 	// Count all bytes in all fully exausted chunks.
 	for( int i=0; i<ActiveChunks-1; i++ )
-		Count += Chunks[i]->GetSize();
+		Count += Pool ? PoolChunks[i]->Size : Chunks[i]->GetSize();
 
 	// Count the used bytes in the last, partially-used chunk.
 	if( ActiveChunks > 0 )
-		Count += Top - Chunks[ActiveChunks-1]->GetData();
+		Count += Top - (Pool ? PoolChunks[ActiveChunks-1]->Data : Chunks[ActiveChunks-1]->GetData());
 
 	return Count;
 	unguard;
 }
 
+//
+// Report the chunk high water marks of all memory stacks, and
+// optionally reset them.
+//
+void FMemStack::Status( FOutputDevice *Out, INT Reset )
+{
+	guard(FMemStack::Status);
+	for( FMemStack *Stack=FirstStack; Stack; Stack=Stack->NextStack )
+	{
+		Out->Logf
+		(
+			"%-12s %s: %iK in %i chunks now, peak %iK in %i chunks, %i chunk allocations",
+			Stack->Name,
+			Stack->Pool ? "pool " : "cache",
+			Stack->ChunkBytes/1024,
+			Stack->ActiveChunks,
+			Stack->PeakBytes/1024,
+			Stack->PeakChunks,
+			Stack->NumAllocs
+		);
+		if( Reset )
+		{
+			Stack->PeakBytes  = Stack->ChunkBytes;
+			Stack->PeakChunks = Stack->ActiveChunks;
+			Stack->NumAllocs  = 0;
+		}
+	}
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	Chunk functions.
 -----------------------------------------------------------------------------*/
@@ -150,6 +351,21 @@ BYTE *FMemStack::AllocateNewChunk( int MinSize, int Align )
 	checkInput( (Align & (Align-1)) == 0 );
 	checkState( ActiveChunks < MAX_CHUNKS );
 
+	// Take a chunk from the pool if we have one.
+	if( Pool )
+	{
+		FMemChunkPool::FPoolChunk *Chunk = Pool->Alloc( Max(MinSize, MinChunkSize) + Align );
+		PoolChunks[ActiveChunks++] = Chunk;
+		Top = (BYTE *)(((int)Chunk->Data+(Align-1))&~(Align-1));
+		End = Chunk->Data + Chunk->Size - Align;
+		NoteChunk( Chunk->Size );
+		return Top;
+	}
+
+	// Task threads share the cache, so they take turns.
+	if( GTaskPool.Running )
+		GTaskPool.AllocLock.Lock();
+
 	// Make cache id which is guaranteed unique for this chunk.
 	DWORD CacheID     = MakeCacheID(CID_MemStackChunk,ActiveChunks,Instance);
 	FCacheItem *&Item = Chunks[ActiveChunks++];
@@ -178,6 +394,9 @@ BYTE *FMemStack::AllocateNewChunk( int MinSize, int Align )
 
 	// Compute chunk end, accounting for worst-case alignment padding.
 	End = Top + Item->GetSize() - Align;
+	NoteChunk( Item->GetSize() );
+	if( GTaskPool.Running )
+		GTaskPool.AllocLock.Unlock();
 
 	// Output checks.
 	debugOutput( ((int)Top & (Align-1))==0 );
@@ -187,6 +406,37 @@ BYTE *FMemStack::AllocateNewChunk( int MinSize, int Align )
 	unguard;
 }
 
+//
+// Release the most recently allocated chunk.
+//
+void FMemStack::ReleaseChunk()
+{
+	guard(FMemStack::ReleaseChunk);
+	ActiveChunks--;
+	if( Pool )
+	{
+		ChunkBytes -= PoolChunks[ActiveChunks]->Size;
+		Pool->Free( PoolChunks[ActiveChunks] );
+	}
+	else
+	{
+		ChunkBytes -= Chunks[ActiveChunks]->GetSize();
+		Chunks[ActiveChunks]->Unlock();
+	}
+	unguard;
+}
+
+//
+// Update the high water marks for a newly allocated chunk.
+//
+void FMemStack::NoteChunk( INT Size )
+{
+	ChunkBytes += Size;
+	NumAllocs++;
+	PeakChunks  = Max( PeakChunks, ActiveChunks );
+	PeakBytes   = Max( PeakBytes,  ChunkBytes   );
+}
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
@@ -160,12 +160,319 @@ INT UMesh::LineCheck
 	unguard;
 }
 
+/*-----------------------------------------------------------------------------
+	UMesh keyframe streams.
+-----------------------------------------------------------------------------*/
+
+//
+// Header of a mesh stream in the cache. Streams are found by a hash of
+// their mesh and key, so the header says which stream is really there.
+//
+struct FMeshStreamHeader
+{
+	UMesh*	Mesh;		// Mesh the stream belongs to.
+	INT		Key;		// Keyframe, or keyframes and blend bucket.
+	FVector	Scale;		// Mesh scale when the stream was built.
+	INT		Pad[3];		// Keeps the streams aligned.
+};
+
+//
+// Lock a mesh stream of Size bytes in the cache, creating it if it isn't
+// there. Returns 1 if it was found, or 0 if the caller must fill it in.
+//
+static INT LockMeshStream( DWORD Base, UMesh *Mesh, INT Key, INT Size, FLOAT *&Data, FCacheItem *&Item )
+{
+	guardSlow(LockMeshStream);
+	DWORD CacheID = Base + (((DWORD)Mesh->GetIndex()*0x9E3779B1 + (DWORD)Key*0x85EBCA6B) >> 8);
+	FMeshStreamHeader *Header = (FMeshStreamHeader*)GCache.Get( CacheID, Item );
+	if( Header && (Header->Mesh!=Mesh || Header->Key!=Key || Header->Scale!=Mesh->Scale) )
+	{
+		// Another stream with the same hash, or an out of date one.
+		Item->Unlock();
+		GCache.Flush( CacheID );
+		Header = NULL;
+	}
+	if( Header )
+	{
+		Data = (FLOAT*)(Header+1);
+		return 1;
+	}
+	Header        = (FMeshStreamHeader*)GCache.Create( CacheID, Item, sizeof(FMeshStreamHeader) + Size );
+	Header->Mesh  = Mesh;
+	Header->Key   = Key;
+	Header->Scale = Mesh->Scale;
+	Data          = (FLOAT*)(Header+1);
+	return 0;
+	unguardSlow;
+}
+
+//
+// Compute the normal of each vertex as the average of the normals of
+// the triangles sharing it. Points are FVectors or derived from them.
+//
+template<class T> void MeshNormals( UMesh *Mesh, FVector *Norms, const T *Points )
+{
+	FMemMark Mark(GMem);
+	FVector *TriNormals = new(GMem,Mesh->Tris->Num)FVector;
+	for( INT i=0; i<Mesh->Tris->Num; i++ )
+	{
+		FMeshTri &Tri  = Mesh->Tris(i);
+		FVector Side1  = (const FVector&)Points[Tri.iVertex[1]] - (const FVector&)Points[Tri.iVertex[0]];
+		FVector Side2  = (const FVector&)Points[Tri.iVertex[2]] - (const FVector&)Points[Tri.iVertex[0]];
+		TriNormals[i]  = (Side2 ^ Side1);
+		TriNormals[i] *= DivSqrtApprox(TriNormals[i].SizeSquared());
+	}
+	for( i=0; i<Mesh->FrameVerts; i++ )
+	{
+		FMeshVertConnect &Connect = Mesh->Connects(i);
+		Norms[i] = FVector(0,0,0);
+		if( Connect.NumVertTriangles > 0 )
+		{
+			for( INT k=0; k<Connect.NumVertTriangles; k++ )
+				Norms[i] += TriNormals[Mesh->VertLinks(Connect.TriangleListOffset + k)];
+			Norms[i] *= DivSqrtApprox(Norms[i].SizeSquared());
+		}
+	}
+	Mark.Pop();
+}
+
+//
+// Lock the points of one keyframe, unpacked into three float streams of
+// FrameVerts each, X then Y then Z. The mesh must be locked.
+//
+FLOAT* UMesh::LockFrameStream( INT iFrame, FCacheItem *&Item )
+{
+	guardSlow(UMesh::LockFrameStream);
+	FLOAT *X;
+	if( !LockMeshStream( CID_MeshFrame, this, iFrame, 3*FrameVerts*sizeof(FLOAT), X, Item ) )
+	{
+		// Unpack the 11/11/10-bit vertices.
+		FLOAT *Y = X + FrameVerts, *Z = Y + FrameVerts;
+		FMeshVert *MeshVertex = &Verts( iFrame * FrameVerts );
+		for( INT i=0; i<FrameVerts; i++ )
+		{
+			X[i] = MeshVertex[i].X;
+			Y[i] = MeshVertex[i].Y;
+			Z[i] = MeshVertex[i].Z;
+		}
+	}
+	return X;
+	unguardSlow;
+}
+
+//
+// Lock the vertex normals of blend bucket iBucket of NORMAL_BUCKETS between
+// two keyframes, in three float streams like LockFrameStream. The normals
+// are for the mesh as scaled by Scale. The mesh must be locked.
+//
+FLOAT* UMesh::LockNormalStream( INT iFrame1, INT iFrame2, INT iBucket, FCacheItem *&Item )
+{
+	guardSlow(UMesh::LockNormalStream);
+	FLOAT *X;
+	INT   Key = (iFrame1*AnimFrames + iFrame2)*(NORMAL_BUCKETS+1) + iBucket;
+	if( !LockMeshStream( CID_MeshNormals, this, Key, 3*FrameVerts*sizeof(FLOAT), X, Item ) )
+	{
+		// Blend the keyframes by the bucket's amount, scaled as they will be drawn.
+		FMemMark Mark(GMem);
+		FVector *Points = new(GMem,FrameVerts)FVector;
+		FVector *Norms  = new(GMem,FrameVerts)FVector;
+		FLOAT   Alpha   = (FLOAT)iBucket / NORMAL_BUCKETS;
+		FCacheItem *Item1, *Item2;
+		const FLOAT *X1 = LockFrameStream( iFrame1, Item1 ), *Y1 = X1 + FrameVerts, *Z1 = Y1 + FrameVerts;
+		const FLOAT *X2 = LockFrameStream( iFrame2, Item2 ), *Y2 = X2 + FrameVerts, *Z2 = Y2 + FrameVerts;
+		for( INT i=0; i<FrameVerts; i++ )
+			Points[i] = FVector( X1[i]+(X2[i]-X1[i])*Alpha, Y1[i]+(Y2[i]-Y1[i])*Alpha, Z1[i]+(Z2[i]-Z1[i])*Alpha ) * Scale;
+		Item1->Unlock();
+		Item2->Unlock();
+
+		// Find the normals and store them as streams.
+		MeshNormals( this, Norms, Points );
+		FLOAT *Y = X + FrameVerts, *Z = Y + FrameVerts;
+		for( i=0; i<FrameVerts; i++ )
+		{
+			X[i] = Norms[i].X;
+			Y[i] = Norms[i].Y;
+			Z[i] = Norms[i].Z;
+		}
+		Mark.Pop();
+	}
+	return X;
+	unguardSlow;
+}
+
+/*-----------------------------------------------------------------------------
+	UMesh animation internals.
+-----------------------------------------------------------------------------*/
+
+//
+// Get the unscaled coordinate system which transforms the mesh's points
+// for Owner, and Owner's location in it.
+//
+void UMesh::GetFrameCoords( UCamera *Camera, AActor *Owner, FCoords &Coords, FVector &Location )
+{
+	guardSlow(UMesh::GetFrameCoords);
+	if( !Camera || Camera->IsWire() || Camera->IsOrtho() )
+	{
+		Coords   = GMath.UnitCoords * Owner->Rotation * RotOrigin;
+		Location = Owner->Location;
+	}
+	else
+	{
+		Coords   = Camera->Coords * Owner->Rotation * RotOrigin;
+		Location = (Owner->Location - Camera->Coords.Origin).TransformVectorBy( Camera->Coords );
+	}
+	unguardSlow;
+}
+
+//
+// Find the two keyframes to blend at AnimFrame of a sequence, and how
+// far to blend from the first to the second.
+//
+void UMesh::GetFrameKeys( const FMeshAnimSeq *Seq, FLOAT AnimFrame, INT &iFrame1, INT &iFrame2, FLOAT &Alpha )
+{
+	guardSlow(UMesh::GetFrameKeys);
+	iFrame1 = iFrame2 = 0;
+	Alpha   = 0.0;
+	if( Seq )
+	{
+		FLOAT Frame = Max(AnimFrame,0.f) * Seq->NumFrames;
+		INT iFrame  = floor(Frame);
+		Alpha       = Frame - iFrame;
+		iFrame1     = Seq->StartFrame + ((iFrame + 0) % Seq->NumFrames);
+		iFrame2     = Seq->StartFrame + ((iFrame + 1) % Seq->NumFrames);
+	}
+	unguardSlow;
+}
+
+//
+// Blend two keyframes, store the blend in CachedVerts and the blend
+// transformed by Coords and moved to Location in ResultVerts. Returns the
+// total outcode of the points, if there is a camera.
+//
+BYTE UMesh::AnimateFrame
+(
+	FTransSample*	ResultVerts,
+	FVector*		CachedVerts,
+	const FCoords&	Coords,
+	const FVector&	Location,
+	INT				iFrame1,
+	INT				iFrame2,
+	FLOAT			Alpha,
+	UCamera*		Camera
+)
+{
+	guardSlow(UMesh::AnimateFrame);
+	BYTE Outcode = FVF_OutReject;
+	INT  i;
+	if( !GDefaults.MeshStreams )
+	{
+		// Interpolate the packed keyframes.
+		FMeshVert *MeshVertex1 = &Verts( iFrame1 * FrameVerts );
+		FMeshVert *MeshVertex2 = &Verts( iFrame2 * FrameVerts );
+		for( i=0; i<FrameVerts; i++ )
+		{
+			// Convert packed vectors to float.
+			FVector V1( MeshVertex1[i].X, MeshVertex1[i].Y, MeshVertex1[i].Z );
+			FVector V2( MeshVertex2[i].X, MeshVertex2[i].Y, MeshVertex2[i].Z );
+
+			// Interpolate vertices.
+			CachedVerts[i] = V1 + (V2-V1)*Alpha;
+
+			// Transform it.
+			(FVector&)ResultVerts[i] = (CachedVerts[i] - Origin).TransformVectorBy(Coords) + Location;
+			ResultVerts[i].Color.R   = -1;
+			if( Camera )
+			{
+				ResultVerts[i].ComputeOutcode( Camera );
+				Outcode &= ResultVerts[i].Flags;
+			}
+		}
+	}
+	else
+	{
+		// Blend and transform the unpacked streams four independent vertices
+		// at a time, with the origin folded into the translation.
+		FCacheItem *Item1, *Item2;
+		const FLOAT *X1 = LockFrameStream( iFrame1, Item1 ), *Y1 = X1 + FrameVerts, *Z1 = Y1 + FrameVerts;
+		const FLOAT *X2 = LockFrameStream( iFrame2, Item2 ), *Y2 = X2 + FrameVerts, *Z2 = Y2 + FrameVerts;
+		FVector Offset  = Location - Origin.TransformVectorBy( Coords );
+		FLOAT XX=Coords.XAxis.X, XY=Coords.XAxis.Y, XZ=Coords.XAxis.Z;
+		FLOAT YX=Coords.YAxis.X, YY=Coords.YAxis.Y, YZ=Coords.YAxis.Z;
+		FLOAT ZX=Coords.ZAxis.X, ZY=Coords.ZAxis.Y, ZZ=Coords.ZAxis.Z;
+		#define ANIMATE_VERT(j) \
+		{ \
+			FLOAT PX = X1[j] + (X2[j]-X1[j])*Alpha; \
+			FLOAT PY = Y1[j] + (Y2[j]-Y1[j])*Alpha; \
+			FLOAT PZ = Z1[j] + (Z2[j]-Z1[j])*Alpha; \
+			CachedVerts[j].X = PX; \
+			CachedVerts[j].Y = PY; \
+			CachedVerts[j].Z = PZ; \
+			ResultVerts[j].X = PX*XX + PY*XY + PZ*XZ + Offset.X; \
+			ResultVerts[j].Y = PX*YX + PY*YY + PZ*YZ + Offset.Y; \
+			ResultVerts[j].Z = PX*ZX + PY*ZY + PZ*ZZ + Offset.Z; \
+			ResultVerts[j].Color.R = -1; \
+		}
+		for( i=0; i+4<=FrameVerts; i+=4 )
+		{
+			ANIMATE_VERT(i+0);
+			ANIMATE_VERT(i+1);
+			ANIMATE_VERT(i+2);
+			ANIMATE_VERT(i+3);
+		}
+		for( ; i<FrameVerts; i++ )
+			ANIMATE_VERT(i);
+		#undef ANIMATE_VERT
+		Item1->Unlock();
+		Item2->Unlock();
+
+		// Outcode the points in a separate pass, keeping the loop above branch-free.
+		if( Camera )
+		{
+			for( i=0; i<FrameVerts; i++ )
+			{
+				ResultVerts[i].ComputeOutcode( Camera );
+				Outcode &= ResultVerts[i].Flags;
+			}
+		}
+	}
+	return Outcode;
+	unguardSlow;
+}
+
+//
+// Get the vertex normals of a blend between two keyframes from the nearest
+// cached blend bucket, transformed by the unscaled coordinate system Coords.
+//
+void UMesh::AnimateNormals( FVector *Norms, const FCoords &Coords, INT iFrame1, INT iFrame2, FLOAT Alpha )
+{
+	guardSlow(UMesh::AnimateNormals);
+
+	// A mirroring coordinate system also flips the normals of the transformed points.
+	FLOAT   Sign  = ((Coords.XAxis ^ Coords.YAxis) | Coords.ZAxis) < 0.0 ? -1.0 : 1.0;
+	FVector XAxis = Coords.XAxis * Sign;
+	FVector YAxis = Coords.YAxis * Sign;
+	FVector ZAxis = Coords.ZAxis * Sign;
+
+	// Rotate the cached normals.
+	FCacheItem *Item;
+	INT iBucket = (INT)(Alpha*NORMAL_BUCKETS + 0.5);
+	const FLOAT *X = LockNormalStream( iFrame1, iFrame2, iBucket, Item ), *Y = X + FrameVerts, *Z = Y + FrameVerts;
+	for( INT i=0; i<FrameVerts; i++ )
+	{
+		Norms[i].X = X[i]*XAxis.X + Y[i]*XAxis.Y + Z[i]*XAxis.Z;
+		Norms[i].Y = X[i]*YAxis.X + Y[i]*YAxis.Y + Z[i]*YAxis.Z;
+		Norms[i].Z = X[i]*ZAxis.X + Y[i]*ZAxis.Y + Z[i]*ZAxis.Z;
+	}
+	Item->Unlock();
+	unguardSlow;
+}
+
 /*-----------------------------------------------------------------------------
 	UMesh animation interface.
 -----------------------------------------------------------------------------*/
 
 //
-// Get the transformed point set corresponding to the animation frame 
+// Get the transformed point set corresponding to the animation frame
 // of this primitive owned by Owner. Returns the total outcode of the points.
 //
 BYTE UMesh::GetFrame
@@ -209,16 +516,7 @@ BYTE UMesh::GetFrame
 	// Setup coordinate system.
 	FCoords Coords;
 	FVector TempVector;
-	if( !Camera || Camera->IsWire() || Camera->IsOrtho() )
-	{
-		Coords		= GMath.UnitCoords * Owner->Rotation * RotOrigin;
-		TempVector  = Owner->Location;
-	}
-	else
-	{
-		Coords		= Camera->Coords * Owner->Rotation * RotOrigin;
-		TempVector	= (Owner->Location - Camera->Coords.Origin).TransformVectorBy( Camera->Coords );
-	}
+	GetFrameCoords( Camera, Owner, Coords, TempVector );
 	FVector NewScale  = Scale * Owner->DrawScale;
 	Coords.XAxis     *= NewScale;
 	Coords.YAxis     *= NewScale;
@@ -231,39 +529,11 @@ BYTE UMesh::GetFrame
 	BYTE Outcode = FVF_OutReject;
 	if( Owner->AnimFrame>=0.0 || !WasCached )
 	{
-		// Compute interpolation numbers.
-		FLOAT Alpha=0.0;
-		INT iFrameOffset1=0, iFrameOffset2=0;
-		if( Seq )
-		{
-			FLOAT Frame   = Max(Owner->AnimFrame,0.f) * Seq->NumFrames;
-			INT iFrame    = floor(Frame);
-			Alpha         = Frame - iFrame;
-			iFrameOffset1 = (Seq->StartFrame + ((iFrame + 0) % Seq->NumFrames)) * FrameVerts;
-			iFrameOffset2 = (Seq->StartFrame + ((iFrame + 1) % Seq->NumFrames)) * FrameVerts;
-		}
-
 		// Interpolate two frames.
-		FMeshVert *MeshVertex1 = &Verts( iFrameOffset1 );
-		FMeshVert *MeshVertex2 = &Verts( iFrameOffset2 );
-		for( int i=0; i<FrameVerts; i++ )
-		{
-			// Convert packed vectors to float.
-			FVector V1( MeshVertex1[i].X, MeshVertex1[i].Y, MeshVertex1[i].Z );
-			FVector V2( MeshVertex2[i].X, MeshVertex2[i].Y, MeshVertex2[i].Z );
-
-			// Interpolate vertices.
-			CachedVerts[i] = V1 + (V2-V1)*Alpha;
-
-			// Transform it.
-			(FVector&)ResultVerts[i] = (CachedVerts[i] - Origin).TransformVectorBy(Coords) + TempVector;
-			ResultVerts[i].Color.R   = -1;
-			if( Camera )
-			{
-				ResultVerts[i].ComputeOutcode( Camera );
-				Outcode &= ResultVerts[i].Flags;
-			}
-		}
+		INT   iFrame1, iFrame2;
+		FLOAT Alpha;
+		GetFrameKeys( Seq, Owner->AnimFrame, iFrame1, iFrame2, Alpha );
+		Outcode = AnimateFrame( ResultVerts, CachedVerts, Coords, TempVector, iFrame1, iFrame2, Alpha, Camera );
 	}
 	else
 	{
@@ -306,6 +576,148 @@ BYTE UMesh::GetFrame
 	unguard;
 }
 
+//
+// Get the vertex normals of the animation frame of this primitive owned
+// by Owner, transformed like the points from GetFrame. Returns 0 if they
+// aren't cached, such as while tweening, and must be computed from the
+// points with ComputeNormals instead.
+//
+INT UMesh::GetFrameNormals( FVector *Norms, UCamera *Camera, AActor *Owner )
+{
+	guard(UMesh::GetFrameNormals);
+	if( !GDefaults.MeshStreams || Owner->AnimFrame<0.0 )
+		return 0;
+
+	FCoords Coords;
+	FVector Location;
+	INT     iFrame1, iFrame2;
+	FLOAT   Alpha;
+	GetFrameCoords( Camera, Owner, Coords, Location );
+	GetFrameKeys( GetAnimSeq(Owner->AnimSequence), Owner->AnimFrame, iFrame1, iFrame2, Alpha );
+	AnimateNormals( Norms, Coords, iFrame1, iFrame2, Alpha );
+	return 1;
+	unguard;
+}
+
+//
+// Compute the vertex normals of a frame from its transformed points.
+//
+void UMesh::ComputeNormals( FVector *Norms, const FTransSample *Points )
+{
+	guard(UMesh::ComputeNormals);
+	MeshNormals( this, Norms, Points );
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	UMesh animation benchmark.
+-----------------------------------------------------------------------------*/
+
+//
+// One animated copy of a mesh in the benchmark.
+//
+struct FBenchMesh
+{
+	const FMeshAnimSeq*	Seq;		// Sequence being played, or NULL.
+	FLOAT				Phase;		// Starting animation frame, 0.0-1.0.
+	FLOAT				Rate;		// Animation advance per benchmark frame.
+	FCoords				Coords;		// Unscaled coordinate system.
+	FVector				Location;	// Location.
+};
+
+//
+// Animate NumMeshes copies of Mesh with no camera for a number of frames,
+// first from the packed keyframes and then from the unpacked streams, and
+// report the time per frame and how closely the two agree at the end.
+//
+void UMesh::Bench( UMesh *Mesh, INT NumMeshes, INT Frames, FOutputDevice *Out )
+{
+	guard(UMesh::Bench);
+	Mesh->Lock( LOCK_Read );
+	FMemMark Mark(GMem);
+	FBenchMesh   *Meshes      = new(GMem,NumMeshes)FBenchMesh;
+	FTransSample *Samples     = new(GMem,Mesh->FrameVerts)FTransSample;
+	FVector      *CachedVerts = new(GMem,Mesh->FrameVerts)FVector;
+	FVector      *Norms       = new(GMem,Mesh->FrameVerts)FVector;
+	FVector      *CheckVerts  = new(GMem,Mesh->FrameVerts)FVector;
+	FVector      *CheckNorms  = new(GMem,Mesh->FrameVerts)FVector;
+	INT          SavedStreams = GDefaults.MeshStreams;
+	DOUBLE       Msec[2];
+
+	// Scatter the copies, playing every sequence at different phases.
+	srand( 0x1234 );
+	for( INT i=0; i<NumMeshes; i++ )
+	{
+		FBenchMesh &M = Meshes[i];
+		M.Seq = Mesh->AnimSeqs && Mesh->AnimSeqs->Num ? &Mesh->AnimSeqs(i % Mesh->AnimSeqs->Num) : NULL;
+		if( M.Seq && M.Seq->NumFrames==0 )
+			M.Seq = NULL;
+		M.Phase    = frand();
+		M.Rate     = M.Seq ? M.Seq->Rate / (35.0 * M.Seq->NumFrames) : 0.0;
+		M.Coords   = GMath.UnitCoords * FRotation(0,(INT)(frand()*65536.0),0) * Mesh->RotOrigin;
+		M.Location = FVector( 4096.0*(frand()-0.5), 4096.0*(frand()-0.5), 0.0 );
+	}
+
+	for( INT iMode=0; iMode<2; iMode++ )
+	{
+		// Start with nothing unpacked.
+		GDefaults.MeshStreams = iMode;
+		GCache.Flush( CID_MeshFrame,   CID_MAX );
+		GCache.Flush( CID_MeshNormals, CID_MAX );
+
+		// Animate every copy each frame, as DrawMesh does for visible meshes.
+		QWORD StartTime = GApp->MicrosecondTime();
+		for( INT Frame=0; Frame<Frames; Frame++ )
+		{
+			for( i=0; i<NumMeshes; i++ )
+			{
+				FBenchMesh &M   = Meshes[i];
+				FLOAT AnimFrame = M.Phase + Frame*M.Rate;
+				INT   iFrame1, iFrame2;
+				FLOAT Alpha;
+				Mesh->GetFrameKeys( M.Seq, AnimFrame - floor(AnimFrame), iFrame1, iFrame2, Alpha );
+
+				FCoords Coords = M.Coords;
+				Coords.XAxis  *= Mesh->Scale;
+				Coords.YAxis  *= Mesh->Scale;
+				Coords.ZAxis  *= Mesh->Scale;
+				Mesh->AnimateFrame( Samples, CachedVerts, Coords, M.Location, iFrame1, iFrame2, Alpha, NULL );
+				if( iMode ) Mesh->AnimateNormals( Norms, M.Coords, iFrame1, iFrame2, Alpha );
+				else        Mesh->ComputeNormals( Norms, Samples );
+			}
+		}
+		Msec[iMode] = (SQWORD)(GApp->MicrosecondTime() - StartTime) / 1000.0;
+
+		// Keep the last copy's packed results to check the streams against.
+		if( iMode == 0 )
+		{
+			for( i=0; i<Mesh->FrameVerts; i++ )
+			{
+				CheckVerts[i] = Samples[i];
+				CheckNorms[i] = Norms[i];
+			}
+		}
+	}
+	GDefaults.MeshStreams = SavedStreams;
+
+	// Compare the last copy's results.
+	FLOAT MaxError=0.0, MinAgree=1.0;
+	for( i=0; i<Mesh->FrameVerts; i++ )
+	{
+		MaxError = Max( MaxError, ((FVector&)Samples[i] - CheckVerts[i]).Size() );
+		if( Mesh->Connects(i).NumVertTriangles > 0 )
+			MinAgree = Min( MinAgree, Norms[i] | CheckNorms[i] );
+	}
+	Mark.Pop();
+	Mesh->Unlock( LOCK_Read );
+
+	// Report.
+	Out->Logf( "Mesh bench: %s, %i copies of %i verts for %i frames", Mesh->GetName(), NumMeshes, Mesh->FrameVerts, Frames );
+	Out->Logf( "Packed:  %8.3f msec/frame", Msec[0] / Frames );
+	Out->Logf( "Streams: %8.3f msec/frame, max position error %.4f, worst normal agreement %.4f", Msec[1] / Frames, MaxError, MinAgree );
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	UMesh constructor.
 -----------------------------------------------------------------------------*/
@@ -17,7 +17,40 @@
 INT          FName::InitedHash      = 0;
 INDEX		 FName::MaxNames        = 0;
 FNameEntry** FName::Names           = NULL;
-FNameEntry*  FName::NameHash[1024];
+FNameEntry*  FName::NameHash[4096];
+NAME_INDEX*  FName::NextFree        = NULL;
+INT          FName::FreeHead        = MAX_NAMES;
+
+// Lookups and adds don't lock, but count themselves in GNameUsers. DeleteEntry
+// takes the name lock, sets GNameDeleting to hold off new lookups and adds,
+// and waits for the ones in progress to finish before changing the hash.
+static FSpinLock    GNameLock;
+static volatile INT GNameUsers    = 0;
+static volatile INT GNameDeleting = 0;
+
+//
+// Counts a name lookup or add in progress for its lifetime.
+//
+class FNameUse
+{
+public:
+	FNameUse()
+	{
+		for( ;; )
+		{
+			appInterlockedAdd( &GNameUsers, 1 );
+			if( !GNameDeleting )
+				break;
+			appInterlockedAdd( &GNameUsers, -1 );
+			while( GNameDeleting )
+				GApp->YieldThread();
+		}
+	}
+	~FNameUse()
+	{
+		appInterlockedAdd( &GNameUsers, -1 );
+	}
+};
 
 /*-----------------------------------------------------------------------------
 	FName implementation.
@@ -39,16 +72,18 @@ FName::FName( const char *Name, EFindName FindType )
 	}
 
 	// Compute hash.
-	INT iHash = strihash(Name) & (ARRAY_COUNT(NameHash)-1);
+	DWORD HashValue = strihash(Name);
+	DWORD Length    = strlen(Name);
+	INT   iHash     = HashValue & (ARRAY_COUNT(NameHash)-1);
+	FNameUse Use;
 
 	// Try to find the name in the hash.
-	for( FNameEntry *Hash=NameHash[iHash]; Hash; Hash=Hash->HashNext )
+	FNameEntry *Head  = NameHash[iHash];
+	FNameEntry *Found = FindEntry( Head, NULL, Name, HashValue, Length );
+	if( Found )
 	{
-		if( stricmp( Name, Hash->Name )==0 )
-		{
-			Index = Hash->Index;
-			return;
-		}
+		Index = Found->Index;
+		return;
 	}
 
 	// Didn't find name.
@@ -60,31 +95,95 @@ FName::FName( const char *Name, EFindName FindType )
 	else if( FindType == FNAME_Add )
 	{
 		// Validate the name.
-		if( strlen(Name) >= NAME_SIZE )
+		if( Length >= NAME_SIZE )
 			appErrorf( "Name '%s' is too big", Name );
 
-		// Find an available entry in the name table.
-		for( Index=0; Index<MaxNames; Index++ )
-			if( Names[Index]== NULL )
-				break;
+		// Allocate the name and set it.
+		Index = AllocIndex();
+		FNameEntry *Entry = Names[Index] = AllocateNameEntry( Name, Index, 0, Head );
 
-		// Expand the name table if necessary.
-		if( Index >= MaxNames )
+		// Link it into the hash, unless another thread adds the same name first.
+		for( ;; )
 		{
-			Index     = MaxNames;
-			MaxNames += MaxNames/4;
-	        Names     = (FNameEntry **)appRealloc( Names, MaxNames*sizeof(FNameEntry*), "Names" );
-			for( INDEX i=Index; i<MaxNames; i++ )
-				Names[i] = NULL;
+			FNameEntry *Prev = (FNameEntry*)appInterlockedCompareExchange( (volatile INT*)&NameHash[iHash], (INT)Entry, (INT)Head );
+			if( Prev == Head )
+				break;
+			Found = FindEntry( Prev, Head, Name, HashValue, Length );
+			if( Found )
+			{
+				Names[Index] = NULL;
+				FreeIndex( Index );
+				free( Entry );
+				Index = Found->Index;
+				break;
+			}
+			Entry->HashNext = Head = Prev;
 		}
-
-		// Allocate the name and set it.
-		NameHash[iHash] = Names[Index] = AllocateNameEntry( Name, Index, 0, NameHash[iHash] );
 	}
 	else appError("FName: Bad find type");
 	unguard;
 }
 
+//
+// Find a name among the hash entries from First up to but not including Last.
+//
+FNameEntry *FName::FindEntry( FNameEntry *First, FNameEntry *Last, const char *Name, DWORD HashValue, DWORD Length )
+{
+	guardSlow(FName::FindEntry);
+	for( FNameEntry *Hash=First; Hash!=Last; Hash=Hash->HashNext )
+		if( Hash->HashValue==HashValue && Hash->Length==Length && stricmp( Name, Hash->Name )==0 )
+			return Hash;
+	return NULL;
+	unguardSlow;
+}
+
+//
+// Allocate an index in the name table: The most recently freed one,
+// or else a new one past the end.
+//
+INDEX FName::AllocIndex()
+{
+	guard(FName::AllocIndex);
+
+	// Pop an index off the free stack. The tag changes on every push and pop,
+	// so a stale NextFree entry can never be swapped in.
+	for( ;; )
+	{
+		INT Old = FreeHead;
+		INT i   = Old & 0xFFFF;
+		if( i == MAX_NAMES )
+			break;
+		INT New = ((Old + 0x10000) & 0xFFFF0000) + NextFree[i];
+		if( appInterlockedCompareExchange( &FreeHead, New, Old ) == Old )
+			return i;
+	}
+
+	// Append a new index.
+	INDEX i = appInterlockedAdd( (volatile INT*)&MaxNames, 1 );
+	if( i >= MAX_NAMES )
+		appErrorf( "Name table is full (%i names)", (INT)MAX_NAMES );
+	return i;
+
+	unguard;
+}
+
+//
+// Return an unused index to the free stack.
+//
+void FName::FreeIndex( INDEX i )
+{
+	guard(FName::FreeIndex);
+	for( ;; )
+	{
+		INT Old     = FreeHead;
+		NextFree[i] = Old & 0xFFFF;
+		INT New     = ((Old + 0x10000) & 0xFFFF0000) + i;
+		if( appInterlockedCompareExchange( &FreeHead, New, Old ) == Old )
+			break;
+	}
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	FName subsystem.
 -----------------------------------------------------------------------------*/
@@ -100,12 +199,14 @@ void FName::InitSubsystem()
 	checkState(InitedHash);
 	checkState((ARRAY_COUNT(NameHash)&(ARRAY_COUNT(NameHash)-1)) == 0);
 
-	// Alloc table.
-	MaxNames   = 1024;
-	Names	   = appMallocArray( MaxNames, FNameEntry*, "Names" );
+	// Alloc table. It's allocated at full size so that it never moves under other threads.
+	MaxNames   = 0;
+	FreeHead   = MAX_NAMES;
+	Names	   = appMallocArray( MAX_NAMES, FNameEntry*, "Names" );
+	NextFree   = appMallocArray( MAX_NAMES, NAME_INDEX, "NameFree" );
 
 	// Init names.
-	for( int i=0; i<MaxNames; i++ ) 
+	for( int i=0; i<MAX_NAMES; i++ ) 
 		Names[i] = NULL;
 
 	// Add all hardcoded names to the list.
@@ -117,7 +218,7 @@ void FName::InitSubsystem()
 			// Validate everything.
 			checkState(Hash->Flags & RF_HardcodedName);
 			checkState(Hash->Name[0]!=0);
-			checkState(Hash->Index<(DWORD)MaxNames);
+			checkState(Hash->Index<(DWORD)MAX_NAMES);
 			if( Names[Hash->Index]!=NULL )
 				appErrorf( "Hardcoded name %i duplicated", Hash->Index );
 			for( FNameEntry *Other=NameHash[i]; Other!=Hash; Other=Other->HashNext )
@@ -126,9 +227,15 @@ void FName::InitSubsystem()
 
 			// Add to name table.
 			Names[Hash->Index] = Hash;
+			MaxNames = Max( MaxNames, (INDEX)Hash->Index+1 );
 			AddedNames++;
 		}
 	}
+
+	// Make the gaps between hardcoded names available, lowest first.
+	for( i=MaxNames-1; i>=0; i-- )
+		if( Names[i]==NULL )
+			FreeIndex( i );
 	debugf( LOG_Init, "Name subsystem initialized: %i names", AddedNames );
 	unguard;
 }
@@ -145,6 +252,7 @@ void FName::ExitSubsystem()
 		if( Names[i] && !(Names[i]->Flags & RF_HardcodedName) )
 			delete Names[i];
 	appFree( Names );
+	appFree( NextFree );
 
 	debugf( LOG_Init, "Name subsystem shut down" );
 	unguard;
@@ -170,17 +278,22 @@ void FName::DisplayHash( FOutputDevice *Out )
 }
 
 //
-// Delete an name permanently; called by garbage collector.
+// Delete an name permanently; called by garbage collector. Waits for
+// lookups and adds on other threads to finish first.
 //
 void FName::DeleteEntry( int i )
 {
 	guard(FName::DeleteEntry);
+	GNameLock.Lock();
+	appInterlockedExchange( &GNameDeleting, 1 );
+	while( GNameUsers )
+		GApp->YieldThread();
 
 	// Unhash it.
 	FNameEntry *Name = Names[i];
 	checkState(Name!=NULL);
 
-	int iHash = strihash(Name->Name) & (ARRAY_COUNT(NameHash)-1);
+	int iHash = Name->HashValue & (ARRAY_COUNT(NameHash)-1);
 	for( FNameEntry **HashLink=&NameHash[iHash]; *HashLink && *HashLink!=Name; HashLink=&(*HashLink)->HashNext );
 	if( !*HashLink )
 		appErrorf( "Unhashed name '%s'", Name->Name );
@@ -188,10 +301,13 @@ void FName::DeleteEntry( int i )
 
 	// Remove it from the global name table.
 	Names[i] = NULL;
+	FreeIndex( i );
 
 	// Delete it.
 	delete Name;
 
+	appInterlockedExchange( &GNameDeleting, 0 );
+	GNameLock.Unlock();
 	unguard;
 }
 
@@ -214,7 +330,9 @@ UNENGINE_API BYTE GAutoregisterName( FNameEntryV &AutoName )
 	}
 
 	// Add name to name hash.
-	int iHash              = strihash(AutoName.Name) & (ARRAY_COUNT(FName::NameHash)-1);
+	AutoName.HashValue     = strihash(AutoName.Name);
+	AutoName.Length        = strlen(AutoName.Name);
+	int iHash              = AutoName.HashValue & (ARRAY_COUNT(FName::NameHash)-1);
 	AutoName.HashNext      = FName::NameHash[iHash];
 	FName::NameHash[iHash] = (FNameEntry*)&AutoName;
 
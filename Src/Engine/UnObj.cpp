@@ -376,10 +376,44 @@ void UObject::UnloadData()
    	{
 	   	appFree(Data);
 		Data = NULL;
+
+		// Unmodified lazily loaded data can be paged in again from its file.
+		if( XLinker && !(Flags & RF_Modified) )
+		{
+			SetFlags( RF_UnlinkedData );
+			((ULinkerLoad*)XLinker)->DiscardPages( this );
+		}
 	}
 	unguardobj;
 }
 
+//
+// Load the data of a lazily loaded object from the file it came from.
+// Called automatically when the object is locked or its data is requested.
+//
+static FSpinLock GPageLock;
+static THREAD_LOCAL INT GPaging = 0;
+void UObject::PageIn() const
+{
+	guard(UObject::PageIn);
+
+	// Ignore the locks this thread takes while the data is being serialized.
+	// Other threads wait for it to finish.
+	if( GPaging )
+		return;
+
+	GPageLock.Lock();
+	if( XLinker && (Flags & RF_UnlinkedData) )
+	{
+		GPaging = 1;
+		((ULinkerLoad*)XLinker)->PageIn( (UObject*)this );
+		GPaging = 0;
+	}
+	GPageLock.Unlock();
+
+	unguardobj;
+}
+
 //
 // Kill this object by freeing its data, freeing
 // its header, and removing its entry from the global
@@ -401,6 +435,17 @@ void UObject::Kill()
 
 	if( !(Flags & RF_HardcodedRes) )
 	{
+		// Remove it from the linker it pages in from.
+		if( XLinker )
+		{
+			XLinker->ResMap(FileIndex) = NULL;
+			XLinker = NULL;
+		}
+
+		// Take it off the incremental garbage collector's gray stack.
+		if( GObj.GarbageState != FGlobalObjectManager::GC_Idle )
+			GObj.Unshade(this);
+
 		INDEX ThisIndex = Index;
 		UnloadData();
 		PreKill();
@@ -547,6 +592,9 @@ void UObject::ModifyHeader()
 	if( IsTransLocked() )
 		GTrans->NoteResHeader(this);
 
+	// Its references may change.
+	GObj.WriteBarrier(this);
+
 	unguardobj;
 }
 
@@ -566,6 +614,11 @@ INT UObject::Lock( DWORD NewLockType )
 {
 	guard(UObject::Lock);
 	checkState(NewLockType & LOCK_Read);
+	if( IsPagedOut() )
+	{
+		// Load its data from its file.
+		PageIn();
+	}
 	if( (NewLockType & LOCK_Read)==LOCK_Read )
 	{
 		// Lock for reading.
@@ -582,6 +635,10 @@ INT UObject::Lock( DWORD NewLockType )
 		// Lock for writing and save header if transactional.
 		WriteLocks++;
 		ModifyHeader();
+
+		// Its data may no longer match its file.
+		if( XLinker )
+			SetFlags( RF_Modified );
 	}
 	return 1;
 	unguardobj;
@@ -594,6 +651,10 @@ INT UObject::ReadLock() const
 {
 	guard(UObject::ReadLock);
 
+	// Load its data from its file.
+	if( IsPagedOut() )
+		PageIn();
+
 	// Lock for reading.
 	ReadLocks++;
 
@@ -617,6 +678,9 @@ void UObject::Unlock( DWORD OldLockType )
 	{
 		WriteLocks--;
 		checkState(WriteLocks>=0);
+
+		// Its references may have changed while it was locked.
+		GObj.WriteBarrier(this);
 	}
 	if( (OldLockType & LOCK_Read)==LOCK_Read )
 	{
@@ -912,7 +976,12 @@ UObject* FGlobalObjectManager::FindObject( const char *Name, UClass *Class, EFin
 	if( FindName != NAME_None )
 		for( FObjectHashLink* Link = ResHash[ObjectHashOf(Class,FindName)]; Link!=NULL; Link=Link->HashNext )
 			if( Link->Object->Class==Class && Link->Object->Name==FindName )
+			{
+				// An unmarked object found during a collection is reachable again.
+				if( GarbageState!=GC_Idle && (Link->Object->Flags & RF_Unused) )
+					Shade( Link->Object );
 				return Link->Object;
+			}
 
 	// Error if required but not found.
 	if( FindType == FIND_Existing )
@@ -976,6 +1045,23 @@ void FGlobalObjectManager::Init()
 	// Allocate hardcoded objects.
 	Root = new("Root",CREATE_Unique)UArray(0);
 
+	// No asynchronous loads yet.
+	NumAsyncLoads = 0;
+	AsyncLoadMsec = 5.0;
+
+	// No garbage collection cycle yet.
+	GarbageState     = GC_Idle;
+	GarbageMinor     = 0;
+	GarbageTicks     = 0;
+	GarbageMsec      = 1.0;
+	GarbagePeriod    = 350;
+	GarbageFullEvery = 8;
+	GrayStack        = NULL;
+	GrayIndex        = NULL;
+	GrayNum          = 0;
+	GrayMax          = 0;
+	memset( &GarbageStats, 0, sizeof(GarbageStats) );
+
 	debugf( LOG_Init, "Object subsystem initialized" );
 	unguard;
 }
@@ -987,8 +1073,19 @@ void FGlobalObjectManager::Exit()
 {
 	guard(FGlobalObjectManager::Exit);
 
+	// Stop all reading threads.
+	for( INT i=0; i<NumAsyncLoads; i++ )
+		AsyncLoads[i]->FinishReading();
+
 	// Kill all unclaimed objects.
 	CollectGarbage( GApp );
+	if( GrayStack )
+		appFree( GrayStack );
+	if( GrayIndex )
+		appFree( GrayIndex );
+	GrayStack = NULL;
+	GrayIndex = NULL;
+	GrayMax   = 0;
 
 	// Kill the root object.
 	Root->Kill();
@@ -1029,6 +1126,14 @@ void FGlobalObjectManager::Tick()
 {
 	guard(FGlobalObjectManager::Tick);
 
+	// Work on asynchronous loads.
+	if( NumAsyncLoads )
+		TickAsyncLoads( AsyncLoadMsec );
+
+	// Work on incremental garbage collection.
+	if( GDefaults.IncrementalGC || GarbageState!=GC_Idle )
+		TickGarbage( GarbageMsec );
+
 #if CHECK_ALL
 	// Make sure all objects are unlocked.
 	for( int i=0; i<MaxRes; i++ )
@@ -1051,6 +1156,84 @@ void FGlobalObjectManager::Tick()
 	unguard;
 }
 
+/*-----------------------------------------------------------------------------
+   FGlobalObjectManager memory report.
+-----------------------------------------------------------------------------*/
+
+//
+// Memory used by the objects of one class.
+//
+struct FClassMemory
+{
+	UClass	*Class;
+	INT		Count;
+	INT		HeaderBytes;
+	INT		DataBytes;
+	INT		PagedBytes;
+	friend inline int Compare( const FClassMemory &A, const FClassMemory &B )
+	{
+		return (B.HeaderBytes+B.DataBytes) - (A.HeaderBytes+A.DataBytes);
+	}
+};
+
+//
+// Report the memory used by the objects of each class, largest first:
+// their headers, their data in memory as given by QuerySize, and the
+// data of lazily loaded objects which is still paged out.
+//
+void FGlobalObjectManager::DumpClassMemory( FOutputDevice *Out, INT Csv )
+{
+	guard(FGlobalObjectManager::DumpClassMemory);
+	FMemMark Mark(GMem);
+
+	// Total up each class, indexed by the class object's index.
+	FClassMemory *Classes = new(GMem,MEM_Zeroed,MaxRes)FClassMemory;
+	UObject *Res;
+	FOR_ALL_OBJECTS(Res)
+	{
+		UClass       *Class = Res->GetClass();
+		FClassMemory &C     = Classes[Class->Index];
+		C.Class        = Class;
+		C.Count++;
+		C.HeaderBytes += Class->ResFullHeaderSize;
+		if( Res->IsPagedOut() )
+			C.PagedBytes += Res->QuerySize();
+		else if( Res->Data )
+			C.DataBytes += Res->QuerySize();
+	}
+	END_FOR_ALL_OBJECTS;
+
+	// Gather the classes which have objects, and sort them.
+	INT Num=0;
+	for( INT i=0; i<MaxRes; i++ )
+		if( Classes[i].Count )
+			Classes[Num++] = Classes[i];
+	QSort( Classes, Num );
+
+	// Report them.
+	if( !Csv )
+		Out->Log( "Objects by class:" );
+	for( i=0; i<Num; i++ )
+	{
+		FClassMemory &C = Classes[i];
+		if( Csv )
+			Out->Logf( "Class,%s,%i,%i,0,%i", C.Class->GetName(), C.Count, C.HeaderBytes+C.DataBytes, C.PagedBytes );
+		else
+			Out->Logf
+			(
+				"  %-24s %8iK in %6i objects (%iK headers, %iK data), %iK paged out",
+				C.Class->GetName(),
+				(C.HeaderBytes+C.DataBytes)/1024,
+				C.Count,
+				C.HeaderBytes/1024,
+				C.DataBytes/1024,
+				C.PagedBytes/1024
+			);
+	}
+	Mark.Pop();
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
    FGlobalObjectManager command line.
 -----------------------------------------------------------------------------*/
@@ -1074,6 +1257,152 @@ int FGlobalObjectManager::Exec(const char *Cmd,FOutputDevice *Out)
 			FName::DisplayHash(Out);
 			return 1;
 		}
+		else if( GetCMD(&Str,"GC") )
+		{
+			if( GetCMD(&Str,"VERIFY") )
+			{
+				// Run a cycle a little per level tick without purging, and check
+				// that a full mark doesn't reach anything the cycle didn't.
+				INT Minor=0, Ticks=35;
+				GetONOFF(Str,"MINOR=",&Minor);
+				GetINT(Str,"TICKS=",&Ticks);
+				ULevel *Level = GServer.Level;
+				INT    Play   = Level && Level->GetState()==LEVEL_UpPlay;
+
+				AbortGarbage();
+				BeginGarbage( Minor );
+				for( INT i=0; i<Ticks; i++ )
+				{
+					StepGarbage( GApp->MicrosecondTime() + (SQWORD)(GarbageMsec * 1000.0) );
+					if( Play )
+						Level->Tick( 0, NULL, 1.0/35.0 );
+				}
+				FinishMark();
+				GarbageState = GC_Idle;
+
+				// Note what the cycle would have purged.
+				FMemMark Mark(GMem);
+				UObject **Unreached = new(GMem,GetMaxRes())UObject*;
+				INT NumUnreached=0, NumWrong=0;
+				UObject *Res;
+				FOR_ALL_OBJECTS(Res)
+				{
+					if( (Res->Flags & RF_Unused) && !(Res->Flags & RF_HardcodedRes) )
+						Unreached[NumUnreached++] = Res;
+				}
+				END_FOR_ALL_OBJECTS;
+
+				// Compare with a full mark.
+				TagGarbage();
+				for( i=0; i<NumUnreached; i++ )
+				{
+					if( !(Unreached[i]->Flags & RF_Unused) )
+					{
+						Out->Logf( "Missed reference to %s %s", Unreached[i]->GetClassName(), Unreached[i]->GetName() );
+						NumWrong++;
+					}
+				}
+				Mark.Pop();
+				Out->Logf
+				(
+					"%s cycle over %i ticks: %i objects scanned, %i unreached, %i wrongly",
+					Minor ? "Minor" : "Full",
+					Ticks,
+					GarbageStats.Scanned,
+					NumUnreached,
+					NumWrong
+				);
+				return 1;
+			}
+			else if( GetCMD(&Str,"ON") )
+			{
+				GDefaults.IncrementalGC = 1;
+			}
+			else if( GetCMD(&Str,"OFF") )
+			{
+				GDefaults.IncrementalGC = 0;
+			}
+			GetFLOAT(Str,"MSEC=",&GarbageMsec);
+			GetINT(Str,"PERIOD=",&GarbagePeriod);
+			GetINT(Str,"FULLEVERY=",&GarbageFullEvery);
+
+			// Show settings and pause statistics.
+			FGarbageStats &S = GarbageStats;
+			Out->Logf
+			(
+				"Incremental GC %s: %.2f msec per tick, %i ticks apart, every %i full",
+				GDefaults.IncrementalGC ? "on" : "off",
+				GarbageMsec,
+				GarbagePeriod,
+				GarbageFullEvery
+			);
+			Out->Logf
+			(
+				"%i cycles (%i minor), last scanned %i objects and purged %i",
+				S.Cycles,
+				S.MinorCycles,
+				S.Scanned,
+				S.Purged
+			);
+			Out->Logf
+			(
+				"Pauses: last %.2f msec, max %.2f msec, average %.2f msec over %i ticks; last full collection %.2f msec",
+				S.LastPause,
+				S.MaxPause,
+				S.Pauses ? S.TotalPause/S.Pauses : 0.0,
+				S.Pauses,
+				S.FullPause
+			);
+			return 1;
+		}
+		else if( GetCMD(&Str,"ASYNCTEST") )
+		{
+			// Load a file asynchronously while ticking the level with no cameras,
+			// and report the longest tick the load caused.
+			char Filename[256];
+			if( !GetSTRING(Str,"FILE=",Filename,ARRAY_COUNT(Filename)) )
+			{
+				Out->Log(LOG_ExecError,"Missing FILE=");
+				return 1;
+			}
+			ULevel *Level = GServer.Level;
+			if( !Level || Level->GetState()!=LEVEL_UpPlay )
+			{
+				Out->Log(LOG_ExecError,"No level is being played");
+				return 1;
+			}
+			FLOAT Msec = AsyncLoadMsec;
+			GetFLOAT(Str,"MSEC=",&Msec);
+
+			SQWORD StartTime = GApp->MicrosecondTime();
+			ULinkerLoad *Linker = AddFileAsync( Filename, 1 );
+			if( !Linker )
+			{
+				Out->Logf(LOG_ExecError,"Couldn't open %s",Filename);
+				return 1;
+			}
+			INT Ticks=0;
+			SQWORD LongestTick=0;
+			while( !Linker->IsLoadFinished() )
+			{
+				SQWORD TickStart = GApp->MicrosecondTime();
+				TickAsyncLoads( Msec );
+				Level->Tick( 0, NULL, 1.0/35.0 );
+				LongestTick = Max( LongestTick, (SQWORD)GApp->MicrosecondTime() - TickStart );
+				Ticks++;
+			}
+			Out->Logf
+			(
+				"Async load of %s %s: %i ticks, %.1f msec total, longest tick %.1f msec",
+				Filename,
+				Linker->LoadFailed() ? "failed" : "succeeded",
+				Ticks,
+				(FLOAT)((SQWORD)GApp->MicrosecondTime() - StartTime) / 1000.0,
+				(FLOAT)LongestTick / 1000.0
+			);
+			Linker->Kill();
+			return 1;
+		}
 		else if( GetCMD(&Str,"LIST") )
 		{
 			UClass *CheckType = NULL;
@@ -1165,14 +1494,108 @@ int FGlobalObjectManager::AddFile( const char* Filename, ULinkerLoad** LinkerPar
 		return 0;
 	}
 
-	// Succeeded loading.
-	if( LinkerParm )	*LinkerParm = Linker;
-	else				Linker->Kill();
+	// Succeeded loading. A linker which objects are paged in from must stay
+	// around; the garbage collector kills it once none of them are used.
+	if( LinkerParm )			*LinkerParm = Linker;
+	else if( Linker->NumPaged )	Linker->Collected = 1;
+	else						Linker->Kill();
 	return 1;
 
 	unguard;
 }
 
+//
+// Kill the linkers which AddFile kept for paging in lazily loaded objects.
+// Their objects are paged in first, and their files are closed.
+//
+void FGlobalObjectManager::ReleaseLazyLinkers()
+{
+	guard(FGlobalObjectManager::ReleaseLazyLinkers);
+	UObject *Res;
+	FOR_ALL_OBJECTS(Res)
+	{
+		if( Res->IsA(ULinkerLoad::GetBaseClass()) )
+		{
+			ULinkerLoad *Linker = (ULinkerLoad*)Res;
+			if( Linker->Collected )
+				Linker->Kill();
+		}
+	}
+	END_FOR_ALL_OBJECTS;
+	unguard;
+}
+
+//
+// Start loading an Unrealfile asynchronously, and return its linker or NULL
+// if the file couldn't be opened. The file is read from disk and its tables
+// are read on another thread, and its objects are loaded during calls to Tick,
+// without stalling the game. The caller must check the linker's IsLoadFinished
+// and LoadFailed before using any of the file's objects, and must kill the
+// linker once loading is finished.
+//
+ULinkerLoad *FGlobalObjectManager::AddFileAsync( const char *Filename, int NoWarn )
+{
+	guard(FGlobalObjectManager::AddFileAsync);
+	if( NumAsyncLoads >= MAX_ASYNC_LOADS )
+	{
+		debugf( LOG_Info, "Too many asynchronous loads to add '%s'", Filename );
+		return NULL;
+	}
+
+	ULinkerLoad *Linker = NULL;
+	try
+	{
+		// Open the file and read its summary.
+		Linker = new("LoadLinker",CREATE_MakeUnique)ULinkerLoad(Filename,1);
+	}
+	catch( char *Error )
+	{
+		// Failed opening.
+		if( NoWarn )
+			debugf( Error, "Error adding file '%s'", Filename );
+		else
+			appMessageBox( Error, "Error adding file", 0 );
+		return NULL;
+	}
+
+	// Keep the linker and its objects from being collected, and start reading.
+	AddToRoot( Linker );
+	AsyncLoads[NumAsyncLoads++] = Linker;
+	Linker->BeginAsyncLoad();
+	return Linker;
+
+	unguard;
+}
+
+//
+// Spend about Milliseconds of work on finishing asynchronous loads. Files
+// are finished in the order they were added, since later files may depend
+// on earlier ones.
+//
+void FGlobalObjectManager::TickAsyncLoads( FLOAT Milliseconds )
+{
+	guard(FGlobalObjectManager::TickAsyncLoads);
+
+	SQWORD EndTime = GApp->MicrosecondTime() + (SQWORD)(Milliseconds * 1000.0);
+	while( NumAsyncLoads )
+	{
+		// Work on the oldest load.
+		ULinkerLoad *Linker = AsyncLoads[0];
+		FLOAT Remaining = (EndTime - (SQWORD)GApp->MicrosecondTime()) / 1000.0;
+		if( Remaining <= 0.0 || !Linker->TickLoad( Remaining ) )
+			break;
+
+		// It's finished, so hand it over to its owner.
+		if( Linker->LoadFailed() )
+			debugf( LOG_Info, "Failed loading %s asynchronously", Linker->GetName() );
+		RemoveFromRoot( Linker );
+		for( INT i=1; i<NumAsyncLoads; i++ )
+			AsyncLoads[i-1] = AsyncLoads[i];
+		NumAsyncLoads--;
+	}
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	FGlobalObjectManager file saving.
 -----------------------------------------------------------------------------*/
@@ -1315,6 +1738,9 @@ int FGlobalObjectManager::SaveTagged( const char *Filename, int NoWarn )
 
 	try
 	{
+		// Release files which objects are paged in from, in case this overwrites one.
+		ReleaseLazyLinkers();
+
 		// Tag all objects for import that are (1) children of exported objects, and (2) not being exported.
 		TagImports( CLASS_Transient );
 
@@ -1446,6 +1872,13 @@ int FGlobalObjectManager::SaveTagged( const char *Filename, int NoWarn )
 
 			if( Res->Flags & RF_TagExp )
 			{
+				// Start large swappable data on a page boundary so it can be loaded lazily.
+				if( (Res->GetClassFlags() & CLASS_Swappable) && Res->QuerySize()>=LINKER_PAGE_SIZE )
+				{
+					static BYTE Zero[LINKER_PAGE_SIZE];
+					Linker->Serialize( Zero, Align(Linker->Tell(),LINKER_PAGE_SIZE) - Linker->Tell() );
+				}
+
 				// Save data and note data size.
 				Object.FileDataOffset = Linker->Tell();
 				Res->SerializeData( *Linker );
@@ -1869,6 +2302,8 @@ void FGlobalObjectManager::AddObject( UObject *Res )
 		ResArray  = (UObject **)appRealloc( ResArray, MaxRes * sizeof(UObject **), "ResArray" );
 		for( int i=Index; i<MaxRes; i++ )
 			ResArray[i] = NULL;
+		if( GarbageState != GC_Idle )
+			GrowGray();
 	}
 
 	// Add to global table here.
@@ -1879,6 +2314,9 @@ void FGlobalObjectManager::AddObject( UObject *Res )
 	INT iHash      = ObjectHashOf( Res->GetClass(), Res->GetFName() );
 	ResHash[iHash] = new FObjectHashLink( Res, ResHash[iHash] );
 
+	// Scan it if it's added during a collection.
+	WriteBarrier( Res );
+
 	unguard;
 }
 
@@ -1944,9 +2382,12 @@ UObject *FGlobalObjectManager::CreateObject
 	}
 
 	// Init and set flags to prevent swapping as with loaded objects.
-	Res->InitObject( Type, Index, FName(Name,FNAME_Add), SetFlags | RF_Modified );
+	// New objects start out in the young generation.
+	Res->InitObject( Type, Index, FName(Name,FNAME_Add), SetFlags | RF_Modified | RF_Young );
 	if( Index == INDEX_NONE )
 		AddObject( Res );
+	else
+		WriteBarrier( Res );
 
 	// Success.
 	return Res;
@@ -1957,6 +2398,28 @@ UObject *FGlobalObjectManager::CreateObject
    Garbage collection.
 -----------------------------------------------------------------------------*/
 
+//
+// Reach the linker an object pages its data in from, if any, on behalf of
+// either garbage collector. While the data is in memory it's scanned like any
+// other, and the linker is only needed for paging it in again, so the objects
+// the linker maps are left alone and are collected once nothing else uses
+// them. Data left in the file could refer to any of them, so then they're all
+// reached. PurgeGarbage forgets the collected ones.
+//
+static void ReachLinker( FArchive &Ar, UObject *Res )
+{
+	guard(ReachLinker);
+	ULinkerLoad *Linker = (ULinkerLoad*)Res->XLinker;
+	if( Linker )
+	{
+		Linker->ClearFlags( RF_Unused );
+		Ar << Linker->NameMap;
+		if( Res->IsPagedOut() || !Linker->IsLoadFinished() )
+			Ar << Linker->ResMap;
+	}
+	unguard;
+}
+
 //
 // Archive for finding unused objects.
 //
@@ -1973,9 +2436,12 @@ public:
 				// Only recurse the first time object is claimed.
 				Res->ClearFlags(RF_Unused);
 
-				// Recurse.
+				// Recurse. Data left in a file needn't be paged in, because
+				// its linker is reached and references everything it uses.
 				Res->SerializeHeader(*this);
-				Res->SerializeData(*this);
+				if( !Res->IsPagedOut() )
+					Res->SerializeData(*this);
+				ReachLinker( *this, Res );
 			}
 		}
 		return *this;
@@ -1999,6 +2465,13 @@ void FGlobalObjectManager::TagGarbage()
 	guard(FGlobalObjectManager::TagGarbage);
 	UObject *Res;
 
+	// Reading threads add names, so let them finish first.
+	for( INT i=0; i<NumAsyncLoads; i++ )
+		AsyncLoads[i]->FinishReading();
+
+	// This uses the same flags as the incremental collector.
+	AbortGarbage();
+
 	// Tag all objects as unused.
 	FOR_ALL_OBJECTS(Res)
 	{
@@ -2007,7 +2480,7 @@ void FGlobalObjectManager::TagGarbage()
 	END_FOR_ALL_OBJECTS;
 
 	// Tag all names as unused.
-	for( INDEX i=0; i<FName::GetMaxNames(); i++ )
+	for( i=0; i<FName::GetMaxNames(); i++ )
 		if( FName::GetEntry(i) )
 			FName::GetEntry(i)->Flags |= RF_Unused;
 
@@ -2019,13 +2492,35 @@ void FGlobalObjectManager::TagGarbage()
 }
 
 //
-// Purge all tagged objects.
+// Purge all tagged objects, and all tagged names if PurgeNames is set.
+// Returns the number of objects purged.
 //
-void FGlobalObjectManager::PurgeGarbage( FOutputDevice *Out )
+INT FGlobalObjectManager::PurgeGarbage( FOutputDevice *Out, INT PurgeNames )
 {
 	guard(FGlobalObjectManager::PurgeGarbage);
 	debugf( LOG_Info, "Purging garbage" );
 	UObject *Res;
+	INT Count = 0;
+
+	// Make linkers forget the objects being purged, then purge the unused
+	// linkers before the object and name maps they kill.
+	guard(Linkers);
+	FOR_ALL_OBJECTS(Res)
+	{
+		if( Res->IsA(ULinkerLoad::GetBaseClass()) )
+			((ULinkerLoad*)Res)->ForgetGarbage();
+	}
+	END_FOR_ALL_OBJECTS;
+	FOR_ALL_OBJECTS(Res)
+	{
+		if( (Res->Flags & RF_Unused) && Res->IsA(ULinkerLoad::GetBaseClass()) )
+		{
+			Res->Kill();
+			Count++;
+		}
+	}
+	END_FOR_ALL_OBJECTS;
+	unguard;
 
 	// Purge all unused, unempty PreKill objects.
 	guard(PreKillRes);
@@ -2038,6 +2533,7 @@ void FGlobalObjectManager::PurgeGarbage( FOutputDevice *Out )
 				Out->Logf( "Garbage collected object: %s %s", Res->GetClassName(), Res->GetName() );
 #endif
 			Res->Kill();
+			Count++;
 		}
 	}
 	END_FOR_ALL_OBJECTS;
@@ -2054,6 +2550,7 @@ void FGlobalObjectManager::PurgeGarbage( FOutputDevice *Out )
 				Out->Logf( "Garbage collected object: %s %s", Res->GetClassName(), Res->GetName() );
 #endif
 			Res->Kill();
+			Count++;
 		}
 	}
 	END_FOR_ALL_OBJECTS;
@@ -2061,7 +2558,7 @@ void FGlobalObjectManager::PurgeGarbage( FOutputDevice *Out )
 
 	// Purge all unused, unempty names.
 	guard(Names);
-	for( INDEX i=0; i<FName::GetMaxNames(); i++ )
+	for( INDEX i=0; PurgeNames && i<FName::GetMaxNames(); i++ )
 	{
 		FNameEntry *Name = FName::GetEntry(i);
 		if
@@ -2079,6 +2576,7 @@ void FGlobalObjectManager::PurgeGarbage( FOutputDevice *Out )
 		}
 	}
 	unguard;
+	return Count;
 	unguard;
 }
 
@@ -2089,6 +2587,7 @@ void FGlobalObjectManager::CollectGarbage( FOutputDevice *Out )
 {
 	guard(FGlobalObjectManager::CollectGarbage);
 	debugf( LOG_Info, "Collecting garbage" );
+	SQWORD StartTime = GApp->MicrosecondTime();
 
 	// Tag all garbage.
 	TagGarbage();
@@ -2096,6 +2595,10 @@ void FGlobalObjectManager::CollectGarbage( FOutputDevice *Out )
 	// Purge all garbage.
 	PurgeGarbage(Out);
 
+	// Everything left is old.
+	PromoteSurvivors();
+	GarbageStats.FullPause = ((SQWORD)GApp->MicrosecondTime() - StartTime) / 1000.0;
+
 	unguard;
 }
 
@@ -2160,6 +2663,323 @@ int FGlobalObjectManager::AttemptPurge(UObject *&Res)
 	unguard;
 }
 
+/*-----------------------------------------------------------------------------
+   Incremental garbage collection.
+-----------------------------------------------------------------------------*/
+
+//
+// The incremental collector marks objects a little per tick, using the
+// RF_Unused flag for objects which haven't been reached yet and RF_GCGray
+// for objects which have been reached but not scanned. Each cycle either
+// collects all objects starting from the root, or only the young objects
+// created since the last cycle, starting from the old objects modified since
+// then. Objects are considered modified when their header is modified,
+// they're unlocked after writing, or script assigns to one of their
+// properties. Native code stores references into objects without telling
+// anyone, so reached actors and levels and objects still locked are all
+// scanned again at the end of a cycle. A minor cycle also scans every old
+// object again then, since a native store into any of them may hold the only
+// reference to a young object. Names are only purged by CollectGarbage.
+//
+
+//
+// Archive for the mark phase. Instead of recursing, it shades each object
+// it reaches gray, and the gray stack is drained a few objects at a time.
+//
+class FArchiveShadeGray : public FArchive
+{
+public:
+	FArchive& operator<< ( UObject *&Res )
+	{
+		guard(FArchiveShadeGray<<Obj);
+		if( Res && (Res->GetFlags() & RF_Unused) )
+			GObj.Shade( Res );
+		return *this;
+		unguard;
+	}
+};
+
+//
+// Note that an object's references may have changed.
+//
+void FGlobalObjectManager::WriteBarrier( UObject *Res )
+{
+	guard(FGlobalObjectManager::WriteBarrier);
+	if( GarbageState == GC_Idle )
+	{
+		// Remember old objects which may now reference young ones.
+		if( !(Res->Flags & RF_Young) )
+			Res->Flags |= RF_GCRemember;
+	}
+	else if( !(Res->Flags & (RF_Unused|RF_GCGray)) )
+	{
+		// It has already been scanned, so scan it again.
+		Shade( Res );
+	}
+	unguard;
+}
+
+//
+// Make the gray stack big enough to hold every object in the table. An
+// object is only pushed while it isn't gray, so the stack never overflows
+// and Shade needn't allocate.
+//
+void FGlobalObjectManager::GrowGray()
+{
+	guard(FGlobalObjectManager::GrowGray);
+	if( GrayMax < MaxRes )
+	{
+		if( GTaskPool.Running )
+			GrayLock.Lock();
+		GrayStack = (UObject**)appRealloc( GrayStack, MaxRes*sizeof(UObject*), "GrayStack" );
+		GrayIndex = (INT     *)appRealloc( GrayIndex, MaxRes*sizeof(INT),      "GrayIndex" );
+		for( INT i=GrayMax; i<MaxRes; i++ )
+			GrayIndex[i] = INDEX_NONE;
+		GrayMax = MaxRes;
+		if( GTaskPool.Running )
+			GrayLock.Unlock();
+	}
+	unguard;
+}
+
+//
+// Mark an object as reached and push it on the gray stack to be scanned.
+//
+void FGlobalObjectManager::Shade( UObject *Res )
+{
+	guard(FGlobalObjectManager::Shade);
+	if( GTaskPool.Running )
+		GrayLock.Lock();
+
+	if( !(Res->Flags & RF_GCGray) )
+	{
+		checkState(GrayNum<GrayMax);
+		Res->Flags = (Res->Flags & ~RF_Unused) | RF_GCGray;
+		GrayIndex[Res->Index] = GrayNum;
+		GrayStack[GrayNum++]  = Res;
+	}
+
+	if( GTaskPool.Running )
+		GrayLock.Unlock();
+	unguard;
+}
+
+//
+// Remove an object which is being killed from the gray stack, by moving
+// the top entry into its place.
+//
+void FGlobalObjectManager::Unshade( UObject *Res )
+{
+	guard(FGlobalObjectManager::Unshade);
+	if( GTaskPool.Running )
+		GrayLock.Lock();
+
+	INT i = GrayIndex[Res->Index];
+	if( i != INDEX_NONE )
+	{
+		UObject *Top              = GrayStack[--GrayNum];
+		GrayStack[i]              = Top;
+		GrayIndex[Top->Index]     = i;
+		GrayIndex[Res->Index]     = INDEX_NONE;
+	}
+
+	if( GTaskPool.Running )
+		GrayLock.Unlock();
+	unguard;
+}
+
+//
+// Start a cycle. A full cycle whitens every object and starts from the
+// root; a minor one only whitens young objects and starts from the old
+// objects modified since the last cycle.
+//
+void FGlobalObjectManager::BeginGarbage( INT Minor )
+{
+	guard(FGlobalObjectManager::BeginGarbage);
+	checkState(GarbageState==GC_Idle);
+
+	GarbageState         = GC_Marking;
+	GarbageMinor         = Minor;
+	GarbageStats.Scanned = 0;
+	GrayNum              = 0;
+	GrowGray();
+
+	// Whiten the objects being collected.
+	UObject *Res;
+	FOR_ALL_OBJECTS(Res)
+	{
+		Res->Flags &= ~(RF_Unused | RF_GCGray);
+		if( !Minor || (Res->Flags & RF_Young) )
+			Res->Flags |= RF_Unused;
+	}
+	END_FOR_ALL_OBJECTS;
+
+	// Shade the starting points.
+	if( Minor )
+	{
+		FOR_ALL_OBJECTS(Res)
+		{
+			if( Res->Flags & RF_GCRemember )
+				Shade( Res );
+		}
+		END_FOR_ALL_OBJECTS;
+	}
+	else Shade( Root );
+
+	unguard;
+}
+
+//
+// Scan gray objects until none are left, or until EndTime if it's nonzero.
+// Returns 1 if none are left.
+//
+INT FGlobalObjectManager::StepGarbage( SQWORD EndTime )
+{
+	guard(FGlobalObjectManager::StepGarbage);
+	checkState(GarbageState==GC_Marking);
+
+	FArchiveShadeGray Ar;
+	while( GrayNum > 0 )
+	{
+		for( INT n=0; n<16 && GrayNum>0; n++ )
+		{
+			UObject *Res = GrayStack[--GrayNum];
+			GrayIndex[Res->Index] = INDEX_NONE;
+
+			// It stays gray while being scanned, so that locking it doesn't shade it again.
+			// Data left in a file needn't be scanned, because its linker is reached.
+			Res->SerializeHeader( Ar );
+			if( !Res->IsPagedOut() )
+				Res->SerializeData( Ar );
+			ReachLinker( Ar, Res );
+			Res->Flags &= ~RF_GCGray;
+			GarbageStats.Scanned++;
+		}
+		if( EndTime && (SQWORD)GApp->MicrosecondTime()>=EndTime )
+			break;
+	}
+	return GrayNum == 0;
+	unguard;
+}
+
+//
+// Finish marking. Locked objects, actors and levels may have changed without
+// notice, so they're scanned again, and everything they reach is scanned.
+// In a minor cycle, so are all old objects.
+//
+void FGlobalObjectManager::FinishMark()
+{
+	guard(FGlobalObjectManager::FinishMark);
+	UObject *Res;
+	FOR_ALL_OBJECTS(Res)
+	{
+		if( Res->Flags & RF_GCGray )
+			continue;
+		if( Res->ReadLocks>0 )
+			Shade( Res );
+		else if( !(Res->Flags & RF_Unused) && (Res->IsA("Actor") || Res->IsA("Level")) )
+			Shade( Res );
+		else if( GarbageMinor && !(Res->Flags & RF_Young) )
+			Shade( Res );
+	}
+	END_FOR_ALL_OBJECTS;
+	StepGarbage( 0 );
+	unguard;
+}
+
+//
+// Finish the current cycle, purge all objects it didn't reach and promote
+// the survivors to the old generation. Returns the number of objects purged.
+//
+INT FGlobalObjectManager::FinishGarbage( FOutputDevice *Out )
+{
+	guard(FGlobalObjectManager::FinishGarbage);
+
+	FinishMark();
+	GarbageState = GC_Idle;
+	INT Count    = PurgeGarbage( Out, 0 );
+	PromoteSurvivors();
+
+	// Update stats.
+	GarbageStats.Purged = Count;
+	GarbageStats.Cycles++;
+	if( GarbageMinor )
+		GarbageStats.MinorCycles++;
+
+	return Count;
+	unguard;
+}
+
+//
+// Abandon the current cycle, if any, without purging anything.
+//
+void FGlobalObjectManager::AbortGarbage()
+{
+	guard(FGlobalObjectManager::AbortGarbage);
+	if( GarbageState != GC_Idle )
+	{
+		UObject *Res;
+		FOR_ALL_OBJECTS(Res)
+		{
+			Res->Flags &= ~(RF_Unused | RF_GCGray);
+		}
+		END_FOR_ALL_OBJECTS;
+		while( GrayNum > 0 )
+			GrayIndex[GrayStack[--GrayNum]->Index] = INDEX_NONE;
+		GarbageState = GC_Idle;
+	}
+	unguard;
+}
+
+//
+// Make all objects old and forget which were modified, after a
+// collection which found every reference to young objects.
+//
+void FGlobalObjectManager::PromoteSurvivors()
+{
+	guard(FGlobalObjectManager::PromoteSurvivors);
+	UObject *Res;
+	FOR_ALL_OBJECTS(Res)
+	{
+		Res->Flags &= ~(RF_Young | RF_GCRemember);
+	}
+	END_FOR_ALL_OBJECTS;
+	GarbageTicks = 0;
+	unguard;
+}
+
+//
+// Spend about Milliseconds on incremental garbage collection. A cycle
+// starts GarbagePeriod ticks after the last one ended, and ends in the
+// first tick after everything it reaches has been scanned.
+//
+void FGlobalObjectManager::TickGarbage( FLOAT Milliseconds )
+{
+	guard(FGlobalObjectManager::TickGarbage);
+	SQWORD StartTime = GApp->MicrosecondTime();
+
+	if( GarbageState == GC_Idle )
+	{
+		// Don't start while files are being loaded, since their objects aren't linked yet.
+		if( ++GarbageTicks<GarbagePeriod || NumAsyncLoads )
+			return;
+		BeginGarbage( GarbageFullEvery<=0 || (GarbageStats.Cycles % GarbageFullEvery)!=0 );
+	}
+	else if( StepGarbage( StartTime + (SQWORD)(Milliseconds * 1000.0) ) )
+	{
+		FinishGarbage( GApp );
+	}
+
+	// Note the pause.
+	FLOAT Pause = ((SQWORD)GApp->MicrosecondTime() - StartTime) / 1000.0;
+	GarbageStats.Pauses++;
+	GarbageStats.LastPause   = Pause;
+	GarbageStats.MaxPause    = Max( GarbageStats.MaxPause, Pause );
+	GarbageStats.TotalPause += Pause;
+
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	UTextBuffer implementation.
 -----------------------------------------------------------------------------*/
@@ -590,11 +590,16 @@ int FPathBuilder::markReachableFromTwo(FPathMarker *path1, FPathMarker *path2)
 	Scout->CollisionRadius = humanRadius;
 	markReachable(path1->Location);  //mark all markers reachable from marker 1
 	int addedmarkers = 0;
-	for (INDEX j=0; j<numMarkers; j++) // add those reachable from marker 2
+	FMemMark Mark(GMem);
+	BYTE *reach = new(GMem,numMarkers)BYTE;
+	for (INDEX j=0; j<numMarkers; j++)
+		reach[j] = !pathMarkers[j].visible && pathMarkers[j].beacon;
+	batchReachable(path2->Location, reach);
+	for (j=0; j<numMarkers; j++) // add those reachable from marker 2
 	{
 		if (!pathMarkers[j].visible && pathMarkers[j].beacon)
 		{
-			pathMarkers[j].visible = fullyReachable(path2->Location, pathMarkers[j].Location);
+			pathMarkers[j].visible = reach[j];
 			if (pathMarkers[j].visible)
 				addedmarkers = 1;
 		}
@@ -605,20 +610,27 @@ int FPathBuilder::markReachableFromTwo(FPathMarker *path1, FPathMarker *path2)
 	if (Scout->CollisionRadius > humanRadius)
 	{
 		for (INDEX i=0; i<numMarkers; i++) 
+			reach[i] = pathMarkers[i].leftTurn;
+		batchReachable(path1->Location, reach);
+		for (i=0; i<numMarkers; i++) 
 		{
 			if (pathMarkers[i].leftTurn) 
-				pathMarkers[i].bigvisible = fullyReachable(path1->Location,pathMarkers[i].Location);
+				pathMarkers[i].bigvisible = reach[i];
 		}
+		for (j=0; j<numMarkers; j++)
+			reach[j] = !pathMarkers[j].bigvisible && pathMarkers[j].leftTurn;
+		batchReachable(path2->Location, reach);
 		for (j=0; j<numMarkers; j++) // add those reachable from marker 2
 		{
 			if (!pathMarkers[j].bigvisible && pathMarkers[j].leftTurn)
 			{
-				pathMarkers[j].bigvisible = fullyReachable(path2->Location, pathMarkers[j].Location);
+				pathMarkers[j].bigvisible = reach[j];
 				if (pathMarkers[j].bigvisible)
 					addedmarkers = 1;
 			}
 		}
 	}
+	Mark.Pop();
 	changeScoutExtent(oldRadius, Scout->CollisionHeight);
 	return addedmarkers;
 	unguard;
@@ -953,11 +965,17 @@ void FPathBuilder::markReachable(const FVector &start)
 {
 	guard(FPathBuilder::markReachable);
 
+	FMemMark Mark(GMem);
+	BYTE *reach = new(GMem,numMarkers)BYTE;
 	for (INDEX i=0; i<numMarkers; i++) 
+		reach[i] = pathMarkers[i].beacon;
+	batchReachable(start, reach);
+	for (i=0; i<numMarkers; i++) 
 	{
 		if (pathMarkers[i].beacon) 
-			pathMarkers[i].visible = fullyReachable(start,pathMarkers[i].Location);
+			pathMarkers[i].visible = reach[i];
 	}
+	Mark.Pop();
 
 	return;
 	unguard;
@@ -975,14 +993,20 @@ void FPathBuilder::markLeftReachable(const FVector &start)
 	if (optlevel == 0)
 		return;
 
-	FCheckResult Hit(1.0);
+	FMemMark Mark(GMem);
+	BYTE *reach = new(GMem,numMarkers)BYTE;
 	for (INDEX i=0; i<numMarkers; i++) 
+		reach[i] = pathMarkers[i].leftTurn;
+	batchReachable(start, reach);
+
+	FCheckResult Hit(1.0);
+	for (i=0; i<numMarkers; i++) 
 	{
 		if (pathMarkers[i].leftTurn) 
 		{
 			pathMarkers[i].visible = 0;
 			pathMarkers[i].routable = 0;
-			if (fullyReachable(start,pathMarkers[i].Location))
+			if (reach[i])
 			{
 				pathMarkers[i].visible = 1;
 				//debugf("Marked %d as reachable", i);
@@ -1551,6 +1575,60 @@ int FPathBuilder::fullyReachable(FVector start,FVector destination)
 	unguard;
 }
 
+//check fullyReachable from start to every marker i with reach[i] set, and set reach[i] to the result
+//the lines of sight which pointReachable would trace are all traced at once first, so that 
+//markers which aren't visible from start are rejected without walking the Scout
+void FPathBuilder::batchReachable(const FVector &start, BYTE *reach)
+{
+	guard(FPathBuilder::batchReachable);
+
+	FMemMark Mark(GMem);
+	FLineCheckRay *rays = new(GMem,numMarkers)FLineCheckRay;
+	INDEX *rayMarker = new(GMem,numMarkers)INDEX;
+	INT numRays = 0;
+
+	//place Scout as fullyReachable does, to find its eye point
+	FVector oldPosition = Scout->Location;
+	changeScoutExtent(Scout->CollisionRadius - 6.0, Scout->CollisionHeight);
+	int placed = Level->FarMoveActor(Scout,start);
+	FVector viewPoint = Scout->Location;
+	viewPoint.Z += Scout->BaseEyeHeight;
+	for (INDEX i=0; i<numMarkers; i++)
+	{
+		if (reach[i] && placed)
+		{
+			FVector Dir2D = pathMarkers[i].Location - Scout->Location;
+			Dir2D.Z = 0.0;
+			if (Level->GetState() == LEVEL_UpPlay && Dir2D.Size() > 800.0)
+				reach[i] = 0;
+			else
+			{
+				rays[numRays].Start = viewPoint;
+				rays[numRays].End = pathMarkers[i].Location;
+				rays[numRays].Extent = FVector(0,0,0);
+				rayMarker[numRays++] = i;
+			}
+		}
+		else reach[i] = 0;
+	}
+	Level->FarMoveActor(Scout,oldPosition, 0, 1);
+	changeScoutExtent(Scout->CollisionRadius + 6.0, Scout->CollisionHeight);
+
+	//trace all lines of sight, then walk to the visible markers
+	Level->Hash.LineCheckBatch(GMem, rays, numRays, 0, Level->GetLevelInfo());
+	for (INT j=0; j<numRays; j++)
+	{
+		i = rayMarker[j];
+		if (rays[j].Clear || rays[j].Hit.Time == 1.0)
+			reach[i] = fullyReachable(start, pathMarkers[i].Location);
+		else
+			reach[i] = 0;
+	}
+	Mark.Pop();
+
+	unguard;
+}
+
 int FPathBuilder::outReachable(FVector start,FVector destination)
 {
 	guard(FPathBuilder::outReachable);
@@ -19,6 +19,7 @@ Revision history:
 -----------------------------------------------------------------------------*/
 
 UNENGINE_API void (*GIntrinsics[EX_Max])( FExecStack &Stack, UObject *Context, BYTE *&Result );
+UNENGINE_API INT GScriptThreaded=0;
 int GIntrinsicDuplicate=0;
 
 /*-----------------------------------------------------------------------------
@@ -213,17 +214,19 @@ void ScriptWarn( BOOL Critical, FExecStack &Stack, char *Fmt, ... )
 -----------------------------------------------------------------------------*/
 
 //warning: Byte order dependencies.
-static union
+// Kept on the stack rather than in a static, so task threads can read code concurrently.
+union FScriptTemp
 {
 	struct			{BYTE B0,B1,B2,B3;};
 	struct			{WORD W0,W1;};
 	INT				I0;
 	DWORD			D0;
 	FLOAT			F0;
-} scriptTemp;
+};
 
 inline INT scriptReadInt( BYTE *&Code )
 {
+	FScriptTemp scriptTemp;
 	scriptTemp.B0 = Code[0];
 	scriptTemp.B1 = Code[1];
 	scriptTemp.B2 = Code[2];
@@ -234,6 +237,7 @@ inline INT scriptReadInt( BYTE *&Code )
 
 inline FLOAT scriptReadFloat( BYTE *&Code )
 {
+	FScriptTemp scriptTemp;
 	scriptTemp.B0 = Code[0];
 	scriptTemp.B1 = Code[1];
 	scriptTemp.B2 = Code[2];
@@ -244,6 +248,7 @@ inline FLOAT scriptReadFloat( BYTE *&Code )
 
 inline INT scriptReadWord( BYTE *&Code )
 {
+	FScriptTemp scriptTemp;
 	scriptTemp.I0 = 0;
 	scriptTemp.B0 = Code[0];
 	scriptTemp.B1 = Code[1];
@@ -253,6 +258,7 @@ inline INT scriptReadWord( BYTE *&Code )
 
 inline FName scriptReadName( BYTE *&Code )
 {
+	FScriptTemp scriptTemp;
 	scriptTemp.B0 = Code[0];
 	scriptTemp.B1 = Code[1];
 	Code += sizeof(FName);
@@ -320,6 +326,10 @@ void UStackTree::PostLoadData( DWORD PostFlags )
 	// Build virtual function hash for the class and for each state.
 	BuildVfHashes( Class, FStackNodePtr(Class,0), HashMemory );
 
+	// Pre-decode the script code for the threaded interpreter.
+	if( GScriptThreaded && Class->Script )
+		Class->Script->BuildThreaded();
+
 	unguardobj;
 }
 void UStackTree::UnloadData()
@@ -337,6 +347,158 @@ void UStackTree::UnloadData()
 	unguardobj;
 }
 
+/*-----------------------------------------------------------------------------
+	Threaded interpreter.
+-----------------------------------------------------------------------------*/
+
+// Object owning the last property variable evaluated, set per thread so that
+// assignments can tell the garbage collector the object was modified.
+static THREAD_LOCAL UObject *GPropObject;
+
+//
+// Evaluate one expression using the script's pre-decoded threaded code.
+// The core expression types are executed inline here with their operands
+// already decoded; everything else falls back to the intrinsic table.
+// Stack.Code is advanced exactly as the intrinsics would advance it, so the
+// two interpreters may be freely mixed.
+//
+void scriptThreadedEval( FExecStack &Stack, UObject *Context, BYTE *&Result )
+{
+	guardSlow(scriptThreadedEval);
+	const FThreadedOp &Op = Stack.Script->Threaded[ Stack.Code - &Stack.Script->Element(0) ];
+	switch( Op.Op )
+	{
+		case TOP_LocalVariable:
+		{
+			Result      = Stack.Locals + Op.Aux;
+			Stack.Code += 1 + sizeof(WORD);
+			GPropObject = NULL;
+			break;
+		}
+		case TOP_ObjectVariable:
+		{
+			Result      = (BYTE*)Context + Op.Aux;
+			Stack.Code += 1 + sizeof(WORD);
+			GPropObject = Context;
+			break;
+		}
+		case TOP_IntConst:
+		{
+			*(INT*)Result = Op.Int;
+			Stack.Code   += Op.Aux;
+			break;
+		}
+		case TOP_FloatConst:
+		{
+			*(FLOAT*)Result = Op.Float;
+			Stack.Code     += 1 + sizeof(FLOAT);
+			break;
+		}
+		case TOP_ByteConst:
+		{
+			*(BYTE*)Result = Op.Int;
+			Stack.Code    += 1 + sizeof(BYTE);
+			break;
+		}
+		case TOP_NameConst:
+		{
+			*(FName*)Result = FName( (EName)Op.Aux );
+			Stack.Code     += 1 + sizeof(FName);
+			break;
+		}
+		case TOP_ObjectConst:
+		{
+			*(UObject**)Result = Op.Object;
+			Stack.Code        += Op.Aux;
+			break;
+		}
+		case TOP_Self:
+		{
+			*(UObject**)Result = Context;
+			Stack.Code++;
+			break;
+		}
+		case TOP_Nothing:
+		{
+			Stack.Code++;
+			break;
+		}
+		case TOP_Jump:
+		{
+			Stack.Code = &Stack.Script->Element( Op.Aux );
+			break;
+		}
+		case TOP_JumpIfNot:
+		{
+			// Evaluation may execute arbitrary code, so grab the offset first.
+			INT wOffset = Op.Aux;
+			Stack.Code += 1 + sizeof(WORD);
+
+			BYTE Buffer[MAX_CONST_SIZE], *Val=Buffer;
+			scriptEval( Stack, Stack.Object, Val );
+			if( !*(DWORD*)Val )
+				Stack.Code = &Stack.Script->Element(wOffset);
+			break;
+		}
+		case TOP_Let:
+		{
+			INT Size = Op.Aux;
+			Stack.Code += 1 + sizeof(BYTE);
+
+			BYTE *Var=NULL;
+			GPropObject = NULL;
+			scriptEval( Stack, Stack.Object, Var );
+			UObject *Owner = GPropObject;
+			BYTE Buffer[MAX_CONST_SIZE], *Val=Buffer;
+			scriptEval( Stack, Stack.Object, Val );
+			if( Var )
+			{
+				memcpy( Var, Val, Size );
+				if( Owner )
+					GObj.WriteBarrier( Owner );
+			}
+			break;
+		}
+		case TOP_Let1:
+		{
+			Stack.Code++;
+
+			BYTE *Var=NULL;
+			scriptEval( Stack, Stack.Object, Var );
+			BYTE Buffer[1], *Val=Buffer;
+			scriptEval( Stack, Stack.Object, Val );
+			if( Var )
+				*(BYTE*)Var = *(BYTE*)Val;
+			break;
+		}
+		case TOP_Let4:
+		{
+			Stack.Code++;
+
+			BYTE *Var=NULL;
+			GPropObject = NULL;
+			scriptEval( Stack, Stack.Object, Var );
+			UObject *Owner = GPropObject;
+			BYTE Buffer[4], *Val=Buffer;
+			scriptEval( Stack, Stack.Object, Val );
+			if( Var )
+			{
+				*(DWORD*)Var = *(DWORD*)Val;
+				if( Owner )
+					GObj.WriteBarrier( Owner );
+			}
+			break;
+		}
+		default:
+		{
+			// Not pre-decoded.
+			(*GIntrinsics[*Stack.Code++])( Stack, Context, Result );
+			break;
+		}
+	}
+	unguardexecSlow;
+}
+
 /*-----------------------------------------------------------------------------
 	FExecStackMain.
 -----------------------------------------------------------------------------*/
@@ -451,7 +613,8 @@ int AActor::GotoState( FName NewState )
 	if( State!=NAME_None && NewState!=State && IsProbing(NAME_EndState) )
 		Process( NAME_EndState, NULL );
 
-	// Go there.
+	// Go there. Virtual function call site caches are keyed on MainStack.Link,
+	// so this also invalidates the actor's cached function lookups.
 	FName OldState   = State;
 	State			 = NewState;
 	MainStack.Link	 = NodePtr;
@@ -523,8 +686,9 @@ void AActor::BeginExecution()
 	Intrinsics.
 -----------------------------------------------------------------------------*/
 
-DWORD  *GBoolAddr;
-DWORD  GBoolMask;
+// Bool variable address and mask, set per thread by EX_BoolVariable.
+static THREAD_LOCAL DWORD *GBoolAddr;
+static THREAD_LOCAL DWORD GBoolMask;
 
 /////////////////////////////////
 // Undefined intrinsic handler //
@@ -552,6 +716,7 @@ static void execLocalVariable( FExecStack &Stack, UObject *Context, BYTE *&Resul
 	debugState(Stack.Object==Context);
 	debugState(Stack.Locals!=NULL);
 	Result = Stack.Locals + scriptReadWord(Stack.Code);
+	GPropObject = NULL;
 	unguardexecSlow;
 }
 AUTOREGISTER_INTRINSIC( EX_LocalVariable, execLocalVariable );
@@ -561,6 +726,7 @@ static void execObjectVariable( FExecStack &Stack, UObject *Context, BYTE *&Resu
 	// Execute an object variable.
 	guardSlow(execObjectVariable);
 	Result = (BYTE*)Context + scriptReadWord(Stack.Code);
+	GPropObject = Context;
 	unguardexecSlow;
 }
 AUTOREGISTER_INTRINSIC( EX_ObjectVariable, execObjectVariable );
@@ -570,6 +736,7 @@ static void execStaticVariable( FExecStack &Stack, UObject *Context, BYTE *&Resu
 	// Execute a static variable.
 	guardSlow(execStaticVariable);
 	Result = &Context->GetClass()->Bins[PROPBIN_PerClass]->Element(0) + scriptReadWord(Stack.Code);
+	GPropObject = Context->GetClass()->Bins[PROPBIN_PerClass];
 	unguardexecSlow;
 }
 AUTOREGISTER_INTRINSIC( EX_StaticVariable, execStaticVariable );
@@ -579,6 +746,7 @@ static void execDefaultVariable( FExecStack &Stack, UObject *Context, BYTE *&Res
 	// Execute a default variable.
 	guardSlow(execDefaultVariable);
 	Result = &Context->GetClass()->Bins[PROPBIN_PerObject]->Element(0) + scriptReadWord(Stack.Code);
+	GPropObject = Context->GetClass()->Bins[PROPBIN_PerObject];
 	unguardexecSlow;
 }
 AUTOREGISTER_INTRINSIC( EX_DefaultVariable, execDefaultVariable );
@@ -589,10 +757,12 @@ static void execArrayElement( FExecStack &Stack, UObject *Context, BYTE *&Result
 
 	// Get base pointer.
 	(*GIntrinsics[*Stack.Code++])( Stack, Context, Result );
+	UObject *Owner = GPropObject;
 
 	// Get array offset.
 	BYTE Buffer[MAX_CONST_SIZE], *Addr=Buffer;
 	(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, Addr );
+	GPropObject = Owner;
 
 	// Add scaled offset to base pointer.
 	Result += *(INT*)Addr * *Stack.Code++;
@@ -836,17 +1006,23 @@ static void execLet( FExecStack &Stack, UObject *Context, BYTE *&Result )
 	// Get size.
 	BYTE Size = *Stack.Code++;
 
-	// Get variable address.
+	// Get variable address, and the object it's in.
 	BYTE *Var=NULL;
+	GPropObject = NULL;
 	(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, Var );
+	UObject *Owner = GPropObject;
 
 	// Get value.
 	BYTE Buffer[MAX_CONST_SIZE], *Val=Buffer;
 	(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, Val );
 
-	// Copy value to variable.
+	// Copy value to variable, and note that the object may reference something new.
 	if( Var )
+	{
 		memcpy( Var, Val, Size );
+		if( Owner )
+			GObj.WriteBarrier( Owner );
+	}
 
 	unguardexecSlow;
 }
@@ -878,17 +1054,23 @@ static void execLet4( FExecStack &Stack, UObject *Context, BYTE *&Result )
 	// Execute EX_Let4.
 	guardSlow(execLet4);
 
-	// Get variable address.
+	// Get variable address, and the object it's in.
 	BYTE *Var=NULL;
+	GPropObject = NULL;
 	(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, Var );
+	UObject *Owner = GPropObject;
 
 	// Get value.
 	BYTE Buffer[4], *Val=Buffer;
 	(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, Val );
 
-	// Copy value to variable.
+	// Copy value to variable, and note that the object may reference something new.
 	if( Var )
+	{
 		*(DWORD*)Var = *(DWORD*)Val;
+		if( Owner )
+			GObj.WriteBarrier( Owner );
+	}
 
 	unguardexecSlow;
 }
@@ -1004,126 +1186,131 @@ AUTOREGISTER_INTRINSIC( EX_Context, execContext );
 // Function calls //
 ////////////////////
 
-static void execVirtualFunction( FExecStack &Stack, UObject *Context, BYTE *&Result )
+//
+// Virtual function call site cache.  Maps a call site plus the calling
+// object's class and current state to the function it resolves to, so
+// repeated calls skip the virtual function hash.  Each line holds two
+// entries, for call sites which see a few different classes or states.
+//
+struct FVfCacheEntry
 {
-	guardSlow(execVirtualFunction);
-	debugInput(Context!=NULL);
+	BYTE*			Site;		// Call site, the EX_VirtualFunction operand in script code.
+	UClass*			Class;		// Class of the calling context.
+	FStackNodePtr	Scope;		// Class or state stack node the context was in.
+	FStackNodePtr	Node;		// Function the call resolved to.
+};
+enum {VF_CACHE_LINES=1024};
+static FVfCacheEntry GVfCache[VF_CACHE_LINES][2];
 
-	INT IsState = Context->IsA("Actor") && ((AActor*)Context)->State!=NAME_None;
+//
+// Flush the virtual function call site cache.  Must be called whenever
+// script code or stack trees are replaced or unloaded.
+//
+void scriptFlushVfCache()
+{
+	guard(scriptFlushVfCache);
+	memset( GVfCache, 0, sizeof(GVfCache) );
+	unguard;
+}
 
-	// Get virtual function name.
-	FName Message = scriptReadName(Stack.Code);
+//
+// Find a virtual function in the context's state scope or global scope.
+// Returns a NULL link if not found.
+//
+static FStackNodePtr FindVirtualFunction( UObject *Context, FName Message )
+{
+	guardSlow(FindVirtualFunction);
+	INT IsState = Context->IsA("Actor") && ((AActor*)Context)->State!=NAME_None;
 
-	// Find the virtual function in state scope or global scope.
 	// Traverse the current stack node to find the specified function.
 	FStackNodePtr ParentLink = Context->MainStack.Link;
-	Recheck:
-
-	// Find function from virtual function hash.
-	for( FStackNodePtr Node = ParentLink->VfHash[Message.GetIndex() & (FStackNode::HASH_COUNT-1)]; Node.Class; Node=Node->HashNext )
-		if( Node->Name == Message )
-			break;
-
-	// Find function by linearly searching the list.	
-	if( Node.Class )
+	for( ; ; )
 	{
-		// Found it.
-		if( Node->iIntrinsic )
-		{
-			// Virtual intrinsic function.
-			(*GIntrinsics[ Node->iIntrinsic ])( Stack, Context, Result);
-		}
-		else
-		{
-			// Virtual scripted function.
-			FMemMark Mark(GMem);
-			debugState(Node->iCode!=MAXWORD);
-			FExecStack NewStack( Context, Node, new(GMem,MEM_Zeroed,Node->LocalsSize)BYTE );
-
-			// Form the parms.
-			BYTE *Dest = NewStack.Locals;
-			FOutParmRec Outs[MAX_FUNC_PARMS], *Out = Outs;
-			while( (Out->Size = *NewStack.Code++) != 0 )
-			{
-				debugState(*NewStack.Code==0 || *NewStack.Code==1);
-				Out->Src = Out->Dest = Dest;
-				(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, Out->Dest );
-				if( Out->Dest != Dest )
-					memcpy( Dest, Out->Dest, Out->Size );
-				Dest += Out->Size;
-				Out  += *NewStack.Code++;
-			}
-			debugState(*Stack.Code==EX_EndFunctionParms);
-			Stack.Code++;
-
-			// Execute the code.
-			if( Context->IsProbing( Node->Name ) )
-			{
-				if( !(Node->StackNodeFlags & SNODE_SingularFunc) )
-				{
-					BYTE Buffer[MAX_STRING_CONST_SIZE], *Addr, B;
-					while( (B = *NewStack.Code++) != EX_Return )
-						(*GIntrinsics[B])( NewStack, NewStack.Object, Addr=Buffer );
-				}
-				else if( !(Context->GetFlags() & RF_InSingularFunc) )
-				{
-					Context->SetFlags(RF_InSingularFunc);
-					BYTE Buffer[MAX_STRING_CONST_SIZE], *Addr, B;
-					while( (B = *NewStack.Code++) != EX_Return )
-						(*GIntrinsics[B])( NewStack, NewStack.Object, Addr=Buffer );
-					Context->ClearFlags(RF_InSingularFunc);
-				}
-			}
-
-			// Copy back outparms.
-			while( --Out >= Outs )
-				memcpy( Out->Dest, Out->Src, Out->Size );
-
-			// Snag return offset and finish.
-			Result = &NewStack.Locals[Node->CodeLabelOffset];
+		// Find function from virtual function hash.
+		for( FStackNodePtr Node = ParentLink->VfHash[Message.GetIndex() & (FStackNode::HASH_COUNT-1)]; Node.Class; Node=Node->HashNext )
+			if( Node->Name == Message )
+				return Node;
 
-			// Release temp memory.
-			Mark.Pop();
-		}
-		return;
-	}
-	if( IsState )
-	{
 		// Failed to find a state version of the function, so check for a global version.
+		if( !IsState )
+			return FStackNodePtr(NULL,0);
 		IsState    = 0;
 		ParentLink = FStackNodePtr( Context->GetClass(), 0 );
-		goto Recheck;
 	}
+	unguardSlow;
+}
 
-	// This should never occur.
-	ScriptWarn( 1, Stack, "Virtual function '%s' not found", Message() );
-	unguardexecSlow;
+//
+// Return whether a frame variable of a type must start out zeroed, because
+// garbage in it isn't safe to use: strings must be terminated, and names
+// and object references must be valid.
+//
+static inline INT MustZero( const FProperty &Property )
+{
+	return Property.Type==CPT_String || Property.Type==CPT_Object || Property.Type==CPT_Name;
 }
-AUTOREGISTER_INTRINSIC( EX_VirtualFunction, execVirtualFunction );
 
-static void execFinalFunction( FExecStack &Stack, UObject *Context, BYTE *&Result )
+//
+// Call a scripted function in Context.  The caller's parms are evaluated
+// straight into the new stack frame.  Only the frame variables which must
+// start out zeroed are zeroed: skipped parms, string parms (whose
+// expressions needn't fill the slot), and string, name and object locals
+// and return values.  Out parms are written back only when the caller
+// passed a variable.
+//
+static void CallScriptFunction( FExecStack &Stack, UObject *Context, FStackNodePtr Link, BYTE *&Result )
 {
-	guardSlow(execFinalFunction);
+	guardSlow(CallScriptFunction);
 
-	// Make new stack frame in the current actor context.
+	// Make new stack frame in the context.
 	FMemMark Mark(GMem);
-	FStackNodePtr NewLink = scriptReadStackNodeLink(Stack.Code);
-	FStackNode&   Node    = *NewLink;
-	FExecStack NewStack( Context, NewLink, new(GMem,MEM_Zeroed,Node.LocalsSize)BYTE );
+	FStackNode& Node = *Link;
 	debugState(Node.iCode!=MAXWORD);
+	FExecStack NewStack( Context, Link, new(GMem,Node.LocalsSize)BYTE );
+
+	// Zero the return value and locals which must be.
+	FProperty *Properties = Node.NumProperties ? &Link.Class->Element(Node.iFirstProperty) : NULL;
+	for( INT i=0; i<Node.NumProperties; i++ )
+		if( !(Properties[i].Flags & CPF_Parm) || (Properties[i].Flags & CPF_ReturnParm) )
+			if( MustZero(Properties[i]) )
+				memset( NewStack.Locals + Properties[i].Offset, 0, Properties[i].Size() );
 
 	// Form the parms.
 	BYTE *Dest = NewStack.Locals;
 	FOutParmRec Outs[MAX_FUNC_PARMS], *Out = Outs;
-	while( (Out->Size = *NewStack.Code++) != 0 )
+	FProperty *Parm = Properties;
+	BYTE Size;
+	while( (Size = *NewStack.Code++) != 0 )
 	{
 		debugState(*NewStack.Code==0 || *NewStack.Code==1);
-		Out->Src = Out->Dest = Dest;
-		(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, Out->Dest );
-		if( Out->Dest != Dest )
-			memcpy( Dest, Out->Dest, Out->Size );
-		Dest += Out->Size;
-		Out  += *NewStack.Code++;
+		if( *Stack.Code == EX_Nothing )
+		{
+			// Optional parm which wasn't specified.
+			Stack.Code++;
+			memset( Dest, 0, Size );
+		}
+		else
+		{
+			// Evaluate into the frame, or copy in from a variable.
+			BYTE *Addr = Dest;
+			if( Parm->Type == CPT_String )
+				memset( Dest, 0, Size );
+			scriptEval( Stack, Stack.Object, Addr );
+			if( Addr != Dest )
+			{
+				memcpy( Dest, Addr, Size );
+				if( *NewStack.Code )
+				{
+					Out->Dest = Addr;
+					Out->Src  = Dest;
+					Out->Size = Size;
+					Out++;
+				}
+			}
+		}
+		Dest += Size;
+		NewStack.Code++;
+		Parm++;
 	}
 	debugState(*Stack.Code==EX_EndFunctionParms);
 	Stack.Code++;
@@ -1133,27 +1320,118 @@ static void execFinalFunction( FExecStack &Stack, UObject *Context, BYTE *&Resul
 	{
 		if( !(Node.StackNodeFlags & SNODE_SingularFunc) )
 		{
-			BYTE Buffer[MAX_STRING_CONST_SIZE], *Addr, B;
-			while( (B = *NewStack.Code++) != EX_Return )
-				(*GIntrinsics[B])( NewStack, NewStack.Object, Addr=Buffer );
+			BYTE Buffer[MAX_STRING_CONST_SIZE], *Addr;
+			while( *NewStack.Code != EX_Return )
+				scriptEval( NewStack, NewStack.Object, Addr=Buffer );
+			NewStack.Code++;
 		}
 		else if( !(Context->GetFlags() & RF_InSingularFunc) )
 		{
 			Context->SetFlags(RF_InSingularFunc);
-			BYTE Buffer[MAX_STRING_CONST_SIZE], *Addr, B;
-			while( (B = *NewStack.Code++) != EX_Return )
-				(*GIntrinsics[B])( NewStack, NewStack.Object, Addr=Buffer );
+			BYTE Buffer[MAX_STRING_CONST_SIZE], *Addr;
+			while( *NewStack.Code != EX_Return )
+				scriptEval( NewStack, NewStack.Object, Addr=Buffer );
+			NewStack.Code++;
 			Context->ClearFlags(RF_InSingularFunc);
 		}
 	}
 
-	// Copy back outparms.
+	// Write back outparms which were passed as variables.
 	while( --Out >= Outs )
 		memcpy( Out->Dest, Out->Src, Out->Size );
 
 	// Snag return offset and finish.
 	Result = &NewStack.Locals[Node.CodeLabelOffset];
+
+	// Release temp memory.
 	Mark.Pop();
+	unguardSlow;
+}
+
+static void execVirtualFunction( FExecStack &Stack, UObject *Context, BYTE *&Result )
+{
+	guardSlow(execVirtualFunction);
+	debugInput(Context!=NULL);
+
+	// Get virtual function name.
+	BYTE* Site    = Stack.Code;
+	FName Message = scriptReadName(Stack.Code);
+
+	// Look up the function in the call site cache.
+	FStackNodePtr  Scope = Context->MainStack.Link;
+	UClass*        Class = Context->GetClass();
+	FVfCacheEntry* Line  = GVfCache[ ((DWORD)Site ^ ((DWORD)Site >> 10)) & (VF_CACHE_LINES-1) ];
+	FStackNodePtr  Node;
+	if( GTaskPool.Running )
+	{
+		// Task threads can't share the cache, so search the hash.
+		Node = FindVirtualFunction( Context, Message );
+	}
+	else if
+	(	Line[0].Site        == Site
+	&&	Line[0].Class       == Class
+	&&	Line[0].Scope.Class == Scope.Class
+	&&	Line[0].Scope.iNode == Scope.iNode )
+	{
+		// Hit.
+		Node = Line[0].Node;
+		GServer.VfCacheHits++;
+	}
+	else if
+	(	Line[1].Site        == Site
+	&&	Line[1].Class       == Class
+	&&	Line[1].Scope.Class == Scope.Class
+	&&	Line[1].Scope.iNode == Scope.iNode )
+	{
+		// Hit in second entry, so move it to the front.
+		Exchange( Line[0], Line[1] );
+		Node = Line[0].Node;
+		GServer.VfCacheHits++;
+	}
+	else
+	{
+		// Miss, so search the hash and remember the result.
+		Node = FindVirtualFunction( Context, Message );
+		GServer.VfCacheMisses++;
+		if( Node.Class )
+		{
+			Line[1]       = Line[0];
+			Line[0].Site  = Site;
+			Line[0].Class = Class;
+			Line[0].Scope = Scope;
+			Line[0].Node  = Node;
+		}
+	}
+
+	// Call the function.
+	if( Node.Class )
+	{
+		if( Node->iIntrinsic )
+		{
+			// Virtual intrinsic function.
+			(*GIntrinsics[ Node->iIntrinsic ])( Stack, Context, Result);
+		}
+		else
+		{
+			// Virtual scripted function.
+			CallScriptFunction( Stack, Context, Node, Result );
+		}
+		return;
+	}
+
+	// This should never occur.
+	ScriptWarn( 1, Stack, "Virtual function '%s' not found", Message() );
+	unguardexecSlow;
+}
+AUTOREGISTER_INTRINSIC( EX_VirtualFunction, execVirtualFunction );
+
+static void execFinalFunction( FExecStack &Stack, UObject *Context, BYTE *&Result )
+{
+	guardSlow(execFinalFunction);
+
+	// Call the prebound function in the current actor context.
+	CallScriptFunction( Stack, Context, scriptReadStackNodeLink(Stack.Code), Result );
+
 	unguardexecSlow;
 }
 AUTOREGISTER_INTRINSIC( EX_FinalFunction, execFinalFunction );
@@ -4361,8 +4639,9 @@ AUTOREGISTER_INTRINSIC( EX_Iterator, execIterator );
 	BYTE *StartCode = Stack.Code; \
 	do {
 #define POST_ITERATOR \
-		while( (B = *Stack.Code++)!=EX_IteratorPop && B!=EX_IteratorNext ) \
-			(*GIntrinsics[B])( Stack, Stack.Object, Addr=Buffer ); \
+		while( (B = *Stack.Code)!=EX_IteratorPop && B!=EX_IteratorNext ) \
+			scriptEval( Stack, Stack.Object, Addr=Buffer ); \
+		Stack.Code++; \
 		if( B==EX_IteratorNext ) \
 			Stack.Code = StartCode; \
 	} while( B != EX_IteratorPop ); \
@@ -4837,8 +5116,9 @@ void UObject::Process( FName Message, PMessageParms *Parms )
 
 			// Create a new local execution stack.
 			FMemMark Mark(GMem);
-			FExecStack NewStack( this, Link, new(GMem,MEM_Zeroed,Node.LocalsSize)BYTE );
+			FExecStack NewStack( this, Link, new(GMem,Node.LocalsSize)BYTE );
 			memcpy( NewStack.Locals, Parms, Node.ParmsSize );
+			memset( NewStack.Locals + Node.ParmsSize, 0, Node.LocalsSize - Node.ParmsSize );
 
 			// Skip the parm info in the script code.
 			while( *NewStack.Code++ != 0 )
@@ -4847,16 +5127,18 @@ void UObject::Process( FName Message, PMessageParms *Parms )
 			// Execute the script code.
 			if( !(Node.StackNodeFlags & SNODE_SingularFunc) )
 			{
-				BYTE Buffer[MAX_CONST_SIZE], *Addr, B;
-				while( (B = *NewStack.Code++) != EX_Return )
-					(*GIntrinsics[B])( NewStack, this, Addr=Buffer );
+				BYTE Buffer[MAX_CONST_SIZE], *Addr;
+				while( *NewStack.Code != EX_Return )
+					scriptEval( NewStack, this, Addr=Buffer );
+				NewStack.Code++;
 			}
 			else if( !(GetFlags() & RF_InSingularFunc) )
 			{
 				SetFlags(RF_InSingularFunc);
-				BYTE Buffer[MAX_CONST_SIZE], *Addr, B;
-				while( (B = *NewStack.Code++) != EX_Return )
-					(*GIntrinsics[B])( NewStack, this, Addr=Buffer );
+				BYTE Buffer[MAX_CONST_SIZE], *Addr;
+				while( *NewStack.Code != EX_Return )
+					scriptEval( NewStack, this, Addr=Buffer );
+				NewStack.Code++;
 				ClearFlags(RF_InSingularFunc);
 			}
 
@@ -4888,31 +5170,145 @@ void UObject::Process( FName Message, PMessageParms *Parms )
 -----------------------------------------------------------------------------*/
 
 //
-// Serialize an expression to an archive.
-// Returns expression token.
+// Pre-decode the expression at iCode for the threaded interpreter.
+// Leaves the op as TOP_Intrinsic if it isn't a core expression type.
+//
+static void DecodeThreadedOp( UScript *Script, INT iCode, FThreadedOp &Op )
+{
+	guard(DecodeThreadedOp);
+	BYTE *Code = &Script->Element(iCode);
+	switch( *Code++ )
+	{
+		case EX_LocalVariable:	Op.Op=TOP_LocalVariable;	Op.Aux=scriptReadWord(Code);						break;
+		case EX_ObjectVariable:	Op.Op=TOP_ObjectVariable;	Op.Aux=scriptReadWord(Code);						break;
+		case EX_Jump:			Op.Op=TOP_Jump;				Op.Aux=scriptReadWord(Code);						break;
+		case EX_JumpIfNot:		Op.Op=TOP_JumpIfNot;		Op.Aux=scriptReadWord(Code);						break;
+		case EX_Let:			Op.Op=TOP_Let;				Op.Aux=*Code;										break;
+		case EX_Let1:			Op.Op=TOP_Let1;																	break;
+		case EX_Let4:			Op.Op=TOP_Let4;																	break;
+		case EX_IntConst:		Op.Op=TOP_IntConst;			Op.Aux=1+sizeof(INT);	Op.Int=scriptReadInt(Code);	break;
+		case EX_IntConstByte:	Op.Op=TOP_IntConst;			Op.Aux=1+sizeof(BYTE);	Op.Int=*Code;				break;
+		case EX_IntZero:		Op.Op=TOP_IntConst;			Op.Aux=1;				Op.Int=0;					break;
+		case EX_IntOne:			Op.Op=TOP_IntConst;			Op.Aux=1;				Op.Int=1;					break;
+		case EX_True:			Op.Op=TOP_IntConst;			Op.Aux=1;				Op.Int=1;					break;
+		case EX_False:			Op.Op=TOP_IntConst;			Op.Aux=1;				Op.Int=0;					break;
+		case EX_FloatConst:		Op.Op=TOP_FloatConst;		Op.Float=scriptReadFloat(Code);						break;
+		case EX_ByteConst:		Op.Op=TOP_ByteConst;		Op.Int=*Code;										break;
+		case EX_NameConst:		Op.Op=TOP_NameConst;		Op.Aux=scriptReadName(Code).GetIndex();				break;
+		case EX_ObjectConst:	Op.Op=TOP_ObjectConst;		Op.Aux=1+sizeof(INT);	Op.Object=(UObject*)scriptReadInt(Code); break;
+		case EX_NoObject:		Op.Op=TOP_ObjectConst;		Op.Aux=1;				Op.Object=NULL;				break;
+		case EX_Self:			Op.Op=TOP_Self;																	break;
+		case EX_Nothing:		Op.Op=TOP_Nothing;																break;
+		default:				Op.Op=TOP_Intrinsic;															break;
+	}
+	unguard;
+}
+
+// Set while ReachesOtherObjects walks a script, and the number of
+// expressions it found which could reach outside the object's owner tree.
+static INT GScanReach=0, GReachExprs=0;
+
+//
+// Whether an intrinsic only computes a value or changes the actor calling
+// it, so that code calling it can be ticked in parallel. Everything else,
+// like spawning, moving, tracing, iterating over actors, sounds and logging,
+// reaches other actors or engine state.
 //
-static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
+static INT IsSelfIntrinsic( INT iIntrinsic )
+{
+	// Operators and math functions, apart from Log, Warn and Error.
+	if( iIntrinsic>=129 && iIntrinsic<=255 )
+		return iIntrinsic<0x80+103 || iIntrinsic>0x80+105;
+	switch( iIntrinsic )
+	{
+		case 112: case 113: case 114: case 115: case 116: case 117: case 118:	// Goto, states and probes.
+		case 256: case 261: case 301:											// Sleep, FinishAnim, FinishInterpolation.
+		case 258:																// ClassIsChildOf.
+		case 259: case 260: case 282: case 294:									// Animation.
+		case 275: case 276: case 287: case 288: case 289: case 290: case 291:	// Vector and rotation math.
+		case 296: case 297: case 300:
+		case 279:																// Destroy, which is deferred.
+		case 280: case 281:														// SetTimer, SetTickRate.
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+//
+// Whether a virtual function call in a class's script could reach an
+// intrinsic which isn't self-contained.
+//
+static INT CallsOtherIntrinsic( UClass *Class, FName Name )
+{
+	for( ; Class; Class=Class->ParentClass )
+	{
+		if( !Class->StackTree )
+			continue;
+		for( INT i=0; i<Class->StackTree->Num; i++ )
+		{
+			FStackNode &Node = Class->StackTree->Element(i);
+			if
+			(	Node.NestType==NEST_Function
+			&&	Node.Name==Name
+			&&	(Node.StackNodeFlags & SNODE_IntrinsicFunc)
+			&&	!IsSelfIntrinsic(Node.iIntrinsic) )
+				return 1;
+		}
+	}
+	return 0;
+}
+
+//
+// Whether a variable expression uses state shared outside the actor's owner
+// tree: Static and default variables, which all actors of the class share,
+// and references to objects other than the actor's owner.
+//
+static INT IsSharedVariable( UScript *Script, EExprToken Expr, INT Offset )
+{
+	if( Expr==EX_StaticVariable || Expr==EX_DefaultVariable )
+		return 1;
+	if( Expr==EX_ObjectVariable && Offset!=STRUCT_OFFSET(AActor,Owner) )
+		for( FPropertyIterator It(Script->Class); It; ++It )
+			if( It().Bin==PROPBIN_PerObject && It().Offset==Offset )
+				return It().Type==CPT_Object;
+	return 0;
+}
+
+//
+// Serialize an expression to an archive, and optionally pre-decode it
+// for the threaded interpreter. Returns expression token.
+//
+static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar, FThreadedOp *Ops )
 {
 	guard(SerializeExpr);
 
+	// Pre-decode for the threaded interpreter, if desired.
+	if( Ops )
+		DecodeThreadedOp( Script, iCode, Ops[iCode] );
+
 	// Get expr token.
 	Ar << Script->Element(iCode);
 	EExprToken Expr = (EExprToken)Script->Element(iCode++);
 	if( Expr >= EX_MinConversion && Expr < EX_MaxConversion )
 	{
 		// A type conversion.
-		SerializeExpr( Script, iCode, Ar );
+		SerializeExpr( Script, iCode, Ar, Ops );
 	}
 	else if( Expr >= EX_FirstIntrinsic )
 	{
 		// Intrinsic final function with id 1-127.
-		while( SerializeExpr( Script, iCode, Ar ) != EX_EndFunctionParms );
+		if( GScanReach && !IsSelfIntrinsic(Expr) )
+			GReachExprs++;
+		while( SerializeExpr( Script, iCode, Ar, Ops ) != EX_EndFunctionParms );
 	}
 	else if( Expr >= EX_ExtendedIntrinsic )
 	{
 		// Intrinsic final function with id 128-16383.
 		Ar << Script->Element(iCode++);
-		while( SerializeExpr( Script, iCode, Ar ) != EX_EndFunctionParms );
+		if( GScanReach && !IsSelfIntrinsic( 256*(INT)(Expr-EX_ExtendedIntrinsic) + Script->Element(iCode-1) ) )
+			GReachExprs++;
+		while( SerializeExpr( Script, iCode, Ar, Ops ) != EX_EndFunctionParms );
 	}
 	else switch( Expr )
 	{
@@ -4922,7 +5318,10 @@ static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
 		case EX_UnusedVariable:
 		case EX_DefaultVariable:
 		{
-			Ar << *(WORD*)&Script->Element(iCode); iCode+=sizeof(WORD);
+			Ar << *(WORD*)&Script->Element(iCode);
+			if( GScanReach && IsSharedVariable( Script, Expr, *(WORD*)&Script->Element(iCode) ) )
+				GReachExprs++;
+			iCode+=sizeof(WORD);
 			break;
 		}
 		case EX_BoolVariable:
@@ -4930,6 +5329,8 @@ static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
 			Ar << Script->Element(iCode);
 			Expr = (EExprToken)(Script->Element(iCode++) >> 5);
 			checkState( Expr==EX_LocalVariable || Expr==EX_ObjectVariable || Expr==EX_StaticVariable || Expr==EX_DefaultVariable );
+			if( GScanReach && IsSharedVariable( Script, Expr, *(WORD*)&Script->Element(iCode) ) )
+				GReachExprs++;
 			Ar << *(WORD*)&Script->Element(iCode); iCode+=sizeof(WORD);
 			break;
 		}
@@ -4951,30 +5352,41 @@ static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
 		}
 		case EX_Context:
 		{
-			SerializeExpr( Script, iCode, Ar );              // Actor expression.
+			GReachExprs++;
+			SerializeExpr( Script, iCode, Ar, Ops );              // Actor expression.
 			Ar << *(WORD*)&Script->Element(iCode); iCode+=2; // Skip offset.
 			Ar << *(BYTE*)&Script->Element(iCode++);         // Skip size.
-			SerializeExpr( Script, iCode, Ar );              // Context expression.
+			SerializeExpr( Script, iCode, Ar, Ops );              // Context expression.
 			break;
 		}
 		case EX_ArrayElement:
 		{
-			SerializeExpr( Script, iCode, Ar );
-			SerializeExpr( Script, iCode, Ar );
+			SerializeExpr( Script, iCode, Ar, Ops );
+			SerializeExpr( Script, iCode, Ar, Ops );
 			Ar << Script->Element(iCode++);
 			Ar << Script->Element(iCode++);
 			break;
 		}
 		case EX_VirtualFunction:
 		{
-			Ar << *(FName *)&Script->Element(iCode); iCode+=sizeof(FName);
-			while( SerializeExpr( Script, iCode, Ar ) != EX_EndFunctionParms );
+			Ar << *(FName *)&Script->Element(iCode);
+			if( GScanReach && CallsOtherIntrinsic( Script->Class, *(FName *)&Script->Element(iCode) ) )
+				GReachExprs++;
+			iCode+=sizeof(FName);
+			while( SerializeExpr( Script, iCode, Ar, Ops ) != EX_EndFunctionParms );
 			break;
 		}
 		case EX_FinalFunction:
 		{
-			Ar << *(FStackNodePtr*)&Script->Element(iCode); iCode+=sizeof(FStackNodePtr);
-			while( SerializeExpr( Script, iCode, Ar ) != EX_EndFunctionParms );
+			Ar << *(FStackNodePtr*)&Script->Element(iCode);
+			if( GScanReach )
+			{
+				FStackNodePtr Link = *(FStackNodePtr*)&Script->Element(iCode);
+				if( (Link->StackNodeFlags & SNODE_IntrinsicFunc) && !IsSelfIntrinsic(Link->iIntrinsic) )
+					GReachExprs++;
+			}
+			iCode+=sizeof(FStackNodePtr);
+			while( SerializeExpr( Script, iCode, Ar, Ops ) != EX_EndFunctionParms );
 			break;
 		}
 		case EX_IntConst:
@@ -5023,7 +5435,7 @@ static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
 		case EX_ResizeString:
 		{
 			Ar << Script->Element(iCode++);
-			SerializeExpr( Script, iCode, Ar );
+			SerializeExpr( Script, iCode, Ar, Ops );
 			break;
 		}
 		case EX_IntConstByte:
@@ -5034,25 +5446,25 @@ static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
 		case EX_ActorCast:
 		{
 			Ar << *(UClass **)&Script->Element(iCode); iCode+=sizeof(UClass*);
-			SerializeExpr( Script, iCode, Ar );
+			SerializeExpr( Script, iCode, Ar, Ops );
 			break;
 		}
 		case EX_JumpIfNot:
 		{
 			Ar << *(WORD*)&Script->Element(iCode); iCode+=2; // Code offset.
-			SerializeExpr( Script, iCode, Ar );              // Boolean expr.
+			SerializeExpr( Script, iCode, Ar, Ops );              // Boolean expr.
 			break;
 		}
 		case EX_Iterator:
 		{
-			SerializeExpr( Script, iCode, Ar );              // Iterator expr.
+			SerializeExpr( Script, iCode, Ar, Ops );              // Iterator expr.
 			Ar << *(WORD*)&Script->Element(iCode); iCode+=2; // Code offset.
 			break;
 		}
 		case EX_Switch:
 		{
 			Ar << Script->Element(iCode++);     // Size.
-			SerializeExpr( Script, iCode, Ar ); // Switch expr.
+			SerializeExpr( Script, iCode, Ar, Ops ); // Switch expr.
 			break;
 		}
 		case EX_Jump:
@@ -5063,13 +5475,13 @@ static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
 		case EX_Assert:
 		{
 			Ar << *(WORD*)&Script->Element(iCode); iCode += 2; // Line number.
-			SerializeExpr( Script, iCode, Ar );                // Assert expr.
+			SerializeExpr( Script, iCode, Ar, Ops );                // Assert expr.
 			break;
 		}
 		case EX_Case:
 		{
 			WORD *W=(WORD*)&Script->Element(iCode); Ar << *W; iCode+=2; // Code offset.
-			if( *W != MAXWORD ) SerializeExpr( Script, iCode, Ar );     // Boolean expr.
+			if( *W != MAXWORD ) SerializeExpr( Script, iCode, Ar, Ops );     // Boolean expr.
 			break;
 		}
 		case EX_LabelTable:
@@ -5085,22 +5497,23 @@ static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
 		}
 		case EX_GotoLabel:
 		{
-			SerializeExpr( Script, iCode, Ar ); // Label name expr.
+			SerializeExpr( Script, iCode, Ar, Ops ); // Label name expr.
 			break;
 		}
 		case EX_Broadcast:
 		{
-			SerializeExpr( Script, iCode, Ar );              // Name expr.
-			SerializeExpr( Script, iCode, Ar );              // Class expr.
+			GReachExprs++;
+			SerializeExpr( Script, iCode, Ar, Ops );              // Name expr.
+			SerializeExpr( Script, iCode, Ar, Ops );              // Class expr.
 			Ar << *(WORD*)&Script->Element(iCode); iCode+=2; // Skip offset;
-			SerializeExpr( Script, iCode, Ar );              // Function call expr.
+			SerializeExpr( Script, iCode, Ar, Ops );              // Function call expr.
 			break;
 		}
 		case EX_Let:
 		{
 			Ar << Script->Element(iCode++);     // Size.
-			SerializeExpr( Script, iCode, Ar ); // Variable expr.
-			SerializeExpr( Script, iCode, Ar ); // Assignment expr.
+			SerializeExpr( Script, iCode, Ar, Ops ); // Variable expr.
+			SerializeExpr( Script, iCode, Ar, Ops ); // Assignment expr.
 			break;
 		}
 		case EX_Let1:
@@ -5108,14 +5521,14 @@ static EExprToken SerializeExpr( UScript *Script, INT &iCode, FArchive &Ar )
 		case EX_LetBool:
 		case EX_LetString:
 		{
-			SerializeExpr( Script, iCode, Ar ); // Variable expr.
-			SerializeExpr( Script, iCode, Ar ); // Assignment expr.
+			SerializeExpr( Script, iCode, Ar, Ops ); // Variable expr.
+			SerializeExpr( Script, iCode, Ar, Ops ); // Assignment expr.
 			break;
 		}
 		case EX_Skip:
 		{
 			Ar << *(WORD*)&Script->Element(iCode); iCode+=2; // Skip size.
-			SerializeExpr( Script, iCode, Ar );              // Expression to possibly skip.
+			SerializeExpr( Script, iCode, Ar, Ops );              // Expression to possibly skip.
 			break;
 		}
 		case EX_BeginFunction:
@@ -5150,11 +5563,105 @@ void UScript::SerializeData( FArchive &Ar )
 
 	// Serialize all code.
 	while( iCode < Num )
-		SerializeExpr( this, iCode, Ar );
+		SerializeExpr( this, iCode, Ar, NULL );
 
 	checkState(iCode==Num);
 	unguard;
 }
+
+//
+// UScript object implementation.
+//
+void UScript::InitHeader()
+{
+	guard(UScript::InitHeader);
+
+	// Init parent.
+	UBuffer::InitHeader();
+
+	// Init our info.
+	Threaded = NULL;
+	Reach    = 0;
+
+	unguardobj;
+}
+void UScript::UnloadData()
+{
+	guard(UScript::UnloadData);
+
+	// Free threaded code, and forget any call sites in it.
+	FreeThreaded();
+	scriptFlushVfCache();
+	Reach = 0;
+
+	// Call parent.
+	UBuffer::UnloadData();
+
+	unguardobj;
+}
+
+//
+// Pre-decode this script's code for the threaded interpreter.
+//
+void UScript::BuildThreaded()
+{
+	guard(UScript::BuildThreaded);
+	if( !Threaded && GetData()!=NULL && Num>0 )
+	{
+		Threaded = (FThreadedOp*)appMalloc( Num * sizeof(FThreadedOp), "ThreadedCode" );
+		memset( Threaded, 0, Num * sizeof(FThreadedOp) );
+
+		// Walk all code with a do-nothing archive.
+		FArchive Ar;
+		INT iCode=0;
+		while( iCode < Num )
+			SerializeExpr( this, iCode, Ar, Threaded );
+		checkState(iCode==Num);
+	}
+	unguardobj;
+}
+
+//
+// Free this script's threaded code, returning it to the regular interpreter.
+//
+void UScript::FreeThreaded()
+{
+	guard(UScript::FreeThreaded);
+	if( Threaded )
+	{
+		appFree( Threaded );
+		Threaded = NULL;
+	}
+	unguardobj;
+}
+
+//
+// Return whether any of this script's code could reach outside its actor's
+// owner tree: By calling functions or accessing variables through another
+// object, broadcasting, calling an intrinsic which isn't self-contained,
+// using static or default variables, or reading a reference to an object
+// other than its owner. Scanned once and remembered.
+//
+INT UScript::ReachesOtherObjects()
+{
+	guard(UScript::ReachesOtherObjects);
+	if( !Reach && GetData()!=NULL )
+	{
+		// Walk all code with a do-nothing archive, counting expressions which reach out.
+		FArchive Ar;
+		INT iCode=0;
+		GScanReach  = 1;
+		GReachExprs = 0;
+		while( iCode < Num )
+			SerializeExpr( this, iCode, Ar, NULL );
+		GScanReach  = 0;
+		checkState(iCode==Num);
+		Reach = GReachExprs ? 2 : 1;
+	}
+	return Reach != 1;
+	unguardobj;
+}
+
 IMPLEMENT_DB_CLASS(UScript);
 
 /*-----------------------------------------------------------------------------
@@ -118,6 +118,59 @@ int FGlobalUnrealServer::Exec( const char *Cmd,FOutputDevice *Out )
 		}
 		else return 0;
 	}
+	else if( GetCMD(&Str,"SCRIPT") )
+	{
+		if( GetCMD(&Str,"THREADED") )
+		{
+			// Switch all loaded scripts between the threaded and regular interpreters.
+			if     ( GetCMD(&Str,"ON")  ) GScriptThreaded = 1;
+			else if( GetCMD(&Str,"OFF") ) GScriptThreaded = 0;
+			else                          GScriptThreaded ^= 1;
+
+			UScript *Script;
+			FOR_ALL_TYPED_OBJECTS(Script,UScript)
+			{
+				if( GScriptThreaded ) Script->BuildThreaded();
+				else                  Script->FreeThreaded();
+			}
+			END_FOR_ALL_TYPED_OBJECTS;
+
+			Out->Log(GScriptThreaded ? "Threaded script interpreter enabled" : "Threaded script interpreter disabled");
+			return 1;
+		}
+		else if( GetCMD(&Str,"BENCH") )
+		{
+			// Tick the level repeatedly and report the average script time.
+			if( !Level || Level->GetState()!=LEVEL_UpPlay )
+			{
+				Out->Log(LOG_ExecError,"No level is being played");
+				return 1;
+			}
+			INT Ticks=100;
+			GetINT(Str,"TICKS=",&Ticks);
+			Ticks = Max(Ticks,1);
+
+			INT TotalScriptTime=0, TotalActorTime=0;
+			for( int i=0; i<Ticks; i++ )
+			{
+				ScriptExecTime = 0;
+				ActorTickTime  = 0;
+				Level->Tick( 0, NULL, 1.0/35.0 );
+				TotalScriptTime += ScriptExecTime;
+				TotalActorTime  += ActorTickTime;
+			}
+			Out->Logf
+			(
+				"Script bench (%s): %i ticks, Script=%.3f Actors=%.3f msec/tick",
+				GScriptThreaded ? "threaded" : "regular",
+				Ticks,
+				GApp->CpuToMilliseconds(TotalScriptTime) / Ticks,
+				GApp->CpuToMilliseconds(TotalActorTime ) / Ticks
+			);
+			return 1;
+		}
+		else return 0; // Let the editor handle other script commands.
+	}
 	else return 0; // Not executed.
 	unguard;
 }
@@ -208,6 +261,8 @@ void FGlobalUnrealServer::Tick( FLOAT DeltaSeconds )
 	// Init states and info.
 	LevelTickTime			= 0;
 	ScriptExecTime			= 0;
+	VfCacheHits				= 0;
+	VfCacheMisses			= 0;
 	ActorTickTime			= 0;
 	AudioTickTime			= 0;
 
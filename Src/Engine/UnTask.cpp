@@ -0,0 +1,222 @@
+/*=============================================================================
+	UnTask.cpp: Task threads for running independent work on all processors.
+
+	Copyright 1997 Epic MegaGames, Inc. This software is a trade secret.
+	Compiled with Visual C++ 4.0. Best viewed with Tabs=4.
+
+Description:
+	The task pool keeps one sleeping thread per extra processor. Callers
+	hand it a batch of independent tasks with Run(), which wakes the
+	threads, works on the batch itself, and returns when all tasks are done.
+
+	Tasks are split into one contiguous range per thread. A thread takes
+	tasks from the front of its own range and, once that is empty, steals
+	from the back of the other ranges, so uneven tasks still keep every
+	processor busy. Both ends of a range live in one word which is only
+	changed with compare-exchange, so taking a task never blocks.
+
+	Nothing else in the engine is made thread safe by this. Code which runs
+	tasks is responsible for keeping them independent.
+
+Revision history:
+	* Created for parallel level ticking.
+=============================================================================*/
+
+#include "Unreal.h"
+
+/*-----------------------------------------------------------------------------
+	Globals.
+-----------------------------------------------------------------------------*/
+
+UNENGINE_API FTaskPool GTaskPool;
+
+// Index of the calling thread in the task pool, 0 for the main thread.
+static THREAD_LOCAL INT GTaskThread = 0;
+
+//
+// Return the index of the calling task thread.
+//
+UNENGINE_API INT appTaskThread()
+{
+	return GTaskThread;
+}
+
+/*-----------------------------------------------------------------------------
+	FTaskPool init & exit.
+-----------------------------------------------------------------------------*/
+
+//
+// Start the task threads. InNumThreads is the total number of threads
+// to use including the main thread, or 0 for one per processor.
+//
+void FTaskPool::Init( INT InNumThreads )
+{
+	guard(FTaskPool::Init);
+
+	// Init variables. The appInterlocked functions are only atomic in
+	// assembly, so without it everything runs on the main thread.
+#if ASM
+	NumThreads   = Clamp( InNumThreads>0 ? InNumThreads : GApp->NumProcessors(), 1, (INT)MAX_TASK_THREADS );
+#else
+	NumThreads   = 1;
+#endif
+	Running      = 0;
+	Quit         = 0;
+	Failed       = 0;
+	ThreadMem[0] = &GMainMem;
+
+	// Start the extra threads, each with its own memory stack.
+	if( NumThreads > 1 )
+	{
+		hStart  = GApp->NewSemaphore( 0 );
+		hFinish = GApp->NewSemaphore( 0 );
+		for( INT i=1; i<NumThreads; i++ )
+		{
+			char Name[32];
+			sprintf( Name, "Thread%i", i );
+			ThreadMem[i] = new FMemStack;
+			ThreadMem[i]->Init( GChunkPool, 16384, 65536, Name );
+			hThreads [i] = GApp->BeginThread( ThreadMain, (void*)i );
+		}
+	}
+	debugf( LOG_Init, "Task pool started with %i thread(s)", NumThreads );
+
+	unguard;
+}
+
+//
+// Stop the task threads.
+//
+void FTaskPool::Exit()
+{
+	guard(FTaskPool::Exit);
+	checkState(!Running);
+
+	if( NumThreads > 1 )
+	{
+		// Wake every thread with the quit flag set.
+		Quit = 1;
+		GApp->SignalSemaphore( hStart, NumThreads-1 );
+		for( INT i=1; i<NumThreads; i++ )
+		{
+			GApp->EndThread( hThreads[i] );
+			ThreadMem[i]->Exit();
+			delete ThreadMem[i];
+		}
+		GApp->FreeSemaphore( hStart  );
+		GApp->FreeSemaphore( hFinish );
+	}
+	NumThreads = 1;
+
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	FTaskPool running.
+-----------------------------------------------------------------------------*/
+
+//
+// Run tasks 0..NumTasks-1 by calling Func(Arg,iTask,iThread) on all task
+// threads, and return when they are all done. Tasks may run in any order
+// and concurrently with each other.
+//
+void FTaskPool::Run( TASK_FUNC InFunc, void *InArg, INT NumTasks )
+{
+	guard(FTaskPool::Run);
+	checkState(!Running);
+	checkInput(NumTasks<=MAXWORD);
+
+	// Run everything here if there's nobody to share with.
+	if( NumThreads==1 || NumTasks<=1 )
+	{
+		for( INT i=0; i<NumTasks; i++ )
+			InFunc( InArg, i, 0 );
+		return;
+	}
+
+	// Split the tasks evenly between the threads.
+	Func   = InFunc;
+	Arg    = InArg;
+	Failed = 0;
+	for( INT i=0; i<NumThreads; i++ )
+		Ranges[i].Range = ((NumTasks*i)/NumThreads) + (((NumTasks*(i+1))/NumThreads) << 16);
+
+	// Wake the task threads and work alongside them until all are done.
+	Running = 1;
+	GApp->SignalSemaphore( hStart, NumThreads-1 );
+	Work( 0 );
+	for( i=1; i<NumThreads; i++ )
+		GApp->WaitSemaphore( hFinish );
+	Running = 0;
+
+	// Report failure on the main thread.
+	if( Failed )
+		appError( "Task failed in task pool" );
+
+	unguard;
+}
+
+//
+// Take one task from a thread's range, from the front if it's our own
+// range or from the back if we're stealing. Returns INDEX_NONE if the
+// range is empty.
+//
+INT FTaskPool::TakeTask( INT iThread, INT Steal )
+{
+	FTaskRange &Task = Ranges[iThread];
+	for( ;; )
+	{
+		INT Old   = Task.Range;
+		INT Start = Old & 0xFFFF;
+		INT End   = (DWORD)Old >> 16;
+		if( Start >= End )
+			return INDEX_NONE;
+		INT New   = Steal ? Start + ((End-1) << 16) : (Start+1) + (End << 16);
+		if( appInterlockedCompareExchange( &Task.Range, New, Old ) == Old )
+			return Steal ? End-1 : Start;
+	}
+}
+
+//
+// Do tasks until none are left in any range.
+//
+void FTaskPool::Work( INT iThread )
+{
+	try
+	{
+		// Do our own tasks.
+		INT iTask;
+		while( (iTask=TakeTask(iThread,0)) != INDEX_NONE )
+			Func( Arg, iTask, iThread );
+
+		// Help the other threads finish theirs.
+		for( INT i=1; i<NumThreads; i++ )
+			while( (iTask=TakeTask((iThread+i)%NumThreads,1)) != INDEX_NONE )
+				Func( Arg, iTask, iThread );
+	}
+	catch( ... )
+	{
+		// Errors can't propagate across threads, so Run reports them.
+		Failed = 1;
+	}
+}
+
+//
+// Main loop of each extra task thread.
+//
+void FTaskPool::ThreadMain( void *Arg )
+{
+	GTaskThread = (INT)Arg;
+	for( ;; )
+	{
+		GApp->WaitSemaphore( GTaskPool.hStart );
+		if( GTaskPool.Quit )
+			break;
+		GTaskPool.Work( GTaskThread );
+		GApp->SignalSemaphore( GTaskPool.hFinish, 1 );
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
@@ -537,6 +537,328 @@ int UModel::LineCheck
 	unguard;
 }
 
+/*---------------------------------------------------------------------------------------
+   Batched LineCheck.
+---------------------------------------------------------------------------------------*/
+
+// Number of simple line rays traced down the Bsp together.
+#define RAY_PACKET 32
+
+//
+// The pieces of a packet's rays which fall into one subtree. Coordinates are
+// kept in separate arrays so that plane distances can be evaluated for four
+// rays at a time.
+//
+struct FRaySegments
+{
+	// Variables.
+	INT		Num;
+	INT		*iRay;
+	FLOAT	*SX, *SY, *SZ;
+	FLOAT	*EX, *EY, *EZ;
+
+	// Functions.
+	void Alloc( FMemStack &Mem, INT Max )
+	{
+		Num  = 0;
+		iRay = new(Mem,Max)INT;
+		SX   = new(Mem,Max)FLOAT; SY = new(Mem,Max)FLOAT; SZ = new(Mem,Max)FLOAT;
+		EX   = new(Mem,Max)FLOAT; EY = new(Mem,Max)FLOAT; EZ = new(Mem,Max)FLOAT;
+	}
+	FVector Start( INT i ) const
+	{
+		return FVector( SX[i], SY[i], SZ[i] );
+	}
+	FVector End( INT i ) const
+	{
+		return FVector( EX[i], EY[i], EZ[i] );
+	}
+	void Add( INT iInRay, const FVector &S, const FVector &E )
+	{
+		iRay[Num] = iInRay;
+		SX[Num] = S.X; SY[Num] = S.Y; SZ[Num] = S.Z;
+		EX[Num] = E.X; EY[Num] = E.Y; EZ[Num] = E.Z;
+		Num++;
+	}
+};
+
+//
+// Tracing worker for batched line checks. Traces a packet of simple line
+// rays down the Bsp together, so each node is visited once for all of the
+// rays which reach it. Pieces of rays are visited in any order, and each ray
+// keeps the hit nearest its start, which is the hit LineCheck would find.
+//
+struct FBatchLineCheckInfo
+{
+	// Variables.
+	UModel			&Model;
+	FLineCheckRay	*Rays;
+	FLOAT			*BestDist;		// Squared distance of each ray's nearest hit, or -1 if none.
+	DWORD			ExtraNodeFlags;
+
+	// Constructor.
+	FBatchLineCheckInfo( UModel &InModel, FLineCheckRay *InRays, FLOAT *InBestDist, DWORD InExtraNodeFlags )
+	:	Model			(InModel)
+	,	Rays			(InRays)
+	,	BestDist		(InBestDist)
+	,	ExtraNodeFlags	(InExtraNodeFlags)
+	{}
+
+	// Drop the pieces which start beyond their ray's nearest hit.
+	void Cull( FRaySegments &Segs )
+	{
+		INT j=0;
+		for( INT i=0; i<Segs.Num; i++ )
+		{
+			INT iRay = Segs.iRay[i];
+			if( BestDist[iRay]<0.0 || FDistSquared(Segs.Start(i),Rays[iRay].Start)<BestDist[iRay] )
+			{
+				Segs.iRay[j] = iRay;
+				Segs.SX[j] = Segs.SX[i]; Segs.SY[j] = Segs.SY[i]; Segs.SZ[j] = Segs.SZ[i];
+				Segs.EX[j] = Segs.EX[i]; Segs.EY[j] = Segs.EY[i]; Segs.EZ[j] = Segs.EZ[i];
+				j++;
+			}
+		}
+		Segs.Num = j;
+	}
+
+	// Tracer.
+	void LineCheck( INDEX iParent, INDEX iNode, INT Outside, FRaySegments Segs )
+	{
+		FMemMark Mark(GMem);
+		FLOAT *D1 = new(GMem,Segs.Num)FLOAT;
+		FLOAT *D2 = new(GMem,Segs.Num)FLOAT;
+		while( iNode != INDEX_NONE && Segs.Num )
+		{
+			const FBspNode &Node = Model.Nodes(iNode);
+			const FPlane   &P    = Node.Plane;
+
+			// Compute distances between the plane and all start and end points, four at a time.
+			for( INT i=0; i+4<=Segs.Num; i+=4 )
+			{
+				D1[i+0] = Segs.SX[i+0]*P.X + Segs.SY[i+0]*P.Y + Segs.SZ[i+0]*P.Z - P.W;
+				D1[i+1] = Segs.SX[i+1]*P.X + Segs.SY[i+1]*P.Y + Segs.SZ[i+1]*P.Z - P.W;
+				D1[i+2] = Segs.SX[i+2]*P.X + Segs.SY[i+2]*P.Y + Segs.SZ[i+2]*P.Z - P.W;
+				D1[i+3] = Segs.SX[i+3]*P.X + Segs.SY[i+3]*P.Y + Segs.SZ[i+3]*P.Z - P.W;
+				D2[i+0] = Segs.EX[i+0]*P.X + Segs.EY[i+0]*P.Y + Segs.EZ[i+0]*P.Z - P.W;
+				D2[i+1] = Segs.EX[i+1]*P.X + Segs.EY[i+1]*P.Y + Segs.EZ[i+1]*P.Z - P.W;
+				D2[i+2] = Segs.EX[i+2]*P.X + Segs.EY[i+2]*P.Y + Segs.EZ[i+2]*P.Z - P.W;
+				D2[i+3] = Segs.EX[i+3]*P.X + Segs.EY[i+3]*P.Y + Segs.EZ[i+3]*P.Z - P.W;
+			}
+			for( ; i<Segs.Num; i++ )
+			{
+				D1[i] = Segs.SX[i]*P.X + Segs.SY[i]*P.Y + Segs.SZ[i]*P.Z - P.W;
+				D2[i] = Segs.EX[i]*P.X + Segs.EY[i]*P.Y + Segs.EZ[i]*P.Z - P.W;
+			}
+
+			// Classify the pieces as LineCheck does, splitting those which span the plane.
+			FRaySegments Child[2];
+			Child[0].Alloc( GMem, Segs.Num );
+			Child[1].Alloc( GMem, Segs.Num );
+			for( i=0; i<Segs.Num; i++ )
+			{
+				if( D1[i] > -0.001 && D2[i] > -0.001 )
+				{
+					Child[1].Add( Segs.iRay[i], Segs.Start(i), Segs.End(i) );
+				}
+				else if( D1[i] < 0.001 && D2[i] < 0.001 )
+				{
+					Child[0].Add( Segs.iRay[i], Segs.Start(i), Segs.End(i) );
+				}
+				else
+				{
+					FVector Start      = Segs.Start(i);
+					FVector Middle     = Start + (Start-Segs.End(i)) * (D1[i]/(D2[i]-D1[i]));
+					INT     FrontFirst = D1[i] > 0.0;
+					Child[  FrontFirst].Add( Segs.iRay[i], Start,  Middle       );
+					Child[1-FrontFirst].Add( Segs.iRay[i], Middle, Segs.End(i) );
+				}
+			}
+
+			// Loop into the side holding pieces. If both do, recurse with the side
+			// nearest the first ray's start, cull the rest, and loop with the other.
+			INT Near = D1[0] > 0.0;
+			if( Child[Near].Num == 0 )
+				Near = 1-Near;
+			else if( Child[1-Near].Num )
+			{
+				LineCheck( iNode, Node.iChild[Near], Node.ChildOutside(Near,Outside,ExtraNodeFlags), Child[Near] );
+				Cull( Child[1-Near] );
+				Near = 1-Near;
+			}
+			Outside = Node.ChildOutside(Near,Outside,ExtraNodeFlags);
+			iParent = iNode;
+			iNode   = Node.iChild[Near];
+			Segs    = Child[Near];
+		}
+		if( !Outside )
+		{
+			// Solid space: Keep the nearest hit of each ray.
+			for( INT i=0; i<Segs.Num; i++ )
+			{
+				INT   iRay = Segs.iRay[i];
+				FLOAT Dist = FDistSquared( Segs.Start(i), Rays[iRay].Start );
+				if( BestDist[iRay]<0.0 || Dist<BestDist[iRay] )
+				{
+					FCheckResult &Hit = Rays[iRay].Hit;
+					Hit.Location  = Segs.Start(i);
+					Hit.Normal    = Model.Nodes(iParent).Plane;
+					Hit.Primitive = &Model;
+					Hit.Item      = 0;
+					BestDist[iRay] = Dist;
+				}
+			}
+		}
+		Mark.Pop();
+	}
+};
+
+//
+// A ray's place in the order rays are traced in.
+//
+struct FRayOrder
+{
+	DWORD	Key;
+	INT		iRay;
+	friend INT Compare( const FRayOrder &A, const FRayOrder &B )
+	{
+		return A.Key<B.Key ? -1 : A.Key>B.Key ? 1 : 0;
+	}
+};
+
+//
+// Spread the low 8 bits of a value out to every third bit.
+//
+static inline DWORD SpreadBits( DWORD V )
+{
+	V = (V | (V << 8)) & 0x0000F00F;
+	V = (V | (V << 4)) & 0x000C30C3;
+	V = (V | (V << 2)) & 0x00249249;
+	return V;
+}
+
+//
+// Perform line checks for a batch of rays through the world Bsp, setting
+// each ray's Hit and Clear to what LineCheck would have returned.
+//
+// Simple line rays are sorted by direction and by where they start, and traced
+// in packets whose rays share each node visit. Rays with an extent are traced
+// one at a time.
+//
+void UModel::LineCheckBatch
+(
+	FLineCheckRay	*Rays,
+	INT				NumRays,
+	DWORD			ExtraNodeFlags
+)
+{
+	guard(UModel::LineCheckBatch);
+	FMemMark Mark(GMem);
+
+	// Handle empty models and rays with extents the usual way.
+	FRayOrder *Order   = new(GMem,NumRays)FRayOrder;
+	INT       NumOrder = 0;
+	for( INT i=0; i<NumRays; i++ )
+	{
+		FLineCheckRay &Ray = Rays[i];
+		Ray.Hit = FCheckResult(1.0);
+		if( Nodes->Num==0 || Ray.Extent!=FVector(0,0,0) )
+		{
+			Ray.Clear = LineCheck( Ray.Hit, NULL, Ray.Start, Ray.End, Ray.Extent, ExtraNodeFlags );
+		}
+		else
+		{
+			// Order by direction octant, then by start location along a space-filling curve.
+			FVector Dir = Ray.End - Ray.Start;
+			DWORD   X   = Clamp( ftoi((Ray.Start.X+65536.0) * (1.0/512.0)), 0, 255 );
+			DWORD   Y   = Clamp( ftoi((Ray.Start.Y+65536.0) * (1.0/512.0)), 0, 255 );
+			DWORD   Z   = Clamp( ftoi((Ray.Start.Z+65536.0) * (1.0/512.0)), 0, 255 );
+			Order[NumOrder].Key  = ((Dir.X<0.0)<<26) + ((Dir.Y<0.0)<<25) + ((Dir.Z<0.0)<<24)
+				+ (SpreadBits(X)<<2) + (SpreadBits(Y)<<1) + SpreadBits(Z);
+			Order[NumOrder].iRay = i;
+			NumOrder++;
+		}
+	}
+	QSort( Order, NumOrder );
+
+	// Trace the simple line rays in packets.
+	FLOAT *BestDist = new(GMem,NumRays)FLOAT;
+	FBatchLineCheckInfo Info( *this, Rays, BestDist, ExtraNodeFlags );
+	for( INT iFirst=0; iFirst<NumOrder; iFirst+=RAY_PACKET )
+	{
+		FRaySegments Segs;
+		Segs.Alloc( GMem, RAY_PACKET );
+		for( i=iFirst; i<iFirst+RAY_PACKET && i<NumOrder; i++ )
+		{
+			FLineCheckRay &Ray = Rays[Order[i].iRay];
+			BestDist[Order[i].iRay] = -1.0;
+			Segs.Add( Order[i].iRay, Ray.Start, Ray.End );
+		}
+		Info.LineCheck( 0, 0, RootOutside, Segs );
+	}
+
+	// Finish the hits as LineCheck does.
+	for( i=0; i<NumOrder; i++ )
+	{
+		FLineCheckRay &Ray = Rays[Order[i].iRay];
+		Ray.Clear = BestDist[Order[i].iRay] < 0.0;
+		if( !Ray.Clear )
+		{
+			Ray.Hit.Time  = sqrt( FDistSquared(Ray.Hit.Location,Ray.Start) / FDistSquared(Ray.End,Ray.Start) );
+			Ray.Hit.Actor = NULL;
+		}
+	}
+	Mark.Pop();
+	unguard;
+}
+
+//
+// Trace random simple line rays through the model both batched and one at a
+// time, and log how many of them disagree.
+//
+void UModel::TestLineCheckBatch( INT NumRays, DWORD ExtraNodeFlags, FOutputDevice *Out )
+{
+	guard(UModel::TestLineCheckBatch);
+	if( Nodes->Num==0 || Points->Num==0 )
+	{
+		Out->Log( "Model is empty" );
+		return;
+	}
+	FMemMark Mark(GMem);
+
+	// Make random rays within the model's bounds.
+	FBoundingBox Box( Points->Num, &Points(0) );
+	FVector      Size = Box.Max - Box.Min;
+	FLineCheckRay *Rays = new(GMem,NumRays)FLineCheckRay;
+	for( INT i=0; i<NumRays; i++ )
+	{
+		Rays[i].Start  = Box.Min + FVector( frand()*Size.X, frand()*Size.Y, frand()*Size.Z );
+		Rays[i].End    = Box.Min + FVector( frand()*Size.X, frand()*Size.Y, frand()*Size.Z );
+		Rays[i].Extent = FVector(0,0,0);
+	}
+	LineCheckBatch( Rays, NumRays, ExtraNodeFlags );
+
+	// Compare against LineCheck.
+	INT NumHit=0, ClearDiffs=0, HitDiffs=0;
+	for( i=0; i<NumRays; i++ )
+	{
+		FCheckResult Hit(1.0);
+		INT Clear = LineCheck( Hit, NULL, Rays[i].Start, Rays[i].End, FVector(0,0,0), ExtraNodeFlags );
+		if( Clear != Rays[i].Clear )
+			ClearDiffs++;
+		else if( !Clear && FDistSquared(Hit.Location,Rays[i].Hit.Location) > 1.0 )
+			HitDiffs++;
+		NumHit += !Clear;
+	}
+	Out->Logf
+	(
+		"LineCheckBatch: %i rays, %i blocked, %i differ in Clear, %i differ in hit location",
+		NumRays, NumHit, ClearDiffs, HitDiffs
+	);
+	Mark.Pop();
+	unguard;
+}
+
 /*---------------------------------------------------------------------------------------
    Sphere plane filtering.
 ---------------------------------------------------------------------------------------*/
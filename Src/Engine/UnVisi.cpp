@@ -105,6 +105,17 @@ public:
 	}
 };
 
+//
+// A Bsp node whose polygon touches a leaf.
+//
+struct FLeafNode
+{
+	INDEX	iLeaf;		// The leaf.
+	INDEX	iNode;		// Node whose polygon touches it.
+	INDEX	iBase;		// Node whose plane list iNode is in.
+	INT		Side;		// Side of iBase the leaf is on, 1=front.
+};
+
 //
 // The visibility calculator class.
 //
@@ -132,6 +143,8 @@ public:
 	UBitMatrix*			Visibility;
 	FPortal**			NodePortals;
 	FPortal**			LeafPortals;
+	INT*				LeafNodeStart;
+	FLeafNode*			LeafNodes;
 
 	// Constructor.
 	FEditorVisibility( ULevel* InLevel, UModel* InModel, INT InDebug );
@@ -147,6 +160,7 @@ public:
 	void MakePortalsClip( INDEX iNode, FPoly Poly, INT Clip, PORTAL_FUNC Func );
 	void MakePortals( INDEX iNode );
 	void AssignLeaves( INDEX iNode, INT Outside );
+	void BuildPortals();
 	int ClipToMaximalSheetWrapping( FPoly &Poly, const FPoly &A, const FPoly &B, const FLOAT Sign, const FLOAT Phase );
 	void CheckVolumeVisibility( const INDEX iSourceLeaf, const FPoly &Source, const INDEX iTestLeaf, const FPoly &Clip, const FPortal *ClipPortal );
 	int PointToLeaf( FVector Point, INDEX iLeaf );
@@ -163,6 +177,12 @@ public:
 	void BspCrossVisibility( INDEX iFronyPortalLeaf, INDEX iBackPortalLeaf, INDEX iFrontLeaf, INDEX iBackLeaf, FPoly &FrontPoly, FPoly &ClipPoly, FPoly &BackPoly, INT ValidPolys, INT Pass, INT Tag );
 	void BspVisibility( INDEX iNode );
 	void TestVisibility();
+
+	// Light visibility functions.
+	void FloodLight( AActor* Actor, BYTE* Visited, INDEX* VisibleLeaves, INT& NumVisibleLeaves );
+	void FilterLeafNode( TTaskBuffer<FLeafNode> &Pairs, INDEX iNode, INDEX iBase, INT Side, INDEX iParentLeaf, INDEX iChild, FPoly Poly );
+	void AddLeafNodes( TTaskBuffer<FLeafNode> &Pairs, INDEX iNode );
+	void BuildLeafNodes();
 };
 
 /*-----------------------------------------------------------------------------
@@ -477,6 +497,31 @@ void FEditorVisibility::AssignLeaves( INDEX iNode, INT Outside )
 	unguard;
 }
 
+//
+// Number the leaves and build all portals between them.
+//
+void FEditorVisibility::BuildPortals()
+{
+	guard(FEditorVisibility::BuildPortals);
+
+	// Assign leaf numbers to convex outside volumes.
+	for( INDEX i=0; i<Model->Nodes->Num; i++ )
+		Model->Nodes(i).iDynamic[0] = Model->Nodes(i).iDynamic[1] = INDEX_NONE;
+	AssignLeaves( 0, Model->RootOutside );
+
+	// Allocate leaf info.
+	LeafPortals  = new(GMem, MEM_Zeroed, NumLeaves        )FPortal*;
+	NodePortals  = new(GMem, MEM_Zeroed, Model->Nodes->Num)FPortal*;
+	Leaves		 = new(GMem, MEM_Zeroed, NumLeaves        )FBspLeaf;
+	for( i=0; i<NumLeaves; i++ )
+		Leaves[i].iLogicalLeaf = Leaves[i].iZone = i;
+
+	// Build all portals, with references to their front and back leaves.
+	MakePortals( 0 );
+
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	Point visibility tests.
 -----------------------------------------------------------------------------*/
@@ -1143,18 +1188,8 @@ void FEditorVisibility::TestVisibility()
 		}
 	}
 
-	// Assign leaf numbers to convex outside volumes.
-	AssignLeaves( 0, Model->RootOutside );
-
-	// Allocate leaf info.
-	LeafPortals  = new(GMem, MEM_Zeroed, NumLeaves        )FPortal*;
-	NodePortals  = new(GMem, MEM_Zeroed, Model->Nodes->Num)FPortal*;
-	Leaves		 = new(GMem, MEM_Zeroed, NumLeaves        )FBspLeaf;
-	for( i=0; i<NumLeaves; i++ )
-		Leaves[i].iLogicalLeaf = Leaves[i].iZone = i;
-
-	// Build all portals, with references to their front and back leaves.
-	MakePortals( 0 );
+	// Build leaves and portals.
+	BuildPortals();
 
 	// Form zones.
 	FormZonesFromLeaves();
@@ -1340,7 +1375,9 @@ FEditorVisibility::FEditorVisibility( ULevel *InLevel, UModel *InModel, INT InEx
 	FirstPortal		(NULL),
 	Visibility		(NULL),
 	NodePortals		(NULL),
-	LeafPortals		(NULL)
+	LeafPortals		(NULL),
+	LeafNodeStart	(NULL),
+	LeafNodes		(NULL)
 {
 	guard(FEditorVisibility::FEditorVisibility);
 
@@ -1384,6 +1421,272 @@ void FGlobalEditor::TestVisibility( ULevel* Level, UModel* Model, int A, int B )
 	unguard;
 }
 
+/*-----------------------------------------------------------------------------
+	Light visibility.
+-----------------------------------------------------------------------------*/
+
+//
+// Filter the polygon of node iNode down side Side of its base node iBase,
+// and note each outside leaf it touches.
+//
+void FEditorVisibility::FilterLeafNode
+(
+	TTaskBuffer<FLeafNode>&	Pairs,
+	INDEX					iNode,
+	INDEX					iBase,
+	INT						Side,
+	INDEX					iParentLeaf,
+	INDEX					iChild,
+	FPoly					Poly
+)
+{
+	guard(FEditorVisibility::FilterLeafNode);
+	while( iChild != INDEX_NONE )
+	{
+		// If overflow.
+		if( Poly.NumVertices > FPoly::VERTEX_THRESHOLD )
+		{
+			FPoly Half;
+			Poly.SplitInHalf( &Half );
+			FilterLeafNode( Pairs, iNode, iBase, Side, iParentLeaf, iChild, Half );
+		}
+
+		// Test split, sending coplanars both ways.
+		FPoly Front,Back;
+		FBspNode& Node = Model->Nodes(iChild);
+		int Split = Poly.SplitWithNode( Model, iChild, &Front, &Back, 1 );
+
+		// Recurse with front.
+		if( Split != SP_Back )
+			FilterLeafNode( Pairs, iNode, iBase, Side, Node.iDynamic[1], Node.iFront, Split==SP_Split ? Front : Poly );
+
+		// Loop with back.
+		if( Split == SP_Front )
+			return;
+		if( Split == SP_Split )
+			Poly = Back;
+		iParentLeaf = Node.iDynamic[0];
+		iChild      = Node.iBack;
+	}
+
+	// We reached a leaf.
+	if( iParentLeaf != INDEX_NONE )
+	{
+		FLeafNode& Pair = Pairs.Add();
+		Pair.iLeaf = iParentLeaf;
+		Pair.iNode = iNode;
+		Pair.iBase = iBase;
+		Pair.Side  = Side;
+	}
+	unguard;
+}
+
+//
+// Recursively note the leaves touched by the polygons of every node in
+// the Bsp, on both sides of each.
+//
+void FEditorVisibility::AddLeafNodes( TTaskBuffer<FLeafNode> &Pairs, INDEX iNode )
+{
+	guard(FEditorVisibility::AddLeafNodes);
+	FBspNode& Node = Model->Nodes(iNode);
+
+	// Filter this node and its coplanars down both sides.
+	for( INDEX iPlane=iNode; iPlane!=INDEX_NONE; iPlane=Model->Nodes(iPlane).iPlane )
+	{
+		FPoly Poly;
+		if( Model->Nodes(iPlane).iSurf!=INDEX_NONE && GEditor->bspNodeToFPoly( Model, iPlane, &Poly ) )
+			for( int Side=0; Side<2; Side++ )
+				FilterLeafNode( Pairs, iPlane, iNode, Side, Node.iDynamic[Side], Node.iChild[Side], Poly );
+	}
+
+	// Recurse.
+	if( Node.iFront != INDEX_NONE )
+		AddLeafNodes( Pairs, Node.iFront );
+	if( Node.iBack != INDEX_NONE )
+		AddLeafNodes( Pairs, Node.iBack );
+	unguard;
+}
+
+//
+// Build the list of nodes touching each leaf. The nodes touching leaf i
+// are LeafNodes[LeafNodeStart[i]] to LeafNodes[LeafNodeStart[i+1]-1].
+// Requires BuildPortals.
+//
+void FEditorVisibility::BuildLeafNodes()
+{
+	guard(FEditorVisibility::BuildLeafNodes);
+
+	// Find all leaf/node pairs.
+	TTaskBuffer<FLeafNode> Pairs;
+	Pairs.Data = NULL;
+	Pairs.Num  = Pairs.Max = 0;
+	AddLeafNodes( Pairs, 0 );
+
+	// Sort them by leaf.
+	LeafNodeStart = new(GMem,MEM_Zeroed,NumLeaves+1)INT;
+	LeafNodes     = new(GMem,Pairs.Num)FLeafNode;
+	for( INT i=0; i<Pairs.Num; i++ )
+		LeafNodeStart[Pairs.Data[i].iLeaf+1]++;
+	for( i=0; i<NumLeaves; i++ )
+		LeafNodeStart[i+1] += LeafNodeStart[i];
+	for( i=0; i<Pairs.Num; i++ )
+		LeafNodes[LeafNodeStart[Pairs.Data[i].iLeaf]++] = Pairs.Data[i];
+	for( i=NumLeaves; i>0; i-- )
+		LeafNodeStart[i] = LeafNodeStart[i-1];
+	LeafNodeStart[0] = 0;
+	Pairs.Free();
+
+	unguard;
+}
+
+//
+// List the leaves a light may reach, by flooding through every portal which
+// faces away from it within its radius. Lights with no radius reach
+// everything, as in the illuminator. Unlike ActorVisibility this doesn't
+// clip by the portals it came through, so each leaf is entered only once
+// and the leaves found are a superset of those the light can see. Visited
+// holds a bit per leaf, which must be clear and is left clear.
+//
+void FEditorVisibility::FloodLight( AActor* Actor, BYTE* Visited, INDEX* VisibleLeaves, INT& NumVisibleLeaves )
+{
+	guard(FEditorVisibility::FloodLight);
+
+	// Find the leaf containing the light.
+	NumVisibleLeaves = 0;
+	INDEX iNode=0, iParent=0, IsFront=0;
+	while( iNode != INDEX_NONE )
+	{
+		IsFront = (Model->Nodes(iNode).Plane.PlaneDot(Actor->Location) > 0.0);
+		iParent = iNode;
+		iNode   = Model->Nodes(iNode).iChild[IsFront];
+	}
+	INDEX iLeaf = Model->Nodes(iParent).iDynamic[IsFront];
+	if( iLeaf == INDEX_NONE )
+		return;
+
+	// Flood breadth first, using the leaf list as the queue.
+	Visited[iLeaf>>3] |= 1<<(iLeaf&7);
+	VisibleLeaves[NumVisibleLeaves++] = iLeaf;
+	for( INT i=0; i<NumVisibleLeaves; i++ )
+	{
+		iLeaf = VisibleLeaves[i];
+		for( FPortal* Portal=LeafPortals[iLeaf]; Portal!=NULL; Portal=Portal->Next(iLeaf) )
+		{
+			INDEX iOtherLeaf = Portal->GetNeighborLeafOf( iLeaf );
+			if( Visited[iOtherLeaf>>3] & (1<<(iOtherLeaf&7)) )
+				continue;
+
+			FPoly Poly;
+			Portal->GetPolyFacingOutOf( iLeaf, Poly );
+			FLOAT PlaneDot = (Actor->Location - Poly.Base) | Poly.Normal;
+			if( PlaneDot<0.0 && (Actor->LightRadius==0 || PlaneDot>-Actor->WorldLightRadius()) )
+			{
+				Visited[iOtherLeaf>>3] |= 1<<(iOtherLeaf&7);
+				VisibleLeaves[NumVisibleLeaves++] = iOtherLeaf;
+			}
+		}
+	}
+	checkState(NumVisibleLeaves <= NumLeaves);
+
+	// Clear the bits for the next light.
+	for( i=0; i<NumVisibleLeaves; i++ )
+		Visited[VisibleLeaves[i]>>3] &= ~(1<<(VisibleLeaves[i]&7));
+
+	unguard;
+}
+
+//
+// Light visibility work shared by the task threads.
+//
+struct FLightVisiPool
+{
+	FEditorVisibility*	Visi;			// Leaves, portals and the nodes touching each leaf.
+	AActor**			Lights;			// The lights.
+	TTaskBuffer<INDEX>*	LightNodes;		// Nodes seen by each light.
+	INDEX*				VisibleLeaves;	// Visible leaf list of each task thread.
+	BYTE*				Visited;		// Visited leaf bitmap of each task thread.
+	INT*				Stamps;			// Last light to see each node, for each task thread.
+};
+
+//
+// Flood from light number iTask through the portals, and list the nodes
+// facing it in the leaves it may see. Nodes are culled the same way the
+// renderer culls them against the viewpoint.
+//
+void LightVisiTask( void *Arg, INT iTask, INT iThread )
+{
+	guard(LightVisiTask);
+	FLightVisiPool		&Pool			= *(FLightVisiPool*)Arg;
+	FEditorVisibility	*Visi			= Pool.Visi;
+	UModel				*Model			= Visi->Model;
+	AActor				*Actor			= Pool.Lights[iTask];
+	INDEX				*VisibleLeaves	= Pool.VisibleLeaves + iThread * Visi->NumLeaves;
+	INT					*Stamps			= Pool.Stamps + iThread * Model->Nodes->Num;
+	BYTE				*Visited		= Pool.Visited + iThread * ((Visi->NumLeaves+7)>>3);
+
+	// Find the leaves the light may see.
+	INT NumVisibleLeaves = 0;
+	Visi->FloodLight( Actor, Visited, VisibleLeaves, NumVisibleLeaves );
+
+	// List the nodes touching them on the light's side.
+	for( INT i=0; i<NumVisibleLeaves; i++ )
+	{
+		INDEX iLeaf = VisibleLeaves[i];
+		for( INT j=Visi->LeafNodeStart[iLeaf]; j<Visi->LeafNodeStart[iLeaf+1]; j++ )
+		{
+			FLeafNode &Pair = Visi->LeafNodes[j];
+			FLOAT     Dot   = Model->Nodes(Pair.iBase).Plane.PlaneDot( Actor->Location );
+			INT       IsFront = Dot > 0.0;
+			if( Pair.Side!=IsFront || Stamps[Pair.iNode]==iTask+1 )
+				continue;
+			if( !IsFront && Dot<-1.0 && !(Model->Surfs(Model->Nodes(Pair.iNode).iSurf).PolyFlags & (PF_TwoSided|PF_Portal)) )
+				continue;
+			Stamps[Pair.iNode] = iTask+1;
+			Pool.LightNodes[iTask].Add() = Pair.iNode;
+		}
+	}
+	unguard;
+}
+
+//
+// Find the Bsp nodes which each of a list of lights may shine on, by
+// flooding through the portals from the leaf containing each light, out
+// to its radius. Each light's list holds each node once, in no particular
+// order, and is left empty if the light isn't in an outside leaf. The
+// lists are conservative: they hold every node the light can see, and
+// possibly more. The lights are flooded in parallel.
+//
+void FGlobalEditor::LightVisibility( ULevel* Level, UModel* Model, INT NumLights, AActor** Lights, TTaskBuffer<INDEX>* LightNodes )
+{
+	guard(FGlobalEditor::LightVisibility);
+	if( Model->Nodes->Num )
+	{
+		// Build leaves and portals, and find the nodes touching each leaf.
+		FEditorVisibility Visi( Level, Model, 0 );
+		Visi.BuildPortals();
+		Visi.BuildLeafNodes();
+		debugf( "LightVisibility: %i portals, %i leaves, %i nodes", Visi.NumPortals, Visi.NumLeaves, Model->Nodes->Num );
+
+		// Flood from all lights.
+		FLightVisiPool Pool;
+		Pool.Visi			= &Visi;
+		Pool.Lights			= Lights;
+		Pool.LightNodes		= LightNodes;
+		Pool.VisibleLeaves	= new(GMem,GTaskPool.NumThreads*Visi.NumLeaves)INDEX;
+		Pool.Visited		= new(GMem,MEM_Zeroed,GTaskPool.NumThreads*((Visi.NumLeaves+7)>>3))BYTE;
+		Pool.Stamps			= new(GMem,MEM_Zeroed,GTaskPool.NumThreads*Model->Nodes->Num)INT;
+		GTaskPool.Run( LightVisiTask, &Pool, NumLights );
+
+		// Cleanup Bsp info.
+		for( INDEX i=0; i<Model->Nodes->Num; i++ )
+		{
+			Model->Nodes(i).iDynamic[0] = 0;
+			Model->Nodes(i).iDynamic[1] = 0;
+		}
+	}
+	unguard;
+}
+
 
 /*-----------------------------------------------------------------------------
 	Bsp node bounding volumes.
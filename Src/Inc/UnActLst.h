@@ -13,6 +13,99 @@
 #ifndef _INC_UNACTLST
 #define _INC_UNACTLST
 
+/*-----------------------------------------------------------------------------
+	FCollisionGrid.
+-----------------------------------------------------------------------------*/
+
+//
+// A sparse grid of collision cells, kept in an open-addressed hash table
+// keyed by cell coordinates. Each cell stores the indices of the actors
+// overlapping it in a small inline array, spilling to the heap only when
+// crowded. The grid remembers which cells each actor occupies, so removing
+// an actor never searches, and moving one only touches the cells it
+// entered or left.
+//
+// Actors are identified by index; FCollisionHash uses their object index.
+//
+class UNENGINE_API FCollisionGrid
+{
+public:
+	// Constants.
+	enum { CELL_INLINE = 5          };	// Actor indices stored in the cell itself.
+	enum { MIN_CELLS   = 1024       };	// Minimum size of the cell table.
+	enum { EMPTY_KEY   = 0xFFFFFFFF };	// Key of an unused cell.
+
+	// A cell, 32 bytes.
+	struct FCell
+	{
+		DWORD	Key;					// Packed cell coordinates, or EMPTY_KEY.
+		WORD	Num;					// Number of actors in the cell.
+		WORD	Max;					// Number of actors More can hold.
+		INT		Inline[CELL_INLINE];	// The first actors.
+		INT		*More;					// The rest of the actors, or NULL.
+
+		// Get the index of actor i in the cell.
+		INT Get( INT i ) const
+		{
+			return i<CELL_INLINE ? Inline[i] : More[i-CELL_INLINE];
+		}
+	};
+
+	// The cells an actor occupies.
+	struct FGridActor
+	{
+		AActor	*Actor;					// The actor, or NULL if not in the grid.
+		INT		X0,X1,Y0,Y1,Z0,Z1;		// Inclusive cell range.
+	};
+
+	// Variables.
+	FCell		*Cells;					// Cell table, MaxCells long.
+	INT			NumCells;				// Cells in use, including emptied ones.
+	INT			MaxCells;				// Size of cell table, a power of two.
+	INT			HashShift;				// Shift giving a table index from a hashed key.
+	FGridActor	*Actors;				// Cells of each actor, by actor index.
+	INT			MaxActors;				// Size of actor table.
+
+	// Functions.
+	void Init();
+	void Exit();
+	void AddActor( INT iActor, AActor *Actor, INT X0, INT X1, INT Y0, INT Y1, INT Z0, INT Z1 );
+	void RemoveActor( INT iActor );
+	void MoveActor( INT iActor, INT X0, INT X1, INT Y0, INT Y1, INT Z0, INT Z1 );
+	BOOL Contains( INT iActor )
+	{
+		return iActor<MaxActors && Actors[iActor].Actor!=NULL;
+	}
+	AActor *GetActor( INT iActor )
+	{
+		return Actors[iActor].Actor;
+	}
+	const FCell *FindCell( INT X, INT Y, INT Z ) const
+	{
+		DWORD Key = GetKey( X, Y, Z );
+		for( INT i=GetSlot(Key); Cells[i].Key!=EMPTY_KEY; i=(i+1)&(MaxCells-1) )
+			if( Cells[i].Key == Key )
+				return &Cells[i];
+		return NULL;
+	}
+
+private:
+	// Pack cell coordinates into a key. Coordinates outside the hashed
+	// range wrap around, which only costs some extra candidates.
+	static DWORD GetKey( INT X, INT Y, INT Z )
+	{
+		return (X & 2047) + ((Y & 2047) << 11) + ((Z & 511) << 22);
+	}
+	INT GetSlot( DWORD Key ) const
+	{
+		return (Key * 2654435761U) >> HashShift;
+	}
+	FCell &GetCell( INT X, INT Y, INT Z );
+	void AddToCell( FCell &Cell, INT iActor );
+	void RemoveFromCell( FCell &Cell, INT iActor );
+	void Resize( INT NewMaxCells );
+};
+
 /*-----------------------------------------------------------------------------
 	FCollisionHash.
 -----------------------------------------------------------------------------*/
@@ -48,6 +141,15 @@ public:
 		{}
 	} *Hash[NUM_BUCKETS];
 
+	// A change deferred by a task thread during a parallel tick.
+	struct FDeferredLink
+	{
+		AActor			*Actor;		// The actor.
+		INT				Sequence;	// Order the change was made in.
+		INT				Add;		// 1 if the actor was added, 0 if it was removed.
+		INT				X0,X1,Y0,Y1,Z0,Z1; // Hash extent a removed actor occupied.
+	};
+
 	// Statics.
 	static INT InitializedBasis;
 	static INT CollisionTag;
@@ -57,6 +159,9 @@ public:
 
 	// Variables.
 	BOOL CollisionInitialized;
+	BOOL Deferring;				// Adds and removes are deferred until EndDeferred.
+	BOOL UseGrid;				// Use the sparse grid instead of the hash buckets.
+	FCollisionGrid Grid;		// Sparse grid, if UseGrid.
 
 	// Low-level actor-actor collision checking functions.
 	void Init();
@@ -64,7 +169,15 @@ public:
 	void Tick();
 	void AddActor( AActor *Actor );
 	void RemoveActor( AActor *Actor );
+	void MoveActor( AActor *Actor, FVector NewLocation, FRotation NewRotation );
+	void BeginDeferred();
+	void EndDeferred();
+	void AddLinks( AActor *Actor, INT X0, INT X1, INT Y0, INT Y1, INT Z0, INT Z1 );
+	void RemoveLinks( AActor *Actor, INT X0, INT X1, INT Y0, INT Y1, INT Z0, INT Z1 );
+	static void Bench( INT NumActors, INT Ticks, FOutputDevice *Out );
 	FCheckResult* LineCheck( FMemStack& Mem, FVector Start, FVector End, FVector Extent, BOOL bCheckActors, ALevelInfo* LevelInfo );
+	FCheckResult** LineCheckBatch( FMemStack& Mem, FLineCheckRay* Rays, INT NumRays, BOOL bCheckActors, ALevelInfo* LevelInfo );
+	FCheckResult* LineCheckActors( FMemStack& Mem, FVector Start, FVector End, FVector Extent, FCheckResult* LevelHit );
 	FCheckResult* PointCheck( FMemStack& Mem, FVector Location, FVector Extent, DWORD ExtraNodeFlags, ALevelInfo* Level, BOOL bActors );
 	FCheckResult* EncroachmentCheck( FMemStack& Mem, AActor* Actor, FVector Location, FRotation Rotation, DWORD ExtraNodeFlags );
 	int SinglePointCheck( FCheckResult& Hit, FVector Location, FVector Extent, DWORD ExtraNodeFlags, ALevelInfo* Level, BOOL bActors );
@@ -84,7 +197,12 @@ public:
 	{
 #if CHECK_ALL
 		guard(FCollisionHash::CheckActorNotReferenced);
-		if( !GEditor )
+		if( !GEditor && UseGrid )
+		{
+			if( Grid.Contains( Actor->GetIndex() ) )
+				appErrorf( "Actor %s %s is in the collision grid", Actor->GetClassName(), Actor->GetName() );
+		}
+		else if( !GEditor )
 			for( int i=0; i<NUM_BUCKETS; i++ )
 				for( FActorLink* Link=Hash[i]; Link; Link=Link->Next )
 					if( Link->Actor == Actor )
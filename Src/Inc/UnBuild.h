@@ -38,7 +38,7 @@ COMPILING_EDITOR	If compiling UnEditor.dll
 #endif
 
 #ifndef CHECK_ALLOCS
-#define CHECK_ALLOCS	0	/* Check for malloc memory leaks */
+#define CHECK_ALLOCS	0	/* Check for malloc memory leaks, and track memory by tag */
 #endif
 
 #ifndef STATS
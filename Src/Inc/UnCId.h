@@ -34,8 +34,8 @@ enum ECacheIDBase
 	CID_3dfxLightMap		= 0x1B000000, // A cached light map in the 3dfx code.
 	CID_AALineTable			= 0x1C000000, // A cached antialiased line drawing table.
 	CID_TweenAnim			= 0x1D000000, // A cached animation tween.
-	CID_Extra4				= 0x1E000000,
-	CID_Extra3				= 0x1F000000,
+	CID_MeshFrame			= 0x1E000000, // An unpacked mesh keyframe.
+	CID_MeshNormals			= 0x1F000000, // Mesh vertex normals between two keyframes.
 	CID_Extra2				= 0x20000000,
 	CID_Extra1				= 0x21000000,
 	CID_Extra0				= 0x22000000,
@@ -46,6 +46,32 @@ enum ECacheIDBase
 	Functions.
 ----------------------------------------------------------------------------*/
 
+//
+// Return the name of a Cache ID's base, or NULL if it isn't known.
+//
+inline const char *GetCacheIDName( DWORD Id )
+{
+	switch( Id & CID_MAX )
+	{
+		case CID_ColorDepthPalette:	return "ColorDepthPalette";
+		case CID_RemappedTexture:	return "RemappedTexture";
+		case CID_LightingTable:		return "LightingTable";
+		case CID_ZoneScaler:		return "ZoneScaler";
+		case CID_ShadowMap:			return "ShadowMap";
+		case CID_IlluminationMap:	return "IlluminationMap";
+		case CID_ResultantMap:		return "ResultantMap";
+		case CID_StaticMap:			return "StaticMap";
+		case CID_MemStackChunk:		return "MemStackChunk";
+		case CID_3dfxTexture:		return "3dfxTexture";
+		case CID_3dfxLightMap:		return "3dfxLightMap";
+		case CID_AALineTable:		return "AALineTable";
+		case CID_TweenAnim:			return "TweenAnim";
+		case CID_MeshFrame:			return "MeshFrame";
+		case CID_MeshNormals:		return "MeshNormals";
+		default:					return NULL;
+	}
+}
+
 //
 // Make a Cache ID from a base ID, and low part of a DWORD.
 //
@@ -32,6 +32,13 @@ Critical failure conditions:
 
 This is optimized for ultra-fast Get's, decently fast Create's.
 
+Create has two engines. The linear engine searches every item in the cache
+for the cheapest contiguous span. The size class engine keeps free items in
+lists by size class, and used items in buckets by the tick they were last
+used in, so it can usually find room by taking a free item or evicting the
+oldest items without looking at the rest of the cache. When it can't, it
+falls back to the linear engine.
+
 Revision history:
 	* Initially implementated by Mark Randell.
 	* Rewritten by Tim Sweeney (speed, speed, speed!)
@@ -65,6 +72,8 @@ public:
 				appErrorf( "Unlock: Item %08X is not locked",Id );
 			
 			Cost -= COST_INFINITE;
+			if( Recorder )
+				Recorder->RecordUnlock( this );
 		}
 		// Accessors.
 		DWORD GetId()
@@ -80,18 +89,23 @@ public:
 			return Size;
 		}
 	private:
-		// Private variables: Note 32-byte alignment.
+		// Private variables.
 		BYTE		*Data;			// Pointer to the item's data.
 		DWORD		Id;				// This item's cache id, 0=unused.
-		WORD		Time;			// Last Get() time.
-		WORD		Segment;		// Number of segment this item resides in.
+		INT			Time;			// Last Get() time.
 		INT			Size;			// Data size, not accounting for start-alignment padding.
-		INT			Cost;			// Cost to flush this item.
+		INT			Cost;			// Size when created, plus COST_INFINITE per lock.
 		FCacheItem	*LinearNext;	// Next cache item in linear list, or NULL if last.
 		FCacheItem	*LinearPrev;	// Previous cache item in linear list, or NULL if first.
 		FCacheItem	*HashNext;		// Next cache item in hash table, or NULL if last.
+		FCacheItem	*ListNext;		// Next item in free list if free, or age list if used.
+		FCacheItem	*ListPrev;		// Previous item in free list if free, or age list if used.
+		INT			Stamp;			// Time of the age bucket this item was put in.
+		WORD		Segment;		// Number of segment this item resides in.
+		WORD		Pad;
 
-		// Cost is defined as:
+		// The cost to flush an item, as returned by FMemCache::GetCost,
+		// is computed from its age when needed, and is defined as:
 		// If the item is free(Id==0), 0;
 		// If the item is locked, COST_INFINITE;
 		// If the item is fresh (CacheTime-Time<=1), Size;
@@ -100,6 +114,19 @@ public:
 	friend class FMemCache;
 	};
 
+	// Create engines.
+	enum ECacheEngine
+	{
+		CACHE_Linear	= 0,	// Search every item for the cheapest span.
+		CACHE_SizeClass	= 1,	// Use free lists and age buckets, fall back to linear.
+	};
+
+	// Engine used by Create.
+	INT Engine;
+
+	// Cache whose operations are being recorded, if any.
+	static FMemCache *Recorder;
+
 	// Constructor.
 	FMemCache() {Initialized=0;}
 
@@ -124,13 +151,16 @@ public:
 	{	
 		guardSlow(FMemCache::Get);
 		NumGets++;
+		if( Recorder == this )
+			RecordOp( TRACE_Get, Id, 0, Alignment );
 		for( FCacheItem *HashItem=HashItems[Id%HASH_COUNT]; HashItem; HashItem=HashItem->HashNext )
 		{
 			if( HashItem->Id == Id )
 			{
 				// Set the item, lock it, and return its data.
 				Item            = HashItem;
-				HashItem->Time  = Time;
+				if( HashItem->Time != Time )
+					Touch( HashItem );
 				HashItem->Cost += COST_INFINITE;
 				return Align( HashItem->Data, Alignment );
 			}
@@ -144,6 +174,8 @@ public:
 	{	
 		guardSlow(FMemCache::GetEx);
 		NumGets++;
+		if( Recorder==this && !Item )
+			RecordOp( TRACE_Get, Id, 0, Alignment );
 		for( FCacheItem *HashItem=Item?Item->HashNext:HashItems[Id%HASH_COUNT]; HashItem; HashItem=HashItem->HashNext )
 		{
 			if( HashItem->Id == Id )
@@ -151,7 +183,8 @@ public:
 				// Set the item, lock it, and return its data.
 				Item            = HashItem;
 				OldTime         = HashItem->Time;
-				HashItem->Time  = Time;
+				if( HashItem->Time != Time )
+					Touch( HashItem );
 				HashItem->Cost += COST_INFINITE;
 				return Align( HashItem->Data, Alignment );
 			}
@@ -160,8 +193,12 @@ public:
 		unguardSlow;
 	}
 
+	// Command line.
+	INT Exec( const char *Cmd, FOutputDevice *Out );
+
 	// Status.
 	void Status( char *Msg );
+	void DumpCategories( FOutputDevice *Out, INT Csv=0 );
 	void DrawCache( BYTE *Dest, int XR, int YR, int ColorBytes );
 	INT GetTime() {return Time;}
 
@@ -174,6 +211,9 @@ private:
 	enum {COST_INFINITE=0x1000000}; // An infinite removal cost.
 	enum {HASH_COUNT=11731};		// Hash table size.
 	enum {IGNORE_SIZE=128};			// Don't bother tracking items less than this size.
+	enum {NUM_SIZE_CLASSES=32};		// Number of free lists, one per power of two.
+	enum {AGE_BUCKETS=32};			// Number of ticks with their own age bucket.
+	enum {MAX_EVICTIONS=32};		// Evictions before Create falls back to the linear engine.
 
 	// Whether we're initialized.
 	INT Initialized;
@@ -186,6 +226,24 @@ private:
 	INT ItemsFresh,ItemsStale,ItemsTotal;
 	INT MemFresh,MemStale,MemTotal;
 
+	// Used items and memory in all, used this tick, and last used in the
+	// previous tick, kept up to date as items are used and flushed.
+	INT ItemsUsed,ItemsNow,ItemsLast;
+	INT MemUsed,MemNow,MemLast;
+	void Touch( FCacheItem *Item )
+	{
+		if( Item->Time == Time-1 )
+		{
+			ItemsLast--;
+			MemLast -= Item->Size;
+		}
+		ItemsNow++;
+		MemNow     += Item->Size;
+		Item->Time  = Time;
+	}
+	void Count( FCacheItem *Item );
+	void Uncount( FCacheItem *Item );
+
 	// Linked list of item associated with cache memory, linked via LinearNext and
 	// LinearPrev order of memory.
 	void *ItemMemory;
@@ -211,12 +269,76 @@ private:
 		appError( "Unhashed item" );
 	}
 
+	// Free lists, one per size class, and a mask of the nonempty ones.
+	// Each list is circular through a sentinel item.
+	FCacheItem FreeLists[NUM_SIZE_CLASSES];
+	DWORD FreeMask;
+
+	// Age buckets of used items, indexed by the Stamp time modulo AGE_BUCKETS,
+	// and one bucket for items too old to have their own.
+	FCacheItem AgeBuckets[AGE_BUCKETS];
+	FCacheItem AgeOld;
+
+	// Free list and age bucket maintenance.
+	static INT SizeClass( INT Size )
+	{
+		INT Class=0;
+		while( (Size>>=1)!=0 && Class<NUM_SIZE_CLASSES-1 )
+			Class++;
+		return Class;
+	}
+	static void ListInit( FCacheItem *Sentinel )
+	{
+		Sentinel->ListNext = Sentinel->ListPrev = Sentinel;
+	}
+	static void ListAdd( FCacheItem *Sentinel, FCacheItem *Item )
+	{
+		Item->ListNext				= Sentinel;
+		Item->ListPrev				= Sentinel->ListPrev;
+		Sentinel->ListPrev->ListNext= Item;
+		Sentinel->ListPrev			= Item;
+	}
+	void LinkItem( FCacheItem *Item );
+	void UnlinkItem( FCacheItem *Item );
+
 	// Merging items.
 	FCacheItem *MergeWithNext( FCacheItem *First );
 
 	// Flushing individual items.
+	FCacheItem *FreeItem( FCacheItem *Item );
 	FCacheItem *FlushItem( FCacheItem *Item );
 
+	// Creating.
+	static INT Fits( FCacheItem *Item, INT CreateSize, INT Alignment )
+	{
+		return Align(Item->Data,Alignment) + CreateSize <= Item->Data + Item->Size;
+	}
+	INT Evictable( FCacheItem *Item, INT Segment )
+	{
+		return Item && Item->Id && Item->Segment==Segment && Item->Cost<COST_INFINITE && Time - Item->Time > 1;
+	}
+	INT GetCost( FCacheItem *Item );
+	FCacheItem *FindLinear( DWORD Id, INT CreateSize, INT Alignment );
+	FCacheItem *FindSizeClass( INT CreateSize, INT Alignment );
+	BYTE *Claim( FCacheItem *Item, DWORD Id, INT CreateSize, INT Alignment, INT MaxCreateSize );
+
+	// Trace recording, for replaying a real workload in the benchmark.
+	enum ETraceOp {TRACE_Get, TRACE_Create, TRACE_Unlock, TRACE_Tick, TRACE_Flush};
+	struct FTraceOp
+	{
+		INT		Op;
+		DWORD	Id;
+		INT		Size;		// Create size, or Flush mask.
+		INT		Alignment;
+		INT		MaxSize;
+	};
+	FTraceOp *Trace;
+	INT NumTrace, MaxTrace, TraceTicks;
+	void RecordOp( INT Op, DWORD Id, INT Size=0, INT Alignment=0, INT MaxSize=0 );
+	void RecordUnlock( FCacheItem *Item );
+	void SynthesizeTrace( INT Frames, INT NumIds, INT PerFrame );
+	DOUBLE ReplayTrace( INT InEngine, INT &Misses, INT &Creates );
+
 	// Original memory allocations.
 	FCacheItem *UnusedItemMemory;
 	BYTE       *CacheMemory;
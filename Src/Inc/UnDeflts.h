@@ -39,6 +39,21 @@ public:
 	// Audio.
 	int AudioActive;
 
+	// Threading.
+	int TaskThreads;
+
+	// Loading.
+	int LazyLoad;
+
+	// Garbage collection.
+	int IncrementalGC;
+
+	// Collision.
+	int CollisionGrid;
+
+	// Mesh animation.
+	int MeshStreams;
+
 	// Functions.
 	void Init(char *CmdLine);
 	void Exit();
@@ -229,7 +229,10 @@ public:
 	int			    Show3DGrid;
 	int				FastRebuild;
 	int				Bootstrapping;
-	int				Pad[4];
+	int				FastSplit;
+	int				IncrementalCsg;
+	int				PortalLighting;
+	int				Pad[1];
 
 	FLOAT			MovementSpeed;
 	FConstraints	Constraints;
@@ -325,6 +328,8 @@ public:
 	// Bsp virtuals from UnBsp.cpp.
 	virtual INDEX	bspAddVector		(UModel *Model, FVector *V, int Exact);
 	virtual INDEX	bspAddPoint			(UModel *Model, FVector *V, int Exact);
+	virtual void	bspWeldBegin		(UModel *Model);
+	virtual void	bspWeldEnd			();
 	virtual int		bspNodeToFPoly		(UModel *Model, INDEX iNode, FPoly *EdPoly);
 	virtual void	bspBuild			(UModel *Model, EBspOptimization Opt, int Balance, int RebuildSimplePolys);
 	virtual void	bspRefresh			(UModel *Model,int NoRemapSurfs);
@@ -338,7 +343,7 @@ public:
 	virtual INDEX	bspAddNode			(UModel *Model, INDEX iParent, ENodePlace ENodePlace, DWORD NodeFlags, FPoly *EdPoly);
 
 	// Shadow virtuals (UnShadow.cpp).
-	virtual void	shadowIlluminateBsp (ULevel *Level, int Selected);
+	virtual void	shadowIlluminateBsp (ULevel *Level, int Selected, FOutputDevice *Bench=NULL);
 
 	// Constraints (UnEdCnst.cpp).
 	virtual void	constraintInit				(FConstraints *Constraints);
@@ -358,6 +363,7 @@ public:
 
 	// Visibility.
 	virtual void TestVisibility(ULevel *Level,UModel *Model,int A, int B);
+	virtual void LightVisibility(ULevel *Level,UModel *Model,INT NumLights,AActor **Lights,TTaskBuffer<INDEX> *LightNodes);
 
 	// Scripts.
 	virtual int MakeScripts(int MakeAll);
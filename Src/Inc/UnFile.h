@@ -288,6 +288,111 @@ Recurse:
 	unguard;
 }
 
+//
+// Make radix sort keys from signed integers and floats, so that they are
+// ordered like the original values when compared as unsigned integers.
+//
+inline DWORD RadixSigned( INT Key )
+{
+	return (DWORD)Key ^ 0x80000000;
+}
+inline DWORD RadixFloat( FLOAT Key )
+{
+	DWORD D = *(DWORD*)&Key;
+	return (D & 0x80000000) ? ~D : (D | 0x80000000);
+}
+
+//
+// Radix sort an array of items in increasing order of a 32-bit key, one
+// byte of the key per pass. Takes linear time, and unlike QSort it is
+// stable: items with equal keys stay in their original order.
+//
+// Array points to an array of Num elements of class T.
+// Temp points to scratch space for Num elements of class T.
+// SortCutoff is an optional value at or below which elements are insertion-sorted.
+//
+// Passes for key bytes which are the same in every element are skipped, so
+// keys which vary only in their low bits take fewer passes.
+//
+// Requires:
+//    Class T must have a valid assignment operator.
+//    Class T must have a valid key friend function DWORD RadixKey(const T&A)
+//    whose results are ordered as unsigned integers. RadixSigned and RadixFloat
+//    make keys from signed integers and floats, and ~Key sorts in decreasing order.
+//
+// Example:
+//	struct MyLong {
+//		long Value;
+//		friend inline DWORD RadixKey(const MyLong &A)
+//			{return RadixSigned(A.Value);};
+//	};
+//	void f()
+//	{
+//		MyLong ArrayToSort[64], Temp[64]; // Initialize this somewhere...
+//		RadixSort(ArrayToSort,Temp,64); // Now the array is sorted
+//	}
+//
+template<class T> inline void RadixSort(T *Array, T *Temp, int Num, int SortCutoff=16)
+{
+	guard("RadixSort");
+	int i, j;
+
+	// Below a certain size, it is faster to use insertion sort.
+	if( Num <= SortCutoff )
+	{
+		for( i=1; i<Num; i++ )
+		{
+			const T Item = Array[i];
+			DWORD   Key  = RadixKey(Item);
+			for( j=i; j>0 && RadixKey(Array[j-1])>Key; j-- )
+				Array[j] = Array[j-1];
+			Array[j] = Item;
+		}
+		return;
+	}
+
+	// Count the elements with each value of each key byte.
+	int Counts[4][256];
+	memset( Counts, 0, sizeof(Counts) );
+	for( i=0; i<Num; i++ )
+	{
+		DWORD Key = RadixKey(Array[i]);
+		Counts[0][(Key    ) & 255]++;
+		Counts[1][(Key>> 8) & 255]++;
+		Counts[2][(Key>>16) & 255]++;
+		Counts[3][(Key>>24)      ]++;
+	}
+
+	// Scatter the elements by each key byte in turn, least significant first.
+	T *Src=Array, *Dest=Temp;
+	for( int Pass=0; Pass<4; Pass++ )
+	{
+		int *Count = Counts[Pass];
+		int Shift  = Pass*8;
+		if( Count[(RadixKey(Src[0])>>Shift) & 255] == Num )
+			continue;
+
+		// Turn the counts into starting offsets.
+		int Offset = 0;
+		for( int Byte=0; Byte<256; Byte++ )
+		{
+			int ThisCount = Count[Byte];
+			Count[Byte]   = Offset;
+			Offset       += ThisCount;
+		}
+		for( i=0; i<Num; i++ )
+			Dest[Count[(RadixKey(Src[i])>>Shift) & 255]++] = Src[i];
+		Exchange( Src, Dest );
+	}
+
+	// Copy back if the result ended up in the scratch space.
+	if( Src != Array )
+		for( i=0; i<Num; i++ )
+			Array[i] = Src[i];
+
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	Shuffle an array randomly.
 -----------------------------------------------------------------------------*/
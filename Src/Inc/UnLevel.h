@@ -36,6 +36,32 @@ enum ETraceActorFlags
 	TRACE_AllEverything = TRACE_Pawns | TRACE_Movers | TRACE_Level | TRACE_ZoneChanges | TRACE_Others,
 };
 
+//
+// Result of ticking one actor.
+//
+enum ETickResult
+{
+	TICK_Skipped		= 0,	// Not ready to be ticked yet.
+	TICK_Updated		= 1,	// Ticked.
+	TICK_Destroyed		= 2,	// Destroyed itself while being ticked.
+};
+
+//
+// A level change deferred by a task thread during a parallel tick,
+// and replayed on the main thread at the sync point.
+//
+enum ETickCommand
+{
+	TICKCMD_Destroy		= 0,	// Destroy the actor.
+	TICKCMD_Sound		= 1,	// Update the actor's audio.
+};
+struct FTickCommand
+{
+	AActor				*Actor;		// Actor the command applies to.
+	INT					Sequence;	// Order the command was issued in.
+	INT					Type;		// Command type, from ETickCommand.
+};
+
 //
 // The level object.  Contains the level's actor list, Bsp information, and brush list.
 //
@@ -60,6 +86,9 @@ class UNENGINE_API ULevel : public UDatabase, public FOutputDevice
 	FCollisionHash			Hash;
 	AActor					*FirstDeleted;
 	ALevelInfo				*Info;
+	BOOL					ParallelTick;	// Tick independent actors on all task threads.
+	BOOL					Deferring;		// Task threads are deferring level changes.
+	BOOL					KeepDestroyed;	// Don't clean up destroyed actors when unlocking.
 
 	// UObject interface.
 	const char *Import      (const char *Buffer, const char *BufferEnd,const char *FileType);
@@ -81,6 +110,11 @@ class UNENGINE_API ULevel : public UDatabase, public FOutputDevice
 		// Init collision.
 		Hash.CollisionInitialized = 0;
 
+		// Init ticking.
+		ParallelTick  = 0;
+		Deferring     = 0;
+		KeepDestroyed = 0;
+
 		unguard;
 	}
 	void InitHeader()
@@ -103,6 +137,9 @@ class UNENGINE_API ULevel : public UDatabase, public FOutputDevice
 		// Init in-memory info.
 		Hash.CollisionInitialized = 0;
 		FirstDeleted              = NULL;
+		ParallelTick              = 0;
+		Deferring                 = 0;
+		KeepDestroyed             = 0;
 
 		unguard;
 	}
@@ -151,6 +188,10 @@ class UNENGINE_API ULevel : public UDatabase, public FOutputDevice
 	void	EmptyLevel			();
 	void	SetState			(ELevelState State);
 	void	Tick				(int CamerasOnly, AActor *ActiveActor,FLOAT DeltaSeconds);
+	int		TickActor			(AActor *Actor, int CamerasOnly, AActor *ActiveActor, FLOAT DeltaSeconds);
+	void	TickParallel		(AActor *ActiveActor, FLOAT DeltaSeconds, DWORD Ticked);
+	void	DeferCommand		(ETickCommand Type, AActor *Actor);
+	void	TestParallelTick	(INT Ticks, FOutputDevice *Out);
 	ELevelState GetState		() {return State;}
 	void	ReconcileActors		();
 	void	RememberActors		();
@@ -189,6 +189,8 @@ protected:
 		strcpy(NewFilename,Filename);
 		if( InMaxSize!=0 || GApp->FindFile( Filename, NewFilename ) )
 			Start = Pos = End = GApp->CreateFileMapping( File, NewFilename, MaxSize );
+		if( Start && !MaxSize )
+			End = Start + fsize( NewFilename );
 	}
 	FArchiveFile()
 	{}
@@ -254,6 +256,9 @@ public:
 	Items stored in Unrealfiles.
 ----------------------------------------------------------------------------*/
 
+// Alignment of large swappable object data in Unrealfiles.
+enum {LINKER_PAGE_SIZE=4096};
+
 // Unrealfile summary, stored at top of file.
 struct FUnrealfileSummary
 {
@@ -397,6 +402,57 @@ class UNENGINE_API ULinker : public UObject
 	ULinkerLoad.
 ----------------------------------------------------------------------------*/
 
+// Stages of loading a file.
+enum ELoadStage
+{
+	LOAD_Reading,			// Reading the name and export tables.
+	LOAD_Exports,			// Finding or creating the objects in the export table.
+	LOAD_Headers,			// Loading object headers.
+	LOAD_Data,				// Loading object data.
+	LOAD_PostLoadHeaders,	// Calling PostLoadHeader.
+	LOAD_PostLoadData,		// Calling PostLoadData.
+	LOAD_Done,				// Finished.
+	LOAD_Failed,			// Failed with an error.
+};
+
+//
+// An entry of a file's export table as stored in the file, before its
+// class is looked up and its object is found or created.
+//
+struct FLinkerExport
+{
+	// Object base info.
+	FName	Name;						// Name of the object.
+	FName	ClassName;					// Name of the object's class, or NAME_None.
+	DWORD	Flags;						// Object flags.
+	DWORD	FileCRC;					// CRC32 value of header+data as stored in file.
+	DWORD	FileHeaderOffset;			// Offset of header, or 0 if importing.
+	DWORD	FileDataOffset;				// Offset of data.
+	DWORD	FileHeaderSize;				// Size of header.
+	DWORD	FileDataSize;				// Size of data.
+
+	// Class info, only for exported classes.
+	DWORD	PreloadParentClass;			// Object index of parent class plus one, or 0 if none.
+	FName	PreloadPackageName;			// Package name.
+	DWORD	PreloadClassFlags;			// Class flags.
+	DWORD	PreloadResThisHeaderSize;	// Size of class's header data.
+};
+
+//
+// Linker for loading objects from a file.
+//
+// Files are loaded either all at once by LoadAllObjects, or asynchronously:
+// BeginAsyncLoad starts a thread which reads the file from disk and reads its
+// name and export tables. The game thread then finds or creates the objects,
+// loads them and calls their postloaders a few at a time from TickLoad. Objects
+// from the file must not be used until IsLoadFinished returns true.
+//
+// Swappable objects whose data starts on a page boundary in the file are
+// loaded lazily: only their headers are loaded, and their data is paged in
+// from the file mapping when they are first locked. Such objects keep a
+// pointer to the linker, so the linker must outlive them or page them in
+// before it is killed.
+//
 class ULinkerLoad : public ULinker, public FArchiveFileLoad
 {
 	DECLARE_CLASS(ULinkerLoad,ULinker,NAME_LinkerLoad,NAME_UnEngine);
@@ -408,16 +464,35 @@ class ULinkerLoad : public ULinker, public FArchiveFileLoad
 	// Variables.
 	FUnrealfileSummary Summary;
 	CHAR Status[256];
+	FLinkerExport *Exports;				// The export table.
+	INT Async;							// Whether loading asynchronously.
+	volatile INT Stage;					// Current ELoadStage.
+	volatile INT ReadCount;				// Number of names and exports read so far.
+	INT Cursor;							// Next object in the current stage.
+	DWORD hThread;						// Reading thread, if asynchronous.
+	INT NumPaged;						// Number of objects loaded lazily.
+	CHAR ReadError[256];				// Why the reading thread failed, if it did.
+	INT Collected;						// Whether it's killed by the garbage collector rather than an owner.
 
 	// Constructor.
-	ULinkerLoad( const char *Filename )
+	ULinkerLoad( const char *Filename, INT InAsync=0 )
 	:	ULinker				(Filename)
 	,	FArchiveFileLoad	(Filename)
+	,	Exports				(NULL)
+	,	Async				(InAsync)
+	,	Stage				(LOAD_Reading)
+	,	ReadCount			(0)
+	,	Cursor				(0)
+	,	hThread				(0)
+	,	NumPaged			(0)
+	,	Collected			(0)
 	{
 		guard(ULinkerLoad::ULinkerLoad);
 		sprintf( Status, "Adding file %s...", Filename );
+		ReadError[0] = 0;
 
-		GApp->StatusUpdate( Status, 0, 0 );
+		if( !Async )
+			GApp->StatusUpdate( Status, 0, 0 );
 		debug( LOG_Info, Status );
 
 		// Read summary from file.
@@ -464,13 +539,23 @@ class ULinkerLoad : public ULinker, public FArchiveFileLoad
 		guard(AllocateTables);
 		ResMap	= new(GetName(),CREATE_MakeUnique)UArray  (Summary.NumObjects,1);
 		NameMap	= new(GetName(),CREATE_MakeUnique)UEnumDef(Summary.NumNames,  1);
+		Exports = (FLinkerExport*)appMalloc( Max(Summary.NumObjects,1)*sizeof(FLinkerExport), "LinkerExports" );
 		unguard;
 
-		// Add names from name map (either creates new name, or notes reference to existing one).
-		guard(LoadNames);
+		// Read the names now, unless the reading thread will.
+		if( !Async )
+			LoadNames();
+		unguard;
+	}
+
+	// Add names from name map (either creates new name, or notes reference to existing one).
+	void LoadNames()
+	{
+		guard(ULinkerLoad::LoadNames);
 		if( Summary.NumNames > 0 )
 		{
-			debugf(LOG_Info,"Reading Names: %i names",Summary.NumNames);
+			if( !Async )
+				debugf(LOG_Info,"Reading Names: %i names",Summary.NumNames);
 			
 			Seek(Summary.NamesOffset);
 			for( int i=0; i<Summary.NumNames; i++ )
@@ -492,192 +577,412 @@ class ULinkerLoad : public ULinker, public FArchiveFileLoad
 					// Not needed in this context, so don't keep it.
 					NameMap(i) = NAME_None;
 				}
+				ReadCount++;
 			}
 		}
-		unguard;
-		unguard;
+		unguardobj;
 	}
 
-	// Load all objects.
-	void LoadAllObjects()
+	// Read the export table.
+	void ReadExports()
 	{
-		guard(ULinkerLoad::LoadEverything);
-
-		// Load object bases.
-		guard(LoadObjectBases);
+		guard(ULinkerLoad::ReadExports);
+		FArchive &Ar = *this;
 		if( Summary.NumObjects > 0 )
 		{
-			debugf( LOG_Info, "Reading object bases: %i objects", Summary.NumObjects );
+			if( !Async )
+				debugf( LOG_Info, "Reading object bases: %i objects", Summary.NumObjects );
 			Seek( Summary.ObjectsOffset );
 
-			// Load the exports.
 			for( int i=0; i<Summary.NumObjects; i++ )
 			{
-				if( !(i&7) ) GApp->StatusUpdate( Status, i, Summary.NumObjects );
-
-				// Load from disk.
-				UObjectBase Object;
-				*this << Object;
-
-				if( Object.FileHeaderOffset == 0 )
+				if( !Async && !(i&7) ) GApp->StatusUpdate( Status, i, Summary.NumObjects );
+
+				// Read the object base as UObjectBase's serializer writes it.
+				FLinkerExport &Export = Exports[i];
+				Ar << Export.Name << Export.ClassName << Export.Flags << Export.FileHeaderOffset;
+				Export.PreloadParentClass       = 0;
+				Export.PreloadPackageName       = NAME_None;
+				Export.PreloadClassFlags        = 0;
+				Export.PreloadResThisHeaderSize = 0;
+				if( Export.FileHeaderOffset != 0 )
 				{
-					// Importing: look it up and stick it in the object map.
-					if( Object.Class!=NULL && Object.Name!=NAME_None )
+					Ar << Export.FileCRC << Export.FileDataOffset << Export.FileHeaderSize << Export.FileDataSize;
+
+					// Read the class preload info.
+					if( Export.ClassName == NAME_Class )
 					{
-						ResMap(i) = GObj.FindObject( Object.Name(), Object.Class, FIND_Optional );
-						if( !ResMap(i) )
-							appErrorf( "Object %s %s doesn't exist", Object.Class->GetName(), Object.Name() );
+						Ar.ByteOrderSerialize( &Export.PreloadParentClass, sizeof(DWORD) );
+						Ar << Export.PreloadPackageName << Export.PreloadClassFlags << Export.PreloadResThisHeaderSize;
 					}
-					else ResMap(i) = NULL;
 				}
-				else
+				ReadCount++;
+			}
+		}
+		unguardobj;
+	}
+
+	// Find or create the object for an entry of the export table.
+	void CreateExport( INT i )
+	{
+		guard(ULinkerLoad::CreateExport);
+		FLinkerExport &Export = Exports[i];
+		UClass *Class = Export.ClassName!=NAME_None ? new(Export.ClassName(),FIND_Existing)UClass : NULL;
+
+		if( Export.FileHeaderOffset == 0 )
+		{
+			// Importing: look it up and stick it in the object map.
+			if( Class!=NULL && Export.Name!=NAME_None )
+			{
+				ResMap(i) = GObj.FindObject( Export.Name(), Class, FIND_Optional );
+				if( !ResMap(i) )
+					appErrorf( "Object %s %s doesn't exist", Class->GetName(), Export.Name() );
+			}
+			else ResMap(i) = NULL;
+		}
+		else
+		{
+			// Handle class info preloading.
+			UClass *PreloadParentClass = NULL;
+			if( Export.PreloadParentClass )
+			{
+				if( !ResMap->IsValidIndex( Export.PreloadParentClass-1 ) )
+					appErrorf("Bad object index %i",Export.PreloadParentClass-1);
+				PreloadParentClass = (UClass*)ResMap( Export.PreloadParentClass-1 );
+			}
+
+			// Map the object into our table.
+			UObject *Res = NULL;
+			if( Class != NULL )
+			{
+				if
+				(	(GUnreal.IsEditor() && (Export.Flags&RF_LoadForEdit  ))
+				||	(GUnreal.IsClient() && (Export.Flags&RF_LoadForClient))
+				||	(GUnreal.IsServer() && (Export.Flags&RF_LoadForServer)) )
 				{
-					// Handle class info preloading.
-					UClass *PreloadParentClass      = NULL;
-					FName  PreloadPackageName       = NAME_None;
-					DWORD  PreloadClassFlags        = 0;
-					DWORD  PreloadResThisHeaderSize = 0;
-					if( Object.Class == UClass::GetBaseClass() )
+					// We will load the export.
+					//debugf("Export %s %s: %08X",Export.GetClassName(),Export.Name(),Export.Flags);
+					Res = GObj.FindObject( Export.Name(), Class, FIND_Optional );
+					if( !Res )
 					{
-						// Preload the class info.
-						*this << AR_OBJECT(PreloadParentClass);
-						*this << PreloadPackageName << PreloadClassFlags << PreloadResThisHeaderSize;
+						// Create new object.
+						Res	= (UObject *)appMalloc( Class->ResFullHeaderSize, "Res(%s)", Export.Name() );
+						Res->InitObject
+						(
+							Class,
+							INDEX_NONE,
+							Export.Name,
+							0
+						);
+						GObj.AddObject( Res );
 					}
-
-					// Map the object into our table.
-					UObject *Res = NULL;
-					if( Object.Class != NULL )
+					else
 					{
-						if
-						(	(GUnreal.IsEditor() && (Object.Flags&RF_LoadForEdit  ))
-						||	(GUnreal.IsClient() && (Object.Flags&RF_LoadForClient))
-						||	(GUnreal.IsServer() && (Object.Flags&RF_LoadForServer)) )
-						{
-							// We will load the export.
-							//debugf("Export %s %s: %08X",Export.GetClassName(),Export.Name(),Export.Flags);
-							Res = GObj.FindObject( Object.Name(), Object.Class, FIND_Optional );
-							if( !Res )
-							{
-								// Create new object.
-								Res	= (UObject *)appMalloc( Object.Class->ResFullHeaderSize, "Res(%s)", Object.Name() );
-								Res->InitObject
-								(
-									Object.Class,
-									INDEX_NONE,
-									Object.Name,
-									0
-								);
-								GObj.AddObject( Res );
-							}
-							else
-							{
-								// Replace existing object.
-								Res->UnloadData();
-								Res->PreKill();
-								if( !(Res->Flags & RF_HardcodedRes) )
-									Res->InitHeader();
-							}
-
-							// Copy UObjectBase information from file's object.
-							Res->Name               = Object.Name;
-							Res->Flags              = (Res->Flags & RF_Keep) | (Object.Flags & RF_Load) | RF_UnlinkedHeader | RF_UnlinkedData;
-							Res->Class              = Object.Class;
-							Res->FileHeaderOffset   = Object.FileHeaderOffset;
-							Res->FileHeaderSize     = Object.FileHeaderSize;
-							Res->FileCRC		    = Object.FileCRC;
-							Res->FileDataSize       = Object.FileDataSize;
-							Res->FileDataOffset     = Object.FileDataOffset;
-
-							// If it's a class, set the class's vtable pointer, and preload the class.
-							if( Object.Class == UClass::GetBaseClass() )
-							{
-								guard(PreloadClass);
-								UClass *Class = (UClass*)Res;
-
-								// Set vtable for class resource.
-								*(void**)Class = UClass::GetBaseClass()->ResVTablePtr;
-
-								// Set vital properties.
-								Class->ParentClass       = PreloadParentClass;
-								Class->PackageName       = PreloadPackageName;
-								Class->ClassFlags        = PreloadClassFlags;
-								Class->ResThisHeaderSize = PreloadResThisHeaderSize;
-								Class->ResFullHeaderSize = PreloadResThisHeaderSize;
-								if( PreloadParentClass )
-									Class->ResFullHeaderSize += PreloadParentClass->ResFullHeaderSize;
-
-								// Find class's vtable pointer.
-								Class->SetClassVTable();
-
-								unguard;
-							}
-						}
+						// Replace existing object.
+						Res->UnloadData();
+						Res->XLinker = NULL;
+						Res->PreKill();
+						if( !(Res->Flags & RF_HardcodedRes) )
+							Res->InitHeader();
 					}
 
-					// Add to object map.
-					ResMap(i) = Res;
+					// Copy UObjectBase information from file's object.
+					Res->Name               = Export.Name;
+					Res->Flags              = (Res->Flags & RF_Keep) | (Export.Flags & RF_Load) | RF_UnlinkedHeader | RF_UnlinkedData;
+					Res->Class              = Class;
+					Res->FileHeaderOffset   = Export.FileHeaderOffset;
+					Res->FileHeaderSize     = Export.FileHeaderSize;
+					Res->FileCRC		    = Export.FileCRC;
+					Res->FileDataSize       = Export.FileDataSize;
+					Res->FileDataOffset     = Export.FileDataOffset;
+
+					// If it's a class, set the class's vtable pointer, and preload the class.
+					if( Class == UClass::GetBaseClass() )
+					{
+						guard(PreloadClass);
+						UClass *ResClass = (UClass*)Res;
+
+						// Set vtable for class resource.
+						*(void**)ResClass = UClass::GetBaseClass()->ResVTablePtr;
+
+						// Set vital properties.
+						ResClass->ParentClass       = PreloadParentClass;
+						ResClass->PackageName       = Export.PreloadPackageName;
+						ResClass->ClassFlags        = Export.PreloadClassFlags;
+						ResClass->ResThisHeaderSize = Export.PreloadResThisHeaderSize;
+						ResClass->ResFullHeaderSize = Export.PreloadResThisHeaderSize;
+						if( PreloadParentClass )
+							ResClass->ResFullHeaderSize += PreloadParentClass->ResFullHeaderSize;
+
+						// Find class's vtable pointer.
+						ResClass->SetClassVTable();
+
+						unguard;
+					}
 				}
 			}
+
+			// Add to object map.
+			ResMap(i) = Res;
 		}
-		unguard;
+		unguardobj;
+	}
+
+	// Perform one object's part of a loading stage.
+	void LoadStep( INT InStage, INT i )
+	{
+		guard(ULinkerLoad::LoadStep);
+		UObject *Res = ResMap( i );
+		switch( InStage )
+		{
+			case LOAD_Exports:
+				CreateExport( i );
+				break;
+			case LOAD_Headers:
+				if( Res && (Res->Flags & RF_UnlinkedHeader) && Res->FileHeaderOffset!=0 )
+					LoadHeader( Res );
+				break;
+			case LOAD_Data:
+				if( Res && (Res->Flags & RF_UnlinkedData) && Res->FileHeaderOffset!=0 )
+				{
+					if( CanPage( Res ) )
+					{
+						// Leave the data in the file until it's needed.
+						Res->XLinker   = this;
+						Res->FileIndex = i;
+						NumPaged++;
+					}
+					else LoadData( Res, 0 );
+				}
+				break;
+			case LOAD_PostLoadHeaders:
+				if( Res && Res->FileHeaderOffset!=0 )
+					Res->PostLoadHeader( POSTLOAD_File );
+				break;
+			case LOAD_PostLoadData:
+				if( Res && Res->FileHeaderOffset!=0 && !(Res->Flags & RF_UnlinkedData) )
+					Res->PostLoadData( POSTLOAD_File );
+				break;
+		}
+		unguardobj;
+	}
+
+	// Load all objects.
+	void LoadAllObjects()
+	{
+		guard(ULinkerLoad::LoadEverything);
+		static const char *StageStatus[LOAD_Done] = {NULL,NULL,"Fabricating","Assimilating",NULL,NULL};
+
+		// Load object bases.
+		ReadExports();
+
+		// Run all the stages over all objects.
+		for( INT iStage=LOAD_Exports; iStage<LOAD_Done; iStage++ )
+		{
+			for( int i=0; i<Summary.NumObjects; i++ )
+			{
+				if( (i&15)==0 && StageStatus[iStage] )
+					GApp->StatusUpdate( StageStatus[iStage], i, Summary.NumObjects );
+				LoadStep( iStage, i );
+			}
 
 #if LINKER_LOAD_LOG
-		// Display resource map for debugging.
-		guard(DebugResMap);
-		debugf("ULinkerLoad:");
-		for( int i=0; i<ResMap->Num; i++ )
-			debugf("   %i. %s %s", i, ResMap(i)->GetClassName(), ResMap(i)->GetName() );
-		unguard;
+			// Display resource map for debugging.
+			if( iStage == LOAD_Exports )
+			{
+				guard(DebugResMap);
+				debugf("ULinkerLoad:");
+				for( int i=0; i<ResMap->Num; i++ )
+					debugf("   %i. %s %s", i, ResMap(i)->GetClassName(), ResMap(i)->GetName() );
+				unguard;
+			}
 #endif
+		}
 
-		// Load all headers.
-		guard(LoadHeaders);
-		for( int i=0; i<Summary.NumObjects; i++ )
-		{
-			if( (i&15) == 0 )
-				GApp->StatusUpdate( "Fabricating", i, Summary.NumObjects );
+		// Success.
+		Stage   = LOAD_Done;
+		Success = 1;
+		unguardobj;
+	}
 
-			UObject *Res = ResMap( i );
-			if( Res && (Res->Flags & RF_UnlinkedHeader) && Res->FileHeaderOffset!=0 )
-				LoadHeader( Res );
+	// Start loading asynchronously. The appInterlocked functions are only
+	// atomic in assembly, so without it the file is read right away.
+	void BeginAsyncLoad()
+	{
+		guard(ULinkerLoad::BeginAsyncLoad);
+		checkState(Async);
+#if ASM
+		hThread = GApp->BeginThread( AsyncMain, this );
+#else
+		AsyncMain( this );
+#endif
+		unguardobj;
+	}
+
+	// Wait for the reading thread to finish.
+	void FinishReading()
+	{
+		guard(ULinkerLoad::FinishReading);
+		if( hThread )
+		{
+			GApp->EndThread( hThread );
+			hThread = 0;
 		}
-		unguard;
+		unguardobj;
+	}
 
-		// Load all data.
-		guard(LoadData);
-		for( int i=0; i<Summary.NumObjects; i++ )
+	// Advance an asynchronous load by about Milliseconds of work on this thread.
+	// Returns 1 once the load has finished or failed.
+	INT TickLoad( FLOAT Milliseconds )
+	{
+		guard(ULinkerLoad::TickLoad);
+		if( Stage == LOAD_Reading )
+			return 0;
+		FinishReading();
+
+		// Report an error from the reading thread here.
+		if( ReadError[0] )
 		{
-			if( (i&15) == 0 )
-				GApp->StatusUpdate( "Assimilating", i, Summary.NumObjects );
+			debugf( LOG_Info, "Failed loading %s: %s", GetName(), ReadError );
+			ReadError[0] = 0;
+		}
 
-			UObject *Res = ResMap( i );
-			if( Res && (Res->Flags & RF_UnlinkedData) && Res->FileHeaderOffset!=0 )
-				LoadData( Res, 0 );
+		SQWORD EndTime = GApp->MicrosecondTime() + (SQWORD)(Milliseconds * 1000.0);
+		try
+		{
+			while( Stage < LOAD_Done )
+			{
+				for( INT n=0; n<8 && Cursor<Summary.NumObjects; n++ )
+					LoadStep( Stage, Cursor++ );
+				if( Cursor >= Summary.NumObjects )
+				{
+					Cursor = 0;
+					if( ++Stage == LOAD_Done )
+						Success = 1;
+				}
+				if( (SQWORD)GApp->MicrosecondTime() >= EndTime )
+					break;
+			}
 		}
-		unguard;
+		catch( char *Error )
+		{
+			debugf( LOG_Info, "Failed loading %s: %s", GetName(), Error );
+			Stage = LOAD_Failed;
+		}
+		return Stage >= LOAD_Done;
+		unguardobj;
+	}
 
-		// Call header postloaders.
-		guard(PostloadHeaders);
-		for( int i=0; i<Summary.NumObjects; i++ )
+	// Load progress queries.
+	INT IsLoadFinished()
+	{
+		return Stage >= LOAD_Done;
+	}
+	INT LoadFailed()
+	{
+		return Stage == LOAD_Failed;
+	}
+	FLOAT GetLoadProgress()
+	{
+		INT Total = Summary.NumNames + Summary.NumObjects * (LOAD_Done-LOAD_Exports+1);
+		INT Done  = Stage==LOAD_Reading ? ReadCount
+			:		Stage>=LOAD_Done    ? Total
+			:		Summary.NumNames + Summary.NumObjects * (Stage-LOAD_Exports+1) + Cursor;
+		return Total ? (FLOAT)Done / Total : 1.0;
+	}
+
+	// Main function of the reading thread. Touches every page of the file so
+	// it's read from disk here, then reads the name and export tables.
+	// Lazily loaded data is touched too, and is dropped again the first time
+	// its object is unloaded. Errors here must be thrown as strings rather than
+	// raised with appError, which would shut down the engine from this thread;
+	// they're recorded in ReadError, and TickLoad reports them.
+	static void AsyncMain( void *Arg )
+	{
+		ULinkerLoad *Linker = (ULinkerLoad*)Arg;
+		try
 		{
-			UObject *Res = ResMap( i );
-			if( Res && Res->FileHeaderOffset!=0 )
-				Res->PostLoadHeader( POSTLOAD_File );
+			DWORD Size = Linker->End - Linker->Start;
+			if( Linker->Summary.NamesOffset>Size || Linker->Summary.ObjectsOffset>Size )
+				throw( "Bad table offset" );
+			volatile BYTE Sum = 0;
+			for( BYTE *Page=Linker->Start; Page<Linker->End; Page+=LINKER_PAGE_SIZE )
+				Sum += *Page;
+			Linker->LoadNames();
+			Linker->ReadExports();
+			appInterlockedExchange( &Linker->Stage, LOAD_Exports );
 		}
-		unguard;
+		catch( char *Error )
+		{
+			mystrncpy( Linker->ReadError, Error, ARRAY_COUNT(Linker->ReadError) );
+			appInterlockedExchange( &Linker->Stage, LOAD_Failed );
+		}
+		catch( ... )
+		{
+			strcpy( Linker->ReadError, "Error reading file" );
+			appInterlockedExchange( &Linker->Stage, LOAD_Failed );
+		}
+	}
 
-		// Call data postloaders.
-		guard(PostLoadData);
-		for( int i=0; i<Summary.NumObjects; i++ )
+	// Whether an object's data can be left in the file until it's used.
+	INT CanPage( UObject *Res )
+	{
+		return
+		(	GDefaults.LazyLoad
+		&&	Summary.UnrealFileVersion >= UNREAL_PAGED_VERSION
+		&&	(Res->GetClassFlags() & CLASS_Swappable)
+		&&	!(Res->Flags & RF_NoFreeData)
+		&&	Res->FileDataSize >= LINKER_PAGE_SIZE
+		&&	(Res->FileDataOffset & (LINKER_PAGE_SIZE-1)) == 0 );
+	}
+
+	// Load the data of a lazily loaded object. Called by UObject::PageIn.
+	void PageIn( UObject *Res )
+	{
+		guard(ULinkerLoad::PageIn);
+		INT SavedPos = Tell();
+		LoadData( Res, 1 );
+		Seek( SavedPos );
+
+		// The copy matches the file until it's locked for writing.
+		Res->ClearFlags( RF_Modified );
+		DiscardPages( Res );
+		unguardobj;
+	}
+
+	// Forget the mapped objects which the garbage collector is about to purge.
+	// The object map itself is kept if this linker is, even when only the
+	// linker was reached.
+	void ForgetGarbage()
+	{
+		guard(ULinkerLoad::ForgetGarbage);
+		if( ResMap )
 		{
-			UObject *Res = ResMap( i );
-			if( Res && Res->FileHeaderOffset!=0 )
-				Res->PostLoadData( POSTLOAD_File );
+			if( !(Flags & RF_Unused) )
+				ResMap->ClearFlags( RF_Unused );
+			for( INT i=0; i<ResMap->Num; i++ )
+			{
+				UObject *Res = ResMap(i);
+				if( Res && (Res->GetFlags() & RF_Unused) && !(Res->GetFlags() & RF_HardcodedRes) )
+				{
+					if( Res->XLinker == this )
+						Res->XLinker = NULL;
+					ResMap(i) = NULL;
+				}
+			}
 		}
-		unguard;
+		unguardobj;
+	}
 
-		// Success.
-		Success=1;
+	// Return the file pages which lie entirely within an object's data to
+	// the operating system, since the object holds its own copy.
+	void DiscardPages( UObject *Res )
+	{
+		guard(ULinkerLoad::DiscardPages);
+		BYTE *First = Align( Start + Res->FileDataOffset, LINKER_PAGE_SIZE );
+		BYTE *Last  = (BYTE*)((DWORD)(Start + Res->FileDataOffset + Res->FileDataSize) & ~(LINKER_PAGE_SIZE-1));
+		if( Last > First )
+			GApp->DiscardFilePages( First, Last - First );
 		unguardobj;
 	}
 
@@ -685,8 +990,27 @@ class ULinkerLoad : public ULinker, public FArchiveFileLoad
 	void PreKill()
 	{
 		guard(ULinkerLoad::PreKill);
+		FinishReading();
+
+		// Lazily loaded objects can't outlive the file, so load them now.
+		if( NumPaged && ResMap )
+		{
+			for( INT i=0; i<ResMap->Num; i++ )
+			{
+				UObject *Res = ResMap(i);
+				if( Res && Res->XLinker==this )
+				{
+					Res->GetData();
+					Res->XLinker   = NULL;
+					Res->FileIndex = INDEX_NONE;
+				}
+			}
+		}
 		ULinker::PreKill();
 		Close();
+		if( Exports )
+			appFree( Exports );
+		Exports = NULL;
 		unguardobj;
 	}
 
@@ -720,7 +1044,11 @@ class ULinkerLoad : public ULinker, public FArchiveFileLoad
 		else
 		{
 			if( !NameMap->IsValidIndex(NameIndex-1) )
+			{
+				if( Async && Stage==LOAD_Reading )
+					throw( "Bad name index" );
 				appErrorf( "Bad name index %i/%i", NameIndex, NameMap->Num );
+			}
 			
 			Name = NameMap( NameIndex-1 );
 		}
@@ -768,6 +1096,7 @@ class ULinkerLoad : public ULinker, public FArchiveFileLoad
 		// Link it.
 		Seek( Res->FileHeaderOffset );
 		Res->SerializeHeader( *this );
+		GObj.WriteBarrier( Res );
 
 		// Make sure we serialized the right amount of stuff.
 		DWORD Got = Tell() - Res->FileHeaderOffset;
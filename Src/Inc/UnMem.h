@@ -19,6 +19,49 @@
 enum EMemZeroed {MEM_Zeroed=1};
 enum EMemOned   {MEM_Oned  =1};
 
+/*-----------------------------------------------------------------------------
+	FMemChunkPool.
+-----------------------------------------------------------------------------*/
+
+// A pool of memory stack chunks kept apart from the memory cache, so that
+// task threads can take and return chunks without locking. Chunks come in
+// power-of-two size classes, each with a free list whose head holds a
+// chunk index and a tag which changes on every update, so compare-exchange
+// can't mistake a head that was popped and pushed back for an unchanged one.
+// Chunks are allocated the first time a class runs dry, and kept until Exit.
+// Not constructed; a zero-initialized static starts out empty.
+class UNENGINE_API FMemChunkPool
+{
+public:
+	// Constants.
+	enum {MAX_POOL_CHUNKS=4096};	// Most chunks the pool can hold.
+	enum {NUM_CHUNK_CLASSES=8};		// Number of chunk size classes.
+	enum {MIN_CHUNK_SIZE=65536};	// Size of the smallest class.
+
+	// A chunk of memory.
+	struct FPoolChunk
+	{
+		BYTE	*Data;		// The chunk's memory.
+		INT		Size;		// Size of the memory.
+		INT		Next;		// Index of next free chunk in its class, or INDEX_NONE.
+	};
+
+	// Functions.
+	FPoolChunk *Alloc( INT MinSize );
+	void Free( FPoolChunk *Chunk );
+	void Exit();
+	void Status( FOutputDevice *Out );
+
+private:
+	// Variables.
+	FPoolChunk		Chunks[MAX_POOL_CHUNKS];
+	volatile INT	NumChunks;
+	volatile INT	FreeHeads[NUM_CHUNK_CLASSES];	// Tag in high word, chunk index+1 in low word.
+	volatile INT	BytesTotal;
+	volatile INT	BytesInUse;
+	volatile INT	BytesPeak;
+};
+
 /*-----------------------------------------------------------------------------
 	FMemStack.
 -----------------------------------------------------------------------------*/
@@ -55,11 +98,15 @@ public:
 	}
 
 	// Main functions.
-	void Init(FMemCache &Cache, int MinChunkSize, int MaxChunkSize);
+	void Init(FMemCache &Cache, int MinChunkSize, int MaxChunkSize, const char *InName="Stack");
+	void Init(FMemChunkPool &Pool, int MinChunkSize, int MaxChunkSize, const char *InName="Stack");
 	void Exit();
 	void Tick();
 	int  GetByteCount();
 
+	// Report the chunk high water marks of all memory stacks.
+	static void Status( FOutputDevice *Out, INT Reset=0 );
+
 	// Friends.
 	friend class FMemMark;
 	friend inline void *operator new( size_t Size, FMemStack &Mem, int Count=1, int Align=DEFAULT_ALIGNMENT );
@@ -72,6 +119,7 @@ private:
 
 	// Variables.
 	FMemCache		*GCache;		// The memory cache we use for chunk allocation.
+	FMemChunkPool	*Pool;			// The chunk pool we use instead, if not NULL.
 	BYTE			*Top;			// Top of current chunk (Top<=End).
 	BYTE			*End;			// End of current chunk.
 	INT				MinChunkSize;	// Minimum chunk size to allocate.
@@ -80,11 +128,24 @@ private:
 	BYTE			Instance;		// Unique instance number of this memory cache.
 	static BYTE		InstanceCount;	// Number of memory stacks allocated.
 
-	// Chunk cache items.
+	// Chunk cache items, or pool chunks if using a pool.
 	FCacheItem		*Chunks[MAX_CHUNKS]; // Only chunks 0..ActiveChunks-1 are valid.
+	FMemChunkPool::FPoolChunk *PoolChunks[MAX_CHUNKS];
+
+	// High water marks.
+	char			Name[32];		// Name for the status report.
+	INT				ChunkBytes;		// Bytes in active chunks.
+	INT				PeakChunks;		// Most chunks active at once.
+	INT				PeakBytes;		// Most bytes in active chunks at once.
+	INT				NumAllocs;		// Number of chunks allocated.
+	FMemStack		*NextStack;		// Next memory stack in the list of all of them.
+	static FMemStack *FirstStack;	// First memory stack.
 
 	// Functions.
+	void InitStack(int MinChunkSize, int MaxChunkSize, const char *InName);
 	BYTE *AllocateNewChunk(int MinSize, int Align);
+	void ReleaseChunk();
+	void NoteChunk(INT Size);
 };
 
 /*-----------------------------------------------------------------------------
@@ -158,9 +219,9 @@ public:
 		guardSlow(FMemMark::Pop);
 		checkState(ActiveChunks<=Mem->ActiveChunks);
 
-		// Unlock any new chunks that were allocated.
+		// Release any new chunks that were allocated.
 		while( Mem->ActiveChunks > ActiveChunks )
-			Mem->Chunks[--Mem->ActiveChunks]->Unlock();
+			Mem->ReleaseChunk();
 
 		// Restore the memory stack's state.
 		Mem->Top = Top;
@@ -212,6 +212,10 @@ class UNENGINE_API UMeshVertConnects : public UDatabase
 // A mesh, completely describing a 3D object (creature, weapon, etc) and
 // its animation sequences.  Does not reference textures.
 //
+// When GDefaults.MeshStreams is set, keyframes are unpacked once into
+// float streams in the cache and animated from there, and vertex normals
+// are cached for each pair of keyframes and blend bucket between them.
+//
 class UNENGINE_API UMesh : public UPrimitive
 {
 	DECLARE_CLASS(UMesh,UPrimitive,NAME_Mesh,NAME_UnEngine)
@@ -222,6 +226,7 @@ class UNENGINE_API UMesh : public UPrimitive
 
 	// Constants.
 	enum {NUM_TEXTURES=16};
+	enum {NORMAL_BUCKETS=8};	// Blends between two keyframes with cached normals.
 
 	// Objects.
 	UMeshVerts::Ptr			Verts;
@@ -334,6 +339,9 @@ class UNENGINE_API UMesh : public UPrimitive
 		unguardSlow;
 	}
 	BYTE GetFrame( class FTransSample *Verts, UCamera *Camera, AActor *Owner );
+	INT GetFrameNormals( FVector *Norms, UCamera *Camera, AActor *Owner );
+	void ComputeNormals( FVector *Norms, const class FTransSample *Verts );
+	static void Bench( UMesh *Mesh, INT NumMeshes, INT Frames, FOutputDevice *Out );
 	UTexture* GetTexture( int Count, AActor* Owner )
 	{
 		guardSlow(UMesh::GetTexture);
@@ -345,6 +353,15 @@ class UNENGINE_API UMesh : public UPrimitive
 			return GGfx.DefaultTexture;
 		unguardSlow;
 	}
+
+private:
+	// Animation internals.
+	void GetFrameCoords( UCamera *Camera, AActor *Owner, FCoords &Coords, FVector &Location );
+	void GetFrameKeys( const FMeshAnimSeq *Seq, FLOAT AnimFrame, INT &iFrame1, INT &iFrame2, FLOAT &Alpha );
+	BYTE AnimateFrame( class FTransSample *Verts, FVector *CachedVerts, const FCoords &Coords, const FVector &Location, INT iFrame1, INT iFrame2, FLOAT Alpha, UCamera *Camera );
+	void AnimateNormals( FVector *Norms, const FCoords &Coords, INT iFrame1, INT iFrame2, FLOAT Alpha );
+	FLOAT* LockFrameStream( INT iFrame, FCacheItem *&Item );
+	FLOAT* LockNormalStream( INT iFrame1, INT iFrame2, INT iBucket, FCacheItem *&Item );
 };
 
 /*----------------------------------------------------------------------------
@@ -138,6 +138,8 @@ class UNENGINE_API UModel : public UPrimitive
 	void	SetPivotPoint		(FVector *PivotLocation,int SnapPivotToGrid);
 	void	CopyPosRotScaleFrom	(UModel *OtherModel);
 	void	EmptyModel			(int EmptySurfInfo,int EmptyPolys);
+	void	LineCheckBatch		(FLineCheckRay *Rays,INT NumRays,DWORD ExtraNodeFlags);
+	void	TestLineCheckBatch	(INT NumRays,DWORD ExtraNodeFlags,FOutputDevice *Out);
 	void	ShrinkModel			();
 
 	// UModel collision functions.
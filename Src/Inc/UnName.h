@@ -21,6 +21,9 @@ enum {NAME_SIZE	= 32};
 // Name index.
 typedef WORD NAME_INDEX;
 
+// Maximum number of names, limited by the size of NAME_INDEX.
+enum {MAX_NAMES = 0xFFFF};
+
 // Enumeration for finding name.
 enum EFindName
 {
@@ -42,6 +45,8 @@ struct FNameEntry
 	NAME_INDEX	Index;				// Index of name in hash.
 	DWORD		Flags;				// RF_TagImport, RF_TagExport, RF_HardcodedName.
 	FNameEntry	*HashNext;			// Pointer to the next entry in this hash bin's linked list.
+	DWORD		HashValue;			// Case-insensitive hash of the name, strihash(Name).
+	DWORD		Length;				// Length of the name, strlen(Name).
 
 	// The name string.
 	char		Name[NAME_SIZE];	// Name, variable-sized.
@@ -62,6 +67,8 @@ struct FNameEntry
 		NameEntry->Index      = Index;
 		NameEntry->Flags      = Flags;
 		NameEntry->HashNext   = HashNext;
+		NameEntry->HashValue  = strihash( Name );
+		NameEntry->Length     = strlen( Name );
 		strcpy( NameEntry->Name, Name );
 		return NameEntry;
 
@@ -77,6 +84,8 @@ struct FNameEntryV
 	DWORD		Index;
 	DWORD		Flags;
 	FNameEntry	*HashNext;
+	DWORD		HashValue;
+	DWORD		Length;
 	CHAR		Name[];
 };
 
@@ -86,7 +95,7 @@ struct FNameEntryV
 
 // Automatically register a name.
 #define AUTOREGISTER_NAME( num, namestr, flags ) \
-	FNameEntryV namestr##NAME = { num, flags, NULL, #namestr }; \
+	FNameEntryV namestr##NAME = { num, flags, NULL, 0, 0, #namestr }; \
 	BYTE namestr##AUTONAME = GAutoregisterName( namestr##NAME );
 
 /*----------------------------------------------------------------------------
@@ -98,6 +107,11 @@ struct FNameEntryV
 // into the name table and every name in Unreal is stored once
 // and only once in that table.  Names are case-insensitive.
 //
+// Names may be found and added from any thread without locking. The table
+// never moves, entries are published into the hash with compare-exchange,
+// and free indices are kept on a lock-free stack. Deleting names is only
+// done by the garbage collector while no other thread is using names.
+//
 class UNENGINE_API FName 
 {
 	// Friends.
@@ -180,10 +194,17 @@ private:
 	NAME_INDEX			Index;			 // Index of this name.
 
 	// Static variables.
-	static INDEX		MaxNames; 		 // Maximum names in global name table.
-	static FNameEntry	**Names;   		 // Global table of names.
-	static FNameEntry   *NameHash[1024]; // Hashed names.
+	static INDEX		MaxNames; 		 // One past the highest index ever used in the name table.
+	static FNameEntry	**Names;   		 // Global table of names, MAX_NAMES long.
+	static FNameEntry   *NameHash[4096]; // Hashed names.
 	static INT          InitedHash;		 // Whether hash has been initialized.
+	static NAME_INDEX	*NextFree;		 // Next free index after each free index below MaxNames.
+	static INT			FreeHead;		 // First free index in the low word, ABA tag in the high word.
+
+	// Static functions.
+	static FNameEntry *FindEntry( FNameEntry *First, FNameEntry *Last, const char *Name, DWORD HashValue, DWORD Length );
+	static INDEX AllocIndex();
+	static void FreeIndex( INDEX i );
 };
 
 /*----------------------------------------------------------------------------
@@ -149,6 +149,22 @@ struct FObjectHashLink
 	{}
 };
 
+//
+// Incremental garbage collection statistics.
+//
+struct FGarbageStats
+{
+	INT		Cycles;				// Incremental cycles finished.
+	INT		MinorCycles;		// Cycles which only collected young objects.
+	INT		Scanned;			// Objects scanned by the current or last cycle.
+	INT		Purged;				// Objects purged by the last cycle.
+	INT		Pauses;				// Ticks which did collection work.
+	FLOAT	LastPause;			// Milliseconds spent collecting in the last such tick.
+	FLOAT	MaxPause;			// Longest such tick.
+	FLOAT	TotalPause;			// Total of all such ticks.
+	FLOAT	FullPause;			// Milliseconds taken by the last full CollectGarbage.
+};
+
 //
 // The global object manager.  This tracks all information about all
 // active objects, names, types, and files.
@@ -162,11 +178,23 @@ class UNENGINE_API FGlobalObjectManager
 	friend class ULinkerLoad;
 	friend class ULinkerSave;
 	friend class UClass;
+	friend class FArchiveShadeGray;
 
 public:
 	// Hash.
 	enum {HASH_COUNT=1024};
 
+	// Asynchronous loading.
+	enum {MAX_ASYNC_LOADS=16};
+	FLOAT AsyncLoadMsec;			// Milliseconds per tick spent finishing asynchronous loads.
+
+	// Incremental garbage collection.
+	enum EGarbageState {GC_Idle, GC_Marking};
+	FLOAT GarbageMsec;				// Milliseconds per tick spent marking.
+	INT GarbagePeriod;				// Ticks between the end of one cycle and the start of the next.
+	INT GarbageFullEvery;			// Every n'th cycle collects all objects, the rest only young ones.
+	FGarbageStats GarbageStats;		// Statistics.
+
 	// Accessors.
 	DWORD GetMaxRes() {return MaxRes;}
 	UObject *GetResArray(DWORD i) {return ResArray[i];}
@@ -176,6 +204,7 @@ public:
 	void Exit();
 	int	 Exec(const char *Cmd,FOutputDevice *Out=GApp);
 	void Tick();
+	void DumpClassMemory(FOutputDevice *Out, INT Csv=0);
 
 	// Root object.
 	void AddToRoot(UObject *Res);
@@ -183,6 +212,10 @@ public:
 
 	// Unrealfiles.
 	int AddFile(const char *Filename, ULinkerLoad **Linker,int NoWarn=0);
+	ULinkerLoad *AddFileAsync(const char *Filename,int NoWarn=0);
+	void TickAsyncLoads(FLOAT Milliseconds);
+	int AsyncLoadsPending() {return NumAsyncLoads;}
+	void ReleaseLazyLinkers();
 	int Save(UObject *Res, const char *Filename, int NoWarn=0);
 	int SaveDependent(UObject *Res, const char *Filename, int NoWarn=0);
 	int SaveTagged(const char *Filename,int NoWarn=0);
@@ -201,6 +234,7 @@ public:
 	void CollectGarbage(FOutputDevice *Out);
 	int IsReferenced(UObject *&Res);
 	int AttemptPurge(UObject *&Res);
+	void WriteBarrier(UObject *Res);
 
 	// Internal.
 	UObject *CreateObject(const char *Name, UClass *Class, ECreateObject Create, DWORD SetFlags=0);
@@ -214,11 +248,31 @@ private:
 	UArray			*Root;	 		// Root array, for tracking active objects.
 	UObject 		**ResArray;	 	// Global table of all objects.
 	FObjectHashLink	**ResHash;		// Object hash.
+	ULinkerLoad		*AsyncLoads[MAX_ASYNC_LOADS]; // Files being loaded asynchronously, oldest first.
+	INT				NumAsyncLoads;	// Number of files being loaded asynchronously.
+	INT				GarbageState;	// Current EGarbageState.
+	INT				GarbageMinor;	// Whether the current cycle only collects young objects.
+	INT				GarbageTicks;	// Ticks since the last cycle ended.
+	UObject			**GrayStack;	// Objects waiting to be scanned by the current cycle.
+	INT				GrayNum;		// Number of objects on the gray stack.
+	INT				GrayMax;		// Allocated size of the gray stack and GrayIndex.
+	INT				*GrayIndex;		// Each object's position on the gray stack, or INDEX_NONE.
+	FSpinLock		GrayLock;		// Serializes the gray stack while task threads run.
 
 	// Internal functions.
 	void AddObject(UObject *Res);
 	void TagGarbage();
-	void PurgeGarbage(FOutputDevice *Out);
+	INT  PurgeGarbage(FOutputDevice *Out, INT PurgeNames=1);
+	void TickGarbage(FLOAT Milliseconds);
+	void BeginGarbage(INT Minor);
+	INT  StepGarbage(SQWORD EndTime);
+	void FinishMark();
+	INT  FinishGarbage(FOutputDevice *Out);
+	void AbortGarbage();
+	void PromoteSurvivors();
+	void Shade(UObject *Res);
+	void Unshade(UObject *Res);
+	void GrowGray();
 };
 
 /*-----------------------------------------------------------------------------
@@ -462,18 +516,18 @@ enum EObjectFlags
 	RF_HardcodedRes     = 0x000200, // Hardcoded object; don't free or export it.
 	RF_HighlightedName  = 0x000400, // A hardcoded name which should be syntax-highlighted.
 	RF_InSingularFunc   = 0x000800, // In a singular function.
-	RF_Unused1          = 0x001000, // Unused.
+	RF_GCRemember       = 0x001000, // Old object modified since the last garbage collection.
 	RF_Temp1			= 0x002000,	// Temporary flag for user routines.
 	RF_UnlinkedHeader	= 0x004000,	// During load/save, indicates that objects/names are unlinked.
 	RF_UnlinkedData		= 0x008000,	// During load/save, indicates that objects/names are unlinked.
 	RF_LoadForClient	= 0x010000,	// In-file load for client.
 	RF_LoadForServer	= 0x020000,	// In-file load for client.
 	RF_LoadForEdit		= 0x040000,	// In-file load for client.
-	RF_Unused2          = 0x080000, // Unused;
+	RF_GCGray           = 0x080000, // Waiting to be scanned by the incremental garbage collector.
 	RF_NotForClient		= 0x100000,	// Don't load this object for the game client.
 	RF_NotForServer		= 0x200000,	// Don't load this object for the game server.
 	RF_NotForEdit		= 0x400000,	// Don't load this object for the editor.
-	RF_Unused3          = 0x800000, // Unused.
+	RF_Young            = 0x800000, // Created since the last garbage collection.
 	RF_ContextFlags		= RF_NotForClient | RF_NotForServer | RF_NotForEdit, // All context flags.
 	RF_LoadContextFlags	= RF_LoadForClient | RF_LoadForServer | RF_LoadForEdit, // Flags affecting loading.
 	RF_Load  			= RF_LoadContextFlags, // Flags to load from Unrealfiles.
@@ -535,10 +589,11 @@ class UNENGINE_API UObject : private UObjectBase
 	// Friends.
 	friend class FGlobalObjectManager;
 	friend class ULinker;
+	friend class ULinkerLoad;
 
 private:
 	// Information relevent in memory only.
-	ULinker*		XLinker;			// Linker it came from or NULL if none.
+	ULinker*		XLinker;			// Linker to page its data in from, or NULL if none.
 	void*			Data;				// Pointer to data in memory, not meaningful when stored on disk.
 	mutable INT		ReadLocks;			// Number of read locks applied.
 	INT				WriteLocks;			// Number of write locks applied.
@@ -617,14 +672,18 @@ public:
 	{
 		// GetData is only valid when an object is locked or is not swappable.
 		//debugState( IsLocked() || !(GetClassFlags() & CLASS_Swappable) );
+		if( XLinker && (Flags & RF_UnlinkedData) ) PageIn();
 		return Data;
 	}
 	const void*  GetData() const
 	{
 		// GetData is only valid when an object is locked or is not swappable.
 		//debugState( IsLocked() || !(GetClassFlags() & CLASS_Swappable) );
+		if( XLinker && (Flags & RF_UnlinkedData) ) PageIn();
 		return Data;
 	}
+	INT			IsPagedOut() const			{return XLinker && (Flags & RF_UnlinkedData);}
+	void		PageIn() const;
 };
 
 /*-----------------------------------------------------------------------------
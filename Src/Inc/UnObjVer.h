@@ -16,12 +16,16 @@
 -----------------------------------------------------------------------------*/
 
 // The current Unrealfile version.
-#define UNREAL_FILE_VERSION 23
+#define UNREAL_FILE_VERSION 24
 
 // The earliest file version which we can load with complete
 // backwards compatibility. Must be at least UNREAL_FILE_VERSION.
 #define UNREAL_MIN_VERSION 22
 
+// The earliest file version which stores large swappable object data
+// on page boundaries, so that it can be loaded lazily.
+#define UNREAL_PAGED_VERSION 24
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
@@ -168,6 +168,7 @@ private:
 	int checkLeftPassage(FVector &currentDirection);
 	int outReachable(FVector start, FVector destination);
 	int fullyReachable(FVector start, FVector destination);
+	void batchReachable(const FVector &start, BYTE *reach);
 	int needPath(const FVector &start);
 	int sawNewLeft(const FVector &start);
 	int oneWaypointTo(const FVector &upstreamSpot);
@@ -94,7 +94,7 @@ class FGlobalPlatform : public FOutputDevice
 {
 public:
 
-	enum {PLATFORM_VERSION=5};
+	enum {PLATFORM_VERSION=7};
 
 	///////////////
 	// Variables //
@@ -197,6 +197,19 @@ public:
 	virtual int		IsNan(FLOAT f);
 	virtual int     FindFile(const char *In,char *Out);
 
+	// Threading.
+	virtual INT		NumProcessors();
+	virtual DWORD	BeginThread(void (*ThreadProc)(void *Arg),void *Arg);
+	virtual void	EndThread(DWORD hThread);
+	virtual DWORD	NewSemaphore(INT InitialCount);
+	virtual void	FreeSemaphore(DWORD hSemaphore);
+	virtual void	SignalSemaphore(DWORD hSemaphore,INT Count);
+	virtual void	WaitSemaphore(DWORD hSemaphore);
+	virtual void	YieldThread();
+
+	// Virtual memory.
+	virtual void	DiscardFilePages(void *Start,INT Size);
+
     // Reading/writing profile (.ini) values.
     virtual const char * DefaultProfileFileName() const; // What is the default profile file name?
     virtual const char * FactoryProfileFileName() const; // What is the factory-settings profile file name?
@@ -254,6 +254,63 @@ inline INT ftoi(FLOAT F)
 #endif
 }
 
+// Thread-local variable storage class.
+#define THREAD_LOCAL __declspec(thread)
+
+// Atomically add Value to *Addend and return the previous value.
+inline INT appInterlockedAdd( volatile INT* Addend, INT Value )
+{
+#if ASM
+	INT Result;
+	__asm mov  ecx,[Addend]
+	__asm mov  eax,[Value]
+	__asm lock xadd [ecx],eax
+	__asm mov  [Result],eax
+	return Result;
+#else
+	INT Result = *Addend;		// Note: Not atomic.
+	*Addend   += Value;
+	return Result;
+#endif
+}
+
+// Atomically replace *Dest with Exchange if it equals Comparand.
+// Returns the previous value of *Dest.
+inline INT appInterlockedCompareExchange( volatile INT* Dest, INT Exchange, INT Comparand )
+{
+#if ASM
+	INT Result;
+	__asm mov  ecx,[Dest]
+	__asm mov  edx,[Exchange]
+	__asm mov  eax,[Comparand]
+	__asm lock cmpxchg [ecx],edx
+	__asm mov  [Result],eax
+	return Result;
+#else
+	INT Result = *Dest;			// Note: Not atomic.
+	if( Result == Comparand )
+		*Dest = Exchange;
+	return Result;
+#endif
+}
+
+// Atomically set *Dest to Value and return the previous value.
+inline INT appInterlockedExchange( volatile INT* Dest, INT Value )
+{
+#if ASM
+	INT Result;
+	__asm mov  ecx,[Dest]
+	__asm mov  eax,[Value]
+	__asm xchg [ecx],eax
+	__asm mov  [Result],eax
+	return Result;
+#else
+	INT Result = *Dest;			// Note: Not atomic.
+	*Dest      = Value;
+	return Result;
+#endif
+}
+
 /*----------------------------------------------------------------------------
 	Some specific mac compiler.
 ----------------------------------------------------------------------------*/
@@ -63,6 +63,21 @@ struct FCheckResult : public FIteratorActorList
 	{ return A.Time - B.Time; }
 };
 
+//
+// One ray of a batched line check.
+//
+struct FLineCheckRay
+{
+	// Input.
+	FVector			Start;		// Start location.
+	FVector			End;		// End location.
+	FVector			Extent;		// Collision extent, zero for a simple line.
+
+	// Output.
+	FCheckResult	Hit;		// What was hit, if blocked.
+	INT				Clear;		// 1 if unblocked, 0 if blocked.
+};
+
 /*-----------------------------------------------------------------------------
 	UPrimitive.
 -----------------------------------------------------------------------------*/
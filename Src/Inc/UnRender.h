@@ -416,6 +416,12 @@ struct FBspDrawList
 		INT BoxOutOfPyramid;	// Boxes out of view pyramid.
 		INT BoxSpanOccluded;	// Boxes occluded by span buffer.
 
+		// Frame-coherent occlusion:
+		INT OccNodesVisited;	// Nodes entered by the occlusion traversal.
+		INT OccSubtreesSkipped;	// Subtrees occluded on the prev. frame, skipped unchecked.
+		INT OccSubtreesChecked;	// Subtrees occluded on the prev. frame, bound checked.
+		INT OccSubtreesRejected;// Checked subtrees whose bounds were still occluded.
+
 		// Actor drawing stats:
 		INT NumSprites;			// Number of sprites filtered.
 		INT NumChunks;			// Number of final chunks filtered.
@@ -444,7 +450,7 @@ struct FBspDrawList
 		INT ClipNil;			// Polygons clipped into oblivion.
 
 		// Memory:
-		INT GMem;				// Bytes used in global memory pool.
+		INT GMainMem;			// Bytes used in main memory pool.
 		INT GDynMem;			// Bytes used in dynamics memory pool.
 
 		// Zone rendering:
@@ -463,6 +469,8 @@ struct FBspDrawList
 
 		// Lighting:
 		INT Lightage,LightMem,MeshPtsGen,MeshesGen;
+		INT StaticMapsGen;		// Static light maps regenerated.
+		INT LightDeltas;		// Dynamic light maps merged over static ones.
 
 		// Textures:
 		INT UniqueTextures,UniqueTextureMem,CodePatches;
@@ -816,11 +824,13 @@ private:
 	INT 			DynamicsLocked;
 	INDEX			NumPostDynamics;
 	FBspNode		**PostDynamics;
+	DWORD			*OccStamps;		// Frame each Bsp node's subtree was last found occluded by the span buffers.
+	INT				MaxOccStamps;	// Number of nodes OccStamps has room for.
 
 	INT 			RendIter,TemporalIter,ShowLattice,Antialias;
 	INT 			DoDither,ShowChunks,Temporal,Curvy;
 	INT 			Toggle,Extra1,Extra2,Extra3,Extra4,LeakCheck;
-	INT 			QuickStats,AllStats;
+	INT 			QuickStats,AllStats,Coherent,Banded,FastTmap;
 	INT				Pad[6];
 	FLOAT			MipMultiplier;
 
@@ -977,6 +987,7 @@ void rendDrawAcross (UCamera *Camera,FSpanBuffer *SpanBuffer,
 	FSpanBuffer *SubRectSpanBuffer, FSpanBuffer *SubLatticeSpanBuffer,
 	int Sampled);
 void rendDrawAcrossExit();
+void rendTestTexLoops(INT Runs, FOutputDevice *Out);
 
 /*------------------------------------------------------------------------------------
 	Fast approximate math code.
@@ -177,6 +177,47 @@ enum EExprToken
 	EX_Max					= 0x1000,
 };
 
+//
+// Pre-decoded expression types used by the threaded interpreter.  Expression
+// tokens which aren't pre-decoded are dispatched through GIntrinsics.
+//
+enum EThreadedOp
+{
+	TOP_Intrinsic			= 0x00,		// Not pre-decoded, dispatch through GIntrinsics.
+	TOP_LocalVariable		= 0x01,		// Local variable, Aux=offset.
+	TOP_ObjectVariable		= 0x02,		// Object variable, Aux=offset.
+	TOP_Jump				= 0x03,		// Jump, Aux=code offset.
+	TOP_JumpIfNot			= 0x04,		// Jump if not expression, Aux=code offset.
+	TOP_Let					= 0x05,		// Assign arbitrary size value, Aux=size.
+	TOP_Let1				= 0x06,		// Assign to 1-byte variable.
+	TOP_Let4				= 0x07,		// Assign to 4-byte variable.
+	TOP_IntConst			= 0x08,		// Int constant, Aux=code length.
+	TOP_FloatConst			= 0x09,		// Float constant.
+	TOP_ByteConst			= 0x0A,		// Byte constant.
+	TOP_NameConst			= 0x0B,		// Name constant, Aux=name index.
+	TOP_ObjectConst			= 0x0C,		// Object constant, Aux=code length.
+	TOP_Self				= 0x0D,		// Self actor.
+	TOP_Nothing				= 0x0E,		// No operation.
+};
+
+//
+// A pre-decoded expression.  A script's threaded code contains one of these
+// for each byte of code, but only entries at the start of an expression are
+// meaningful.
+//
+struct FThreadedOp
+{
+	BYTE	Op;					// EThreadedOp.
+	BYTE	Pad;				// Unused.
+	WORD	Aux;				// Offset, size, code length or name index, depending on Op.
+	union
+	{
+		INT			Int;		// Inline int or byte constant.
+		FLOAT		Float;		// Inline float constant.
+		UObject*	Object;		// Inline object constant.
+	};
+};
+
 /*-----------------------------------------------------------------------------
 	UScript.
 -----------------------------------------------------------------------------*/
@@ -200,11 +241,17 @@ class UNENGINE_API UScript : public UBuffer, public FArchive
 
 	// Variables.
 	UClass *Class;
+	FThreadedOp *Threaded;		// Pre-decoded code for the threaded interpreter (in memory only).
+	INT Reach;					// 0=not scanned, 1=code only touches its own object, 2=code reaches other objects (in memory only).
 
 	// Constructor.
 	UScript(UClass *InClass)
 	:	Class(InClass) {}
 
+	// UObject interface.
+	void InitHeader();
+	void UnloadData();
+
 	// UObject interface.
 	void SerializeHeader(FArchive &Ar)
 	{
@@ -215,6 +262,11 @@ class UNENGINE_API UScript : public UBuffer, public FArchive
 	}
 	void SerializeData(FArchive &Ar);
 
+	// UScript interface.
+	void BuildThreaded();
+	void FreeThreaded();
+	INT  ReachesOtherObjects();
+
 private:
 	// FArchive interface, relevant only to script compiler.
 	FArchive& Serialize(const void *V, int Length)
@@ -393,6 +445,17 @@ extern UNENGINE_API void (*GIntrinsics[])( FExecStack &Stack, UObject *Context,
 int UNENGINE_API RegisterIntrinsic(int iIntrinsic, void (*Func)( FExecStack &Stack, UObject *Context, BYTE *&Result ));
 void UNENGINE_API execUndefined( FExecStack &Stack, UObject *Context, BYTE *&Result  );
 
+//
+// Threaded interpreter.
+//
+extern UNENGINE_API INT GScriptThreaded;
+void UNENGINE_API scriptThreadedEval( FExecStack &Stack, UObject *Context, BYTE *&Result );
+
+//
+// Virtual function call site cache.
+//
+void UNENGINE_API scriptFlushVfCache();
+
 //
 // Registering an intrinsic function.
 //
@@ -406,36 +469,36 @@ void UNENGINE_API execUndefined( FExecStack &Stack, UObject *Context, BYTE *&Res
 //
 // Macros for grabbing parameters for intrinsic functions.
 //
-#define P_GET_INT(var)              INT           var;   {INT *Ptr=&var;       (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_INT_OPT(var,def)      INT       var=def;   {INT *Ptr=&var;       (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_INT_REF(var)          INT   a##var=0,*var=&a##var;              {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_BOOL(var)             DWORD         var;   {DWORD *Ptr=&var;     (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_BOOL_OPT(var,def)     DWORD     var=def;   {DWORD *Ptr=&var;     (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_BOOL_REF(var)         DWORD a##var=0,*var=&a##var;              {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_FLOAT(var)            FLOAT         var;   {FLOAT *Ptr=&var;     (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_FLOAT_OPT(var,def)    FLOAT     var=def;   {FLOAT *Ptr=&var;     (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_FLOAT_REF(var)        FLOAT a##var=0.0,*var=&a##var;            {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_BYTE(var)             BYTE          var;   {BYTE *Ptr=&var;      (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_BYTE_OPT(var,def)     BYTE      var=def;   {BYTE *Ptr=&var;      (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_BYTE_REF(var)         BYTE  a##var=0,*var=&a##var;              {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_NAME(var)             FName         var;   {FName *Ptr=&var;     (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_NAME_OPT(var,def)     FName     var=def;   {FName *Ptr=&var;     (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_NAME_REF(var)         FName a##var=NAME_None,*var=&a##var;      {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_ACTOR(var)            AActor       *var;   {AActor **Ptr=&var;   (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_ACTOR_OPT(var,def)    AActor   *var=def;   {AActor **Ptr=&var;   (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_ACTOR_REF(var)        AActor *a##var=NULL,**var=&a##var;        {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_VECTOR(var)           FVector       var;   {FVector *Ptr=&var;   (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_VECTOR_OPT(var,def)   FVector   var=def;   {FVector *Ptr=&var;   (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_VECTOR_REF(var)       FVector a##var(0,0,0),*var=&a##var;       {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_ROTATION(var)         FRotation     var;   {FRotation *Ptr=&var; (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_ROTATION_OPT(var,def) FRotation var=def;   {FRotation *Ptr=&var; (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_ROTATION_REF(var)     FRotation a##var(0,0,0),*var=&a##var;     {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_OBJECT(cls,var)       cls          *var;   {cls**Ptr=&var;       (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_OBJECT_OPT(var,def)   UObject*var=def;     {UObject**Ptr=&var;   (*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
-#define P_GET_OBJECT_REF(var)       UObject*a##var=NULL,**var=&a##var;        {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
-#define P_GET_STRING(var)           CHAR var##T[MAX_STRING_CONST_SIZE], *var=var##T; {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object,*(BYTE**)&var);     }
-#define P_GET_STRING_OPT(var,def)   CHAR var##T[MAX_STRING_CONST_SIZE]=def, *var=var##T; {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object,*(BYTE**)&var); }
-#define P_GET_STRING_REF(var)       CHAR a##var[MAX_STRING_CONST_SIZE],*var=a##var; {(*GIntrinsics[*Stack.Code++])( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_INT(var)              INT           var;   {INT *Ptr=&var;       scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_INT_OPT(var,def)      INT       var=def;   {INT *Ptr=&var;       scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_INT_REF(var)          INT   a##var=0,*var=&a##var;              {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_BOOL(var)             DWORD         var;   {DWORD *Ptr=&var;     scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_BOOL_OPT(var,def)     DWORD     var=def;   {DWORD *Ptr=&var;     scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_BOOL_REF(var)         DWORD a##var=0,*var=&a##var;              {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_FLOAT(var)            FLOAT         var;   {FLOAT *Ptr=&var;     scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_FLOAT_OPT(var,def)    FLOAT     var=def;   {FLOAT *Ptr=&var;     scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_FLOAT_REF(var)        FLOAT a##var=0.0,*var=&a##var;            {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_BYTE(var)             BYTE          var;   {BYTE *Ptr=&var;      scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_BYTE_OPT(var,def)     BYTE      var=def;   {BYTE *Ptr=&var;      scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_BYTE_REF(var)         BYTE  a##var=0,*var=&a##var;              {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_NAME(var)             FName         var;   {FName *Ptr=&var;     scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_NAME_OPT(var,def)     FName     var=def;   {FName *Ptr=&var;     scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_NAME_REF(var)         FName a##var=NAME_None,*var=&a##var;      {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_ACTOR(var)            AActor       *var;   {AActor **Ptr=&var;   scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_ACTOR_OPT(var,def)    AActor   *var=def;   {AActor **Ptr=&var;   scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_ACTOR_REF(var)        AActor *a##var=NULL,**var=&a##var;        {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_VECTOR(var)           FVector       var;   {FVector *Ptr=&var;   scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_VECTOR_OPT(var,def)   FVector   var=def;   {FVector *Ptr=&var;   scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_VECTOR_REF(var)       FVector a##var(0,0,0),*var=&a##var;       {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_ROTATION(var)         FRotation     var;   {FRotation *Ptr=&var; scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_ROTATION_OPT(var,def) FRotation var=def;   {FRotation *Ptr=&var; scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_ROTATION_REF(var)     FRotation a##var(0,0,0),*var=&a##var;     {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_OBJECT(cls,var)       cls          *var;   {cls**Ptr=&var;       scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_OBJECT_OPT(var,def)   UObject*var=def;     {UObject**Ptr=&var;   scriptEval( Stack, Stack.Object, *(BYTE**)&Ptr ); var=*Ptr;}
+#define P_GET_OBJECT_REF(var)       UObject*a##var=NULL,**var=&a##var;        {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
+#define P_GET_STRING(var)           CHAR var##T[MAX_STRING_CONST_SIZE], *var=var##T; {scriptEval( Stack, Stack.Object,*(BYTE**)&var);     }
+#define P_GET_STRING_OPT(var,def)   CHAR var##T[MAX_STRING_CONST_SIZE]=def, *var=var##T; {scriptEval( Stack, Stack.Object,*(BYTE**)&var); }
+#define P_GET_STRING_REF(var)       CHAR a##var[MAX_STRING_CONST_SIZE],*var=a##var; {scriptEval( Stack, Stack.Object, *(BYTE**)&var );          }
 #define P_GET_SKIP_OFFSET(var)      WORD          var;   {debugState(*Stack.Code==EX_Skip); Stack.Code++; var=*(WORD*)Stack.Code; Stack.Code+=2;        }
 #define P_FINISH                                         {debugState(*Stack.Code==EX_EndFunctionParms); Stack.Code++;                                   }
 
@@ -468,6 +531,18 @@ inline FStackNode& FStackNodePtr::operator*() const
 	return Class->StackTree->Element(iNode);
 }
 
+//
+// Evaluate one expression, using the threaded interpreter if the
+// script's code has been pre-decoded.
+//
+inline void scriptEval( FExecStack &Stack, UObject *Context, BYTE *&Result )
+{
+	if( Stack.Script->Threaded )
+		scriptThreadedEval( Stack, Context, Result );
+	else
+		(*GIntrinsics[*Stack.Code++])( Stack, Context, Result );
+}
+
 //
 // FExecStack constructors.
 //
@@ -65,7 +65,9 @@ public:
 	int				AudioTickTime;			// Time consumed by FGlobalAudio::Tick.
 	int				Paused,Pauseable;		// Pausing.
 	int				ScriptExecTime;			// Script execution time.
-	int				Pad[9];					// Space available.
+	int				VfCacheHits;			// Virtual function call site cache hits.
+	int				VfCacheMisses;			// Virtual function call site cache misses.
+	int				Pad[7];					// Space available.
 
 	// Main.
 	void	Init			();
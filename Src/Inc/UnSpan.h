@@ -99,6 +99,7 @@ public:
 	void CopyIndexFrom			(const FSpanBuffer &Source,								  FMemStack *Mem);
 	void MergeFrom				(const FSpanBuffer &Source1, const FSpanBuffer &Source2,  FMemStack *Mem);
 	void MergeWith				(const FSpanBuffer &Other);
+	int  WindowFrom				(const FSpanBuffer &Source, int Y1, int Y2);
 
 	// Grabbing and updating from rasterizations.
 	int  CopyFromRange			(FSpanBuffer &ScreenSpanBuffer,int Y1, int Y2, FMemStack *Mem);
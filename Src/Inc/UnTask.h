@@ -0,0 +1,167 @@
+/*=============================================================================
+	UnTask.h: Task threads for running independent work on all processors.
+
+	Copyright 1997 Epic MegaGames, Inc. This software is a trade secret.
+	Compiled with Visual C++ 4.0. Best viewed with Tabs=4.
+
+	Revision history:
+		* Created for parallel level ticking.
+=============================================================================*/
+
+#ifndef _INC_UNTASK
+#define _INC_UNTASK
+
+/*-----------------------------------------------------------------------------
+	FSpinLock.
+-----------------------------------------------------------------------------*/
+
+//
+// A lock for very short critical sections shared between task threads.
+//
+class UNENGINE_API FSpinLock
+{
+public:
+	// Constructor.
+	FSpinLock()
+	:	Locked( 0 )
+	{}
+
+	// FSpinLock interface.
+	void Lock()
+	{
+		while( appInterlockedExchange( &Locked, 1 ) )
+			GApp->YieldThread();
+	}
+	void Unlock()
+	{
+		appInterlockedExchange( &Locked, 0 );
+	}
+
+private:
+	volatile INT Locked;
+};
+
+/*-----------------------------------------------------------------------------
+	FTaskPool.
+-----------------------------------------------------------------------------*/
+
+// A task function. Performs task number iTask on task thread number iThread.
+typedef void (*TASK_FUNC)( void *Arg, INT iTask, INT iThread );
+
+//
+// A pool of task threads which run batches of independent tasks.
+//
+// Run() splits the tasks into one contiguous range per thread. Each thread
+// takes tasks from the front of its own range, and when that is exhausted
+// it steals tasks from the back of the other threads' ranges. The calling
+// thread participates as thread 0, and Run() returns once every task is done.
+//
+// Each task thread has its own scratch memory stack, which GMem refers to
+// while the thread is running tasks. The extra threads' stacks take their
+// chunks from GChunkPool rather than the cache.
+//
+class UNENGINE_API FTaskPool
+{
+public:
+	// Constants.
+	enum {MAX_TASK_THREADS=32};
+
+	// Variables.
+	INT			NumThreads;			// Number of task threads, including the main thread.
+	INT			Running;			// Nonzero while Run() is in progress.
+	FSpinLock	AllocLock;			// Serializes memory allocation by task threads.
+	FMemStack*	ThreadMem[MAX_TASK_THREADS]; // Scratch memory stack of each task thread.
+
+	// Functions.
+	void Init( INT InNumThreads );
+	void Exit();
+	void Run( TASK_FUNC Func, void *Arg, INT NumTasks );
+
+private:
+	// A range of tasks belonging to one thread: The low word of Range is the next
+	// task to take from the front, the high word is one past the last task.
+	struct FTaskRange
+	{
+		volatile INT	Range;
+		INT				Pad[CACHE_LINE_SIZE/sizeof(INT)-1];
+	} Ranges[MAX_TASK_THREADS];
+
+	// Variables.
+	TASK_FUNC		Func;				// Function of current batch.
+	void*			Arg;				// Argument of current batch.
+	DWORD			hStart;				// Semaphore signalled to start task threads.
+	DWORD			hFinish;			// Semaphore signalled by each finished task thread.
+	DWORD			hThreads[MAX_TASK_THREADS];
+	INT				Quit;				// Set to make task threads exit.
+	volatile INT	Failed;				// Set if a task failed with an error.
+
+	// Functions.
+	static void ThreadMain( void *Arg );
+	INT  TakeTask( INT iThread, INT Steal );
+	void Work( INT iThread );
+};
+
+/*-----------------------------------------------------------------------------
+	Globals.
+-----------------------------------------------------------------------------*/
+
+UNENGINE_API extern FTaskPool GTaskPool;
+
+// Return the index of the calling task thread, 0 for the main thread.
+UNENGINE_API INT appTaskThread();
+
+// Return the scratch memory stack of the calling thread.
+inline FMemStack& appThreadMem()
+{
+	return GTaskPool.Running ? *GTaskPool.ThreadMem[appTaskThread()] : GMainMem;
+}
+
+// The scratch memory stack.
+#define GMem appThreadMem()
+
+/*-----------------------------------------------------------------------------
+	TTaskBuffer.
+-----------------------------------------------------------------------------*/
+
+//
+// A growable array which one task thread at a time appends to, for
+// collecting work to be replayed once a batch of tasks has finished.
+// Not constructed; zero-initialized statics start out empty.
+//
+template<class T> class TTaskBuffer
+{
+public:
+	// Variables.
+	T*	Data;
+	INT	Num;
+	INT	Max;
+
+	// TTaskBuffer interface.
+	T& Add()
+	{
+		if( Num == Max )
+		{
+			GTaskPool.AllocLock.Lock();
+			Max  = Max*2 + 64;
+			Data = (T*)appRealloc( Data, Max*sizeof(T), "TaskBuffer" );
+			GTaskPool.AllocLock.Unlock();
+		}
+		return Data[Num++];
+	}
+	void Empty()
+	{
+		Num = 0;
+	}
+	void Free()
+	{
+		if( Data )
+			appFree( Data );
+		Data = NULL;
+		Num  = Max = 0;
+	}
+};
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
+#endif // _INC_UNTASK
@@ -37,7 +37,8 @@ UNENGINE_API extern class FGlobalDefaults			GDefaults;
 UNENGINE_API extern class FGlobalPlatform*			GApp;
 UNENGINE_API extern class FGlobalTopicTable			GTopics;
 UNENGINE_API extern class FMemCache					GCache;
-UNENGINE_API extern class FMemStack					GMem,GDynMem;
+UNENGINE_API extern class FMemStack					GMainMem,GDynMem;
+UNENGINE_API extern class FMemChunkPool				GChunkPool;
 UNENGINE_API extern class FGlobalGfx				GGfx;
 UNENGINE_API extern class FGlobalMath				GMath;
 UNENGINE_API extern class FGlobalAudio				GAudio;
@@ -61,6 +62,7 @@ UNENGINE_API extern class NManager*					GNetManager;
 #include "UnMath.h"		// Vector math functions.
 #include "UnCache.h"	// In-memory object caching.
 #include "UnMem.h"		// Fast memory pool allocation.
+#include "UnTask.h"		// Task threads.
 #include "UnName.h"	    // Global name system.
 #include "UnStack.h"    // UnrealScript stack definition.
 #include "UnObjBas.h"	// Object base class.
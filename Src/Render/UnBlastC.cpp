@@ -711,6 +711,84 @@ void TexInner32(int SkipIn,FTexLattice *T)
 	}
 }
 TEX_INNER GTexInnerTable[5]={NULL,TexInner8,TexInner16,NULL,TexInner32};
+
+// Fast C texture mapper inner loops:
+// These produce exactly the same pixels as the loops above. The mip, dither
+// and shade table lookups are hoisted out of the loop, and pixels are drawn
+// four at a time between the lighting steps at each aligned group of four
+// pixels, so the inner loop has no per-pixel alignment test.
+#define TEX_INNER_FAST(NAME,PIXEL,PIXELSCALE,SHADE,SHADESCALE) \
+void NAME( int SkipIn, FTexLattice *T ) \
+{ \
+	FMipInfo	*Mip		= &GBlit.Texture->Mips[T->RoutineOfs >> 4]; \
+	FDitherUnit	*Unit		= &Mip->Dither[Mip->MipLevel]; \
+	BYTE		*Texture	= Mip->Data; \
+	BYTE		UBits		= Mip->UBits; \
+	DWORD		VMask		= Mip->VMask << UBits; \
+	SHADE		*Shader		= (SHADE *)((int)TMI_Shader*SHADESCALE); \
+	BYTE		*Dest		= TMI_Dest; \
+	BYTE		*FinalDest	= TMI_FinalDest; \
+	BYTE		*AlignedDest= (BYTE *)((int)TMI_Dest & ~3); \
+	QWORD		Tex			= T->Q; \
+	QWORD		DTex		= T->QX; \
+	QWORD		Offset[4]; \
+	\
+	for( int i=0; i<4; i++ ) \
+		Offset[i] = Unit->Pair[i][TRO_Y&1].Offset; \
+	\
+	if( SkipIn ) Tex += SkipIn * DTex; \
+	Tex  = (Tex  & ~(QWORD)0xffff) + LightValAt(AlignedDest); \
+	DTex = (DTex & ~(QWORD)0xffff) + (WORD)((LightValAt(AlignedDest+4) - (Tex&0xffff))>>2); \
+	if( SkipIn&3 ) Tex += (SkipIn&3) * (WORD)(DTex & 0xffff); \
+	\
+	/* Unaligned pixels up to the first lighting step. */ \
+	if( ((int)Dest & 3) && Dest<FinalDest ) \
+	{ \
+		do TEX_PIXEL_FAST(PIXEL,PIXELSCALE,(int)Dest&3) \
+		while( ((int)Dest & 3) && Dest<FinalDest ); \
+		if( ((int)Dest & 3)==0 ) \
+			TEX_LIGHT_FAST; \
+	} \
+	\
+	/* Groups of four pixels sharing a lighting step. */ \
+	while( Dest+4 <= FinalDest ) \
+	{ \
+		TEX_PIXEL_FAST(PIXEL,PIXELSCALE,0); \
+		TEX_PIXEL_FAST(PIXEL,PIXELSCALE,1); \
+		TEX_PIXEL_FAST(PIXEL,PIXELSCALE,2); \
+		TEX_PIXEL_FAST(PIXEL,PIXELSCALE,3); \
+		TEX_LIGHT_FAST; \
+	} \
+	\
+	/* Remaining pixels, which never reach the next lighting step. */ \
+	while( Dest < FinalDest ) \
+		TEX_PIXEL_FAST(PIXEL,PIXELSCALE,(int)Dest&3); \
+	\
+	STAT(GStat.Extra1 += Dest - TMI_Dest); \
+}
+#define TEX_PIXEL_FAST(PIXEL,PIXELSCALE,i) \
+	{ \
+		QWORD ThisTex = Tex + Offset[i]; \
+		*(PIXEL *)((int)Dest++ * PIXELSCALE) = Shader \
+		[ \
+			(int)(ThisTex&0x3f00)+ \
+			(int)Texture \
+			[ \
+				((ThisTex >> (64-UBits))        ) + \
+				((ThisTex >> (32-UBits)) & VMask) \
+			] \
+		]; \
+		Tex += DTex; \
+	}
+#define TEX_LIGHT_FAST \
+	DTex = (DTex & ~(QWORD)0xffff) + (WORD)((LightValAt(Dest+4) - (Tex&0xffff))>>2)
+TEX_INNER_FAST(TexInnerFast8, BYTE, 1,WORD, 2)
+TEX_INNER_FAST(TexInnerFast16,WORD, 2,WORD, 2)
+TEX_INNER_FAST(TexInnerFast32,DWORD,4,DWORD,4)
+#undef TEX_INNER_FAST
+#undef TEX_PIXEL_FAST
+#undef TEX_LIGHT_FAST
+TEX_INNER GTexInnerFastTable[5]={NULL,TexInnerFast8,TexInnerFast16,NULL,TexInnerFast32};
 #endif
 
 /*-----------------------------------------------------------------------------
@@ -918,6 +996,68 @@ void LightInner_P_Lit()
 		Tex += DTex;
 	}
 }
+
+//
+// Fast version of LightInner_P_Lit, producing exactly the same lighting. The
+// mesh and sinc table are addressed through the pointers LightSetup caches,
+// and the lattice is stepped two lightels at a time.
+//
+void LightInnerFast_P_Lit()
+{
+	// Find a valid rect exactly as LightInner_P_Lit does.
+	FTexLattice *T = TLI_TopLattice;
+	if( !T || !T->RoutineOfs )
+	{
+		FTexLattice **LatticeBase = &TLO_LatticeBase[(TLI_Dest - TLO_BotBase) >> GBlit.InterXBits];
+		T = LatticeBase[-1];
+		if( !T || !T->RoutineOfs )
+		{
+			T = LatticeBase[-MAX_XR];
+			if( !T || !T->RoutineOfs )
+			{
+				T = LatticeBase[-MAX_XR-1];
+				TLI_SkipIn += GBlit.InterX;
+			}
+		}
+		else TLI_SkipIn += GBlit.InterX;
+	}
+	DWORD	*Dest		= TLI_Dest;
+	DWORD	*DestEnd	= TLI_DestEnd;
+	FLOAT	*Mesh		= TLI_MeshFloat;
+	FLOAT	*Sinc		= TLI_Sinc;
+	QWORD	Tex			= T->SubQ;
+	QWORD	DTex		= T->SubQX;
+	BYTE	UBits		= GLightManager->MeshUBits;
+	DWORD	VMask		= ((1 << GLightManager->MeshVBits)-1) << UBits;
+	DWORD	USize		= 1<<UBits;
+	QWORD	Ofs			= (QWORD)1 << (64-UBits);
+
+	if( TLI_SkipIn ) Tex += DTex * TLI_SkipIn;
+
+	#define LIGHT_LIT_FAST(Tex) \
+	{ \
+		DWORD	V		= (Tex >> (32-UBits)) & VMask; \
+		FLOAT	*Addr1	= &Mesh[((Tex     ) >> (64-UBits)) + V]; \
+		FLOAT	*Addr2	= &Mesh[((Tex+Ofs) >> (64-UBits)) + V]; \
+		FLOAT	Alpha	= Sinc[(Tex>>(56-UBits))&0xff]; \
+		FLOAT	A		= Addr1[0]; \
+		FLOAT	C		= Addr1[USize]; \
+		FLOAT	AB		= A+(Addr2[0    ]-A)*Alpha; \
+		FLOAT	CD		= C+(Addr2[USize]-C)*Alpha; \
+		*Dest++ = ((int)(AB + (CD-AB)*Sinc[(Tex>>24)&0xff]) & 0x3ff8); \
+	}
+	QWORD DTex2 = DTex + DTex;
+	while( Dest+2 <= DestEnd )
+	{
+		QWORD Tex1 = Tex + DTex;
+		LIGHT_LIT_FAST(Tex);
+		LIGHT_LIT_FAST(Tex1);
+		Tex += DTex2;
+	}
+	if( Dest < DestEnd )
+		LIGHT_LIT_FAST(Tex);
+	#undef LIGHT_LIT_FAST
+}
 #endif
 
 //
@@ -1037,8 +1177,8 @@ void rendDrawAcross
 #if ASM
 		TLO_LightInnerProc = Sampled ? TLM_8P_Lit : TLM_8P_Unlit;
 #else
-		GLightInnerProc = Sampled ? LightInner_P_Lit : LightInner_P_Unlit;
-		GTexInner = GTexInnerTable[Camera->ColorBytes];
+		GLightInnerProc = !Sampled ? LightInner_P_Unlit : GRender.FastTmap ? LightInnerFast_P_Lit : LightInner_P_Lit;
+		GTexInner = (GRender.FastTmap ? GTexInnerFastTable : GTexInnerTable)[Camera->ColorBytes];
 		void (*TexOuterProc)() = TexOuter;
 #endif
 
@@ -1333,6 +1473,193 @@ void rendDrawAcross
 	unguard;
 }
 
+/*-----------------------------------------------------------------------------
+	Texture loop testing.
+-----------------------------------------------------------------------------*/
+
+#if !ASM
+enum {TEST_X=256}; // Pixels in a test line.
+
+// Random numbers for testing.
+static DWORD TestRand()
+{
+	return (rand() << 16) ^ rand();
+}
+static QWORD TestRand64()
+{
+	return ((QWORD)TestRand() << 32) + TestRand();
+}
+
+// Running checksum of test output.
+static DWORD TestChecksum( DWORD Sum, const BYTE *Data, INT Num )
+{
+	while( Num-- > 0 )
+		Sum = ((Sum << 5) | (Sum >> 27)) ^ *Data++;
+	return Sum;
+}
+
+//
+// Draw random spans of a line with a texture inner loop, and return the
+// checksum of the results. Every call with the same parameters draws the
+// same spans.
+//
+static DWORD TestTexInner( TEX_INNER Inner, INT Runs, INT ColorBytes, INT NumMips, BYTE *Line, DWORD *Light, QWORD &Time )
+{
+	FTexLattice	T;
+	BYTE		*DestBits = (BYTE *)((DWORD)Line / ColorBytes);
+	DWORD		Sum = 0;
+	INT			i;
+
+	srand( ColorBytes );
+	TMI_DiffLight = (DWORD)Light - (DWORD)DestBits;
+	for( INT Run=0; Run<Runs; Run++ )
+	{
+		INT Start		= rand() % (TEST_X/2);
+		INT End			= Start + 1 + rand() % (TEST_X/2);
+		INT SkipIn		= rand() % 16;
+		T.Q				= TestRand64();
+		T.QX			= TestRand64() >> 8;
+		T.RoutineOfs	= (rand() % NumMips) << 4;
+		TRO_Y			= rand();
+		for( i=0; i<TEST_X/4+2; i++ )
+			Light[i] = TestRand() & 0x3ff8;
+		memset( Line, 0, TEST_X*ColorBytes );
+
+		TMI_Dest		= DestBits + Start;
+		TMI_FinalDest	= DestBits + End;
+		QWORD StartTime	= GApp->MicrosecondTime();
+		for( i=0; i<16; i++ )
+			Inner( SkipIn, &T );
+		Time += GApp->MicrosecondTime() - StartTime;
+
+		Sum = TestChecksum( Sum, Line, TEST_X*ColorBytes );
+	}
+	return Sum;
+}
+
+//
+// Light random runs of lightels with a lighting inner loop, and return the
+// checksum of the results.
+//
+static DWORD TestLightInner( void (*Inner)(), INT Runs, DWORD *Lightels, QWORD &Time )
+{
+	FTexLattice	T;
+	DWORD		Sum = 0;
+
+	srand( 0 );
+	for( INT Run=0; Run<Runs; Run++ )
+	{
+		INT Num			= 1 + rand() % 64;
+		INT SkipIn		= rand() % 8;
+		T.SubQ			= TestRand64();
+		T.SubQX			= TestRand64() >> 8;
+		T.RoutineOfs	= 1;
+		memset( Lightels, 0, TEST_X*sizeof(DWORD) );
+
+		QWORD StartTime	= GApp->MicrosecondTime();
+		for( INT i=0; i<16; i++ )
+		{
+			TLI_TopLattice	= &T;
+			TLI_SkipIn		= SkipIn;
+			TLI_Dest		= Lightels;
+			TLI_DestEnd		= Lightels + Num;
+			Inner();
+		}
+		Time += GApp->MicrosecondTime() - StartTime;
+
+		Sum = TestChecksum( Sum, (BYTE *)Lightels, TEST_X*sizeof(DWORD) );
+	}
+	return Sum;
+}
+#endif
+
+//
+// Check that the fast C texture and lighting inner loops draw exactly what
+// the reference C loops do, on random spans of the default texture and a
+// random light mesh, and compare their speed.
+//
+void rendTestTexLoops( INT Runs, FOutputDevice *Out )
+{
+	guard(rendTestTexLoops);
+#if ASM
+	Out->Log( "The C texture loops aren't compiled into this build" );
+#else
+	FMemMark Mark(GMem);
+	UTexture			*SavedTexture	= GBlit.Texture;
+	RAINBOW_PTR			SavedMesh		= GLightManager->Mesh;
+	BYTE				SavedUBits		= GLightManager->MeshUBits;
+	BYTE				SavedVBits		= GLightManager->MeshVBits;
+	DWORD				SavedShader		= TMI_Shader;
+	INT					SavedY			= TRO_Y;
+	INT					i,NumMips;
+
+	// Texture, with dither tables set up as rendDrawAcrossSetup does.
+	UTexture *Texture = GBlit.Texture = GGfx.DefaultTexture;
+	Texture->Lock(LOCK_Read);
+	for( NumMips=0; NumMips<MAX_MIPS && Texture->Mips[NumMips].Offset!=MAXDWORD; NumMips++ )
+		Texture->Mips[NumMips].Dither = &GNoDither256[Texture->UBits].Unit[NumMips];
+
+	// Random shade table, lines and light mesh.
+	srand( 0 );
+	DWORD *Shade	= new(GMem,64*256,16)DWORD;
+	BYTE  *Line		= new(GMem,TEST_X*4,16)BYTE;
+	DWORD *Light	= new(GMem,TEST_X/4+2,16)DWORD;
+	DWORD *Lightels	= new(GMem,TEST_X,16)DWORD;
+	FLOAT *Mesh		= new(GMem,(64+1)*64)FLOAT;
+	for( i=0; i<64*256;    i++ ) Shade[i] = TestRand();
+	for( i=0; i<(64+1)*64; i++ ) Mesh [i] = frand() * 0x3d80;
+
+	// Texture loops at each color depth.
+	for( INT ColorBytes=1; ColorBytes<=4; ColorBytes*=2 )
+	{
+		QWORD RefTime=0, FastTime=0;
+		TMI_Shader    = (DWORD)Shade / (ColorBytes==4 ? 4 : 2);
+		DWORD RefSum  = TestTexInner( GTexInnerTable    [ColorBytes], Runs, ColorBytes, NumMips, Line, Light, RefTime  );
+		DWORD FastSum = TestTexInner( GTexInnerFastTable[ColorBytes], Runs, ColorBytes, NumMips, Line, Light, FastTime );
+		Out->Logf
+		(
+			"TexInner%i: %s (%08X %08X), C=%.2f msec Fast=%.2f msec",
+			ColorBytes*8,
+			RefSum==FastSum ? "Match" : "MISMATCH",
+			RefSum,
+			FastSum,
+			(SQWORD)RefTime /1000.0,
+			(SQWORD)FastTime/1000.0
+		);
+	}
+
+	// Lighting loop.
+	GLightManager->Mesh.PtrFLOAT	= Mesh;
+	GLightManager->MeshUBits		= 6;
+	GLightManager->MeshVBits		= 6;
+	LightSetup();
+	QWORD RefTime=0, FastTime=0;
+	DWORD RefSum  = TestLightInner( LightInner_P_Lit,     Runs, Lightels, RefTime  );
+	DWORD FastSum = TestLightInner( LightInnerFast_P_Lit, Runs, Lightels, FastTime );
+	LightFinish();
+	Out->Logf
+	(
+		"LightInner: %s (%08X %08X), C=%.2f msec Fast=%.2f msec",
+		RefSum==FastSum ? "Match" : "MISMATCH",
+		RefSum,
+		FastSum,
+		(SQWORD)RefTime /1000.0,
+		(SQWORD)FastTime/1000.0
+	);
+
+	// Restore the globals.
+	Texture->Unlock(LOCK_Read);
+	GBlit.Texture				= SavedTexture;
+	GLightManager->Mesh			= SavedMesh;
+	GLightManager->MeshUBits	= SavedUBits;
+	GLightManager->MeshVBits	= SavedVBits;
+	TMI_Shader					= SavedShader;
+	TRO_Y						= SavedY;
+	Mark.Pop();
+#endif
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
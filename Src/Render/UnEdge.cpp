@@ -149,7 +149,7 @@ public:
 
 	// Subsystem objects.
 	static FGlobalPlatform*	GApp;		// Global platform code.
-	static FMemStack*		GMem;		// One memory pool.
+	static FMemStack*		Mem;		// One memory pool.
 	static FMemStack*		GDynMem;	// Another memory pool.
 
 	// Member variables.
@@ -172,7 +172,7 @@ public:
 	);
 
 	// FRendererBase interface.
-	void Init(FGlobalPlatform *GApp,FMemStack *GMem,FMemStack *GDynMem);
+	void Init(FGlobalPlatform *GApp,FMemStack *Mem,FMemStack *GDynMem);
 	void Exit();
 	FBspDrawList *OccludeBsp(UCamera *Camera,FSpanBuffer *Backdrop);
 
@@ -188,7 +188,7 @@ public:
 
 // FGlobalOccluder statics.
 FGlobalPlatform*				FGlobalOccluder::GApp = NULL;
-FMemStack*						FGlobalOccluder::GMem;
+FMemStack*						FGlobalOccluder::Mem;
 FMemStack*						FGlobalOccluder::GDynMem;
 INT								FGlobalOccluder::Y;
 INT								FGlobalOccluder::EndY;
@@ -297,7 +297,7 @@ inline FGlobalOccluder::FEdgeSurf* FGlobalOccluder::FEdgeSurfCache::Get(const IN
 		{
 			// Cache entry doesn't exist, so create it.
 			*LastSurf++		= CachedResult;
-			*CachedResult	= new(*GMem)FEdgeSurf;
+			*CachedResult	= new(*Mem)FEdgeSurf;
 			(*CachedResult)->Setup(iSurf);
 		}
 		if( !(*CachedResult)->Reject )
@@ -552,7 +552,7 @@ void FGlobalOccluder::AddEdges
 			if( (EndY > StartY) && (StartY < Camera->Y) )
 			{
 				// Allocate a new edge link.
-				NewEdge				= new(*GMem)FEdgeLink;
+				NewEdge				= new(*Mem)FEdgeLink;
 
 				// Add this edge link to the line-start table.
 				AddEdgeToLine(NewEdge,StartY,EndY);
@@ -858,7 +858,7 @@ FBspDrawList *FGlobalOccluder::OccludeBsp
 			{
 				// Rasterize this.
 				FRasterSetup WorkingRaster;
-				WorkingRaster.Setup(Camera,Pts,NumPts,GMem);
+				WorkingRaster.Setup(Camera,Pts,NumPts,Mem);
 				WorkingRaster.Generate(GRaster.Raster);
 
 				// Allocate a span.
@@ -916,7 +916,7 @@ void FGlobalOccluder::Init
 
 	// Set subsystem objects.
 	GApp		= ThisApp;
-	GMem		= ThisMem;
+	Mem			= ThisMem;
 	GDynMem		= ThisDynMem;
 
 	// Success.
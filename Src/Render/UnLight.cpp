@@ -211,6 +211,16 @@ public:
 		void inline ComputeFromActor	(UCamera *Camera);
 	};
 
+	// Whether a steady light with this effect always lights a surface the same way,
+	// so it can be baked into the surface's cached static light map.
+	static int IsTimeInvariant( const FLocalEffectEntry &Effect )
+	{
+		return
+		(	Effect.MergeFxFunc==merge_None
+		&&	!Effect.IsSpatialDynamic
+		&&	!Effect.LatticeFxFunc );
+	}
+
 	// Global light effects.
 	static void global_None				( FLightInfo &Light, AActor *Actor );
 	static void global_Steady			( FLightInfo &Light, AActor *Actor );
@@ -1734,7 +1744,7 @@ void FLightManager::FLightInfo::SetActor( AActor *InActor )
 		Opt = ALO_BackdropLight;
 	else if( Actor->bDynamicLight || !Actor->bStatic)
 		Opt = ALO_MovingLight;
-	else if( Actor->LightType==LT_Steady && Actor->LightEffect==LE_None )
+	else if( Actor->LightType==LT_Steady && IsTimeInvariant(Effects[(Actor->LightEffect<LE_MAX) ? Actor->LightEffect : 0]) )
 		Opt = ALO_StaticLight;
 	else
 		Opt = ALO_DynamicLight;
@@ -2150,19 +2160,28 @@ void FLightManager::SetupForSurf
 				if( !Stream.PtrVOID )
 					Stream = GCache.Create( CacheID, TopItemToUnlock[-1],MeshTileSpace * sizeof(FLOAT) );
  				StaticLightingMapGen( Camera->Caps, Stream );
+				STAT(GStat.StaticMapsGen++);
 			}
 		}
 
-		// Merge in the dynamic lights.
+		// Merge the dynamic lights into the static map as per-frame deltas.
 		BYTE *ShadowLoc = ShadowBase;
 		for( FLightInfo* Info=FirstLight; Info<LastLight; Info++ )
 		{
 			if( Info->Opt==ALO_DynamicLight || Info->Opt==ALO_MovingLight )
 			{	
+				// Skip lights which are dark this frame, such as flickering or blinking
+				// ones in their off phase, unless their cached maps must be rebuilt.
+				Info->ComputeFromActor( Camera );
+				if( Info->Brightness<=0.0 && !Info->Actor->bLightChanged )
+				{
+					ShadowLoc += MeshByteSpace;
+					continue;
+				}
+
 				// Set up:
 				BYTE *ShadowMap;
 				FMemMark Mark( GMem );
-				Info->ComputeFromActor( Camera );
 				if( Info->Opt==ALO_MovingLight )
 				{
 					// Build a temporary shadow map and fill it with 1.0.
@@ -2212,6 +2231,7 @@ void FLightManager::SetupForSurf
 				Info->Effect.MergeFxFunc( Camera->Caps, Key, *Info, Stream, Mesh );
 				Stream = Mesh;
 				Mark.Pop();
+				STAT(GStat.LightDeltas++);
 			}
 			ShadowLoc += MeshByteSpace;
 		}
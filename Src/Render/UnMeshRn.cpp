@@ -259,8 +259,8 @@ struct FMeshTriSort
 	FTransTexture*	FirstPoint;	// First point of clipped triangle point list.
 	INT 			Index;		// Index of triangle in triangle table.
 	INT				Key;		// Sort key.
-	friend inline INT Compare( const FMeshTriSort &A, const FMeshTriSort &B )
-		{ return B.Key - A.Key; }
+	friend inline DWORD RadixKey( const FMeshTriSort &A )
+		{ return ~RadixSigned(A.Key); }
 };
 
 //
@@ -281,7 +281,7 @@ void FRender::DrawMesh
 	FTransform		*V1,*V2,*V3;
 	FMeshTriSort 	*TriTop;
 	WORD			Color;
-	INT 			i,j,k;
+	INT 			i,j;
 
 	// Lock the mesh map.
 	Mesh->Lock( LOCK_Read );
@@ -387,23 +387,19 @@ void FRender::DrawMesh
 		// Render triangles.
 		if( VisibleTriangles>0 )
 		{
-			QSort( TriPool, VisibleTriangles );
+			// Sort in decreasing order of key.
+			FMeshTriSort *TriTemp = new(GMem,VisibleTriangles)FMeshTriSort;
+			RadixSort( TriPool, TriTemp, VisibleTriangles );
 
 			// Build list of all incident lights on the creature.
 			// Considers only the entire creature and does not
 			// differentiate between individual creature polys.
 			GLightManager->SetupForActor( Camera, Sprite->Actor );
 
-			// Compute all triangle normals.
-			FVector *TriNormals = new(GMem,Mesh->Tris->Num)FVector;
-			for( int i=0; i<Mesh->Tris->Num; i++ )
-			{
-				FMeshTri &Tri  = Mesh->Tris(i);
-				FVector Side1  = Samples[Tri.iVertex[1]] - Samples[Tri.iVertex[0]];
-				FVector Side2  = Samples[Tri.iVertex[2]] - Samples[Tri.iVertex[0]];
-				TriNormals[i]  = (Side2 ^ Side1);
-				TriNormals[i] *= DivSqrtApprox(TriNormals[i].SizeSquared());
-			}
+			// Get all vertex normals, from the mesh's normal cache if possible.
+			FVector *VertNormals = new(GMem,Mesh->FrameVerts)FVector;
+			if( !Mesh->GetFrameNormals( VertNormals, Camera, Sprite->Actor ) )
+				Mesh->ComputeNormals( VertNormals, Samples );
 
 			// Perform all vertex lighting.
 			for( i=0; i<VisibleTriangles; i++ )
@@ -415,12 +411,8 @@ void FRender::DrawMesh
 					FTransSample &Vert = Samples[iVert];
 					if( Vert.Color.R == -1 )
 					{
-						// Compute vertex normal.
-						Vert.Norm = FVector(0,0,0);
-						FMeshVertConnect &Connect = Mesh->Connects(iVert);
-						for( k=0; k<Connect.NumVertTriangles; k++ )
-							Vert.Norm += TriNormals[Mesh->VertLinks(Connect.TriangleListOffset + k)];
-						Vert.Norm *= DivSqrtApprox(Vert.Norm.SizeSquared());
+						// Get vertex normal.
+						Vert.Norm = VertNormals[iVert];
 
 						// Fatten it if desired.
 						if( Fatten )
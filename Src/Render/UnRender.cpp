@@ -96,6 +96,8 @@ void FRender::Init()
 	VectorCache		= appMallocArray(MAX_VECTORS,FStampedVector,	"VectorCache");
 
 	memset( LatticePtr, 0, sizeof(LatticePtr) );
+	OccStamps		= NULL;
+	MaxOccStamps	= 0;
 
 	InitDither();
 	GCache.Flush();
@@ -118,6 +120,9 @@ void FRender::Init()
 	Extra3			= 0;
 	Extra4			= 0;
 	AllStats		= 0;
+	Coherent		= 1;
+	Banded			= 1;
+	FastTmap		= 1;
 	Curvy           = 1;
 	MipMultiplier	= 1.0;
 
@@ -165,7 +170,7 @@ void FRender::Init()
 
 	// Allocate memory stacks.
 	PointMem.Init ( GCache, 16384, 65536 );
-	VectorMem.Init( GCache, 2048,  8192  );
+	VectorMem.Init( GCache, 2048,  8192, "Vector" );
 
 	debug(LOG_Init,"Rendering initialized");
 	unguard;
@@ -182,6 +187,10 @@ void FRender::Exit()
 
 	appFree(PointCache);
 	appFree(VectorCache);
+	if( OccStamps )
+		appFree(OccStamps);
+	OccStamps		= NULL;
+	MaxOccStamps	= 0;
 
 	debug( LOG_Exit, "Rendering closed" );
 
@@ -250,15 +259,22 @@ void FRender::DrawStats( UCamera *Camera )
 			GApp->CpuToMilliseconds(GServer.AudioTickTime));
 		ShowStat	(Camera,&StatYL,TempStr);
 
+		sprintf(TempStr,"  SCRP VfHits=%05i VfMisses=%05i",
+			GServer.VfCacheHits,
+			GServer.VfCacheMisses);
+		ShowStat(Camera,&StatYL,TempStr);
+
 		sprintf		(TempStr,"  CACH ");
 		GCache.Status(TempStr+strlen(TempStr));
 		ShowStat	(Camera,&StatYL,TempStr);
 
-		sprintf(TempStr,"  LITE PTS=%05i MESHES=%04i LITAGE=%04i LITMEM=%04iK",
+		sprintf(TempStr,"  LITE PTS=%05i MESHES=%04i LITAGE=%04i LITMEM=%04iK STATIC=%03i DELTAS=%03i",
 			GStat.MeshPtsGen,
 			GStat.MeshesGen,
 			GStat.Lightage,
-			GStat.LightMem>>10);
+			GStat.LightMem>>10,
+			GStat.StaticMapsGen,
+			GStat.LightDeltas);
 		ShowStat(Camera,&StatYL,TempStr);
 
 		sprintf(TempStr,"  TEX  UNQTEX=%i TEXMEM=%iK, MODS=%i",
@@ -287,8 +303,15 @@ void FRender::DrawStats( UCamera *Camera )
 			GStat.BoxSpanOccluded);
 		ShowStat(Camera,&StatYL,TempStr);
 
+		sprintf(TempStr,"  COHR Visit=%05i Skip=%04i Check=%04i Reject=%04i",
+			GStat.OccNodesVisited,
+			GStat.OccSubtreesSkipped,
+			GStat.OccSubtreesChecked,
+			GStat.OccSubtreesRejected);
+		ShowStat(Camera,&StatYL,TempStr);
+
 		sprintf(TempStr,"  MEM  GMem=%iK GDynMem=%iK",
-			GStat.GMem>>10,
+			GStat.GMainMem>>10,
 			GStat.GDynMem>>10);
 		ShowStat(Camera,&StatYL,TempStr);
 
@@ -432,6 +455,100 @@ void FRender::PostRender( UCamera *Camera )
 	GApp->EnableFastMath(0);
 }
 
+/*-----------------------------------------------------------------------------
+	Sort benchmark.
+-----------------------------------------------------------------------------*/
+
+//
+// An item sorted by the sort benchmark, with a key already ordered as an
+// unsigned integer.
+//
+struct FSortBenchItem
+{
+	DWORD	Key;
+	INT		Index;
+	friend inline INT Compare( const FSortBenchItem &A, const FSortBenchItem &B )
+		{ return (A.Key>B.Key) - (A.Key<B.Key); }
+	friend inline DWORD RadixKey( const FSortBenchItem &A )
+		{ return A.Key; }
+};
+
+//
+// Time QSort and RadixSort on keys distributed like the renderer's: mesh
+// triangle depths and textures, Bsp surface keys and sprite depths.
+// Num overrides the usual number of items of each if nonzero.
+//
+static void SortBench( INT Num, INT Runs, FOutputDevice *Out )
+{
+	guard(SortBench);
+	enum {SORT_MeshDepth, SORT_MeshTexture, SORT_BspSurfs, SORT_Sprites, SORT_MAX};
+	static const char *Names[SORT_MAX] = {"Mesh depth","Mesh texture","Bsp surfaces","Sprite depth"};
+	static const INT   Nums [SORT_MAX] = {600, 600, 800, 64};
+
+	for( INT iDist=0; iDist<SORT_MAX; iDist++ )
+	{
+		// Make the keys.
+		INT N = Num ? Num : Nums[iDist];
+		FMemMark Mark(GMem);
+		FSortBenchItem *Source = new(GMem,N)FSortBenchItem;
+		FSortBenchItem *Items  = new(GMem,N)FSortBenchItem;
+		FSortBenchItem *Temp   = new(GMem,N)FSortBenchItem;
+		srand( 0x5678 );
+		for( INT i=0; i<N; i++ )
+		{
+			switch( iDist )
+			{
+				case SORT_MeshDepth:
+					// Sum of three vertex depths of a creature 400 to 600 units away.
+					Source[i].Key = RadixSigned( ftoi(1024.0 * (1500.0 + 3.0*64.0*(frand()-0.5))) );
+					break;
+				case SORT_MeshTexture:
+					// A few skins sharing one palette.
+					Source[i].Key = RadixSigned( (1200 << 16) + 3000 + (rand() & 3) );
+					break;
+				case SORT_BspSurfs:
+					// Software key of zone, palette and texture, as OccludeBsp makes them.
+					Source[i].Key = RadixSigned( ((rand() % 8) << (32-6)) + ((1200 + rand()%4) << 12) + 2000 + rand()%60 );
+					break;
+				case SORT_Sprites:
+					// Sprite depths.
+					Source[i].Key = RadixFloat( 64.0 + 4096.0*frand() );
+					break;
+			}
+			Source[i].Index = i;
+		}
+
+		// Time both sorts.
+		DOUBLE Msec[2];
+		INT    Sorted = 1;
+		for( INT iSort=0; iSort<2; iSort++ )
+		{
+			QWORD StartTime = GApp->MicrosecondTime();
+			for( INT Run=0; Run<Runs; Run++ )
+			{
+				memcpy( Items, Source, N*sizeof(FSortBenchItem) );
+				if( iSort==0 ) QSort( Items, N );
+				else           RadixSort( Items, Temp, N );
+			}
+			Msec[iSort] = (SQWORD)(GApp->MicrosecondTime() - StartTime) / 1000.0;
+			for( i=1; i<N; i++ )
+				if( Items[i-1].Key>Items[i].Key || (iSort==1 && Items[i-1].Key==Items[i].Key && Items[i-1].Index>Items[i].Index) )
+					Sorted = 0;
+		}
+		Out->Logf
+		(
+			"%-12s %5i items: QSort=%.4f RadixSort=%.4f msec%s",
+			Names[iDist],
+			N,
+			Msec[0] / Runs,
+			Msec[1] / Runs,
+			Sorted ? "" : " (MISSORTED)"
+		);
+		Mark.Pop();
+	}
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	FRender command line.
 -----------------------------------------------------------------------------*/
@@ -492,6 +609,9 @@ int FRender::Exec(const char *Cmd,FOutputDevice *Out)
 		else if (GetCMD(&Str,"LEAK"))		LeakCheck		^= 1;
 		else if (GetCMD(&Str,"BILINEAR"))	DoDither		^= 1;
 		else if (GetCMD(&Str,"CURVY"))	    Curvy   		^= 1;
+		else if (GetCMD(&Str,"COHERENT"))	Coherent		^= 1;
+		else if (GetCMD(&Str,"BANDED"))		Banded			^= 1;
+		else if (GetCMD(&Str,"FASTTMAP"))	FastTmap		^= 1;
 		else if (GetCMD(&Str,"CUTS"))		ShowChunks		^= 1;
 		else if (GetCMD(&Str,"LATTICE"))	ShowLattice		^= 1;
 		else if (GetCMD(&Str,"EXTRA1"))		Extra1			^= 1;
@@ -509,6 +629,29 @@ int FRender::Exec(const char *Cmd,FOutputDevice *Out)
 		Out->Log("Rendering option recognized");
 		return 1;
 	}
+	else if( GetCMD(&Str,"SORT") )
+	{
+		if( GetCMD(&Str,"BENCH") )
+		{
+			// Compare QSort and RadixSort on the renderer's sort keys.
+			INT Num=0;     GetINT(Str,"NUM=",&Num);
+			INT Runs=1000; GetINT(Str,"RUNS=",&Runs);
+			SortBench( Max(Num,0), Max(Runs,1), Out );
+			return 1;
+		}
+		else return 0;
+	}
+	else if( GetCMD(&Str,"TMAP") )
+	{
+		if( GetCMD(&Str,"TEST") )
+		{
+			// Check the fast C texture loops against the reference ones.
+			INT Runs=1000; GetINT(Str,"RUNS=",&Runs);
+			rendTestTexLoops( Max(Runs,1), Out );
+			return 1;
+		}
+		else return 0;
+	}
 	else return 0; // Not executed
 	unguard;
 }
@@ -971,6 +1114,7 @@ public:
 	int			FarOutside;
 	int			Outside;
 	int			DrewStuff;
+	int			Culled;
 	ENodePass	Pass;
 	FNodeStack	*Prev;
 };
@@ -994,8 +1138,17 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 	static QWORD				ActiveZoneMask;
 	static INDEX          		iNode,iOriginalNode,iThingZone;
 	static BYTE					iViewZone,iZone,iOppositeZone,ViewZoneMask;
-	static int           		Visible,Merging,Mergeable,Outside,Pass,DrewStuff,NumPts;
+	static int           		Visible,Merging,Mergeable,Outside,Pass,DrewStuff,Culled,NumPts;
 	static int					CoplanarPass;
+	static int					Coherence;
+
+	// The view occlusion was last computed for, for frame coherence.
+	static UCamera				*LastCamera=NULL;
+	static UModel				*LastModel=NULL;
+	static FCoords				LastCoords;
+	static INT					LastNumNodes=0,LastX=0,LastY=0;
+	static BYTE					LastViewZone=0;
+	static DWORD				OccFrame=0;
 
 	guard(FRender::OccludeBsp);
 
@@ -1016,6 +1169,41 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 	iViewZone			= Model->PointZone(Origin);
 	ViewZoneMask		= iViewZone ? ~0 : 0;
 
+	// Subtrees which were entirely occluded by the span buffers on the previous frame
+	// are only trusted to still be occluded if that frame was drawn by the same camera
+	// from nearly the same view. Otherwise, and for a staggered quarter of them every
+	// frame, their bounding boxes are checked before being skipped. Subtrees which drew
+	// nothing because they were outside the view, behind the camera, backfaced or in an
+	// inactive zone aren't trusted, since a small change in view can reveal them.
+	Coherence =
+	(	Coherent
+	&&	!GEditor
+	&&	Camera				== LastCamera
+	&&	Model				== LastModel
+	&&	Model->Nodes->Num	== LastNumNodes
+	&&	iViewZone			== LastViewZone
+	&&	Camera->X			== LastX
+	&&	Camera->Y			== LastY
+	&&	(Origin - LastCoords.Origin).SizeSquared() < 16.0*16.0
+	&&	(Camera->Coords.XAxis | LastCoords.XAxis) > 0.999
+	&&	(Camera->Coords.ZAxis | LastCoords.ZAxis) > 0.999 );
+	LastCamera			= Camera;
+	LastModel			= Model;
+	LastCoords			= Camera->Coords;
+	LastNumNodes		= Model->Nodes->Num;
+	LastViewZone		= iViewZone;
+	LastX				= Camera->X;
+	LastY				= Camera->Y;
+	OccFrame++;
+
+	// Stamp each subtree found occluded by the span buffers with the frame.
+	if( MaxOccStamps < Model->Nodes->Num )
+	{
+		OccStamps = (DWORD*)appRealloc( OccStamps, Model->Nodes->Num * sizeof(DWORD), "OccStamps" );
+		memset( OccStamps + MaxOccStamps, 0, (Model->Nodes->Num - MaxOccStamps) * sizeof(DWORD) );
+		MaxOccStamps = Model->Nodes->Num;
+	}
+
 	// Init first four units of the rasterization side setup cache so that they
 	// represent the setups for the four view frustrum clipping planes.
 	for( int i=0; i<4; i++ )
@@ -1039,6 +1227,7 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 	iNode				= 0;
 	Outside				= Model->RootOutside;
 	DrewStuff			= 0;
+	Culled				= 0;
 	Pass				= PASS_Front;
 
 	for( ;; )
@@ -1053,38 +1242,63 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 			{
 				// Use pure zone rejection.
 				STAT(GStat.MaskRejectZones++);
+				Culled = 1;
 				goto PopStack;
 			}
 
-#if 0 /* Just slows it down! */
-			// Bound rejection.
-			if( (Node->NodeFlags & (NF_AllOccluded|NF_Bounded))==(NF_AllOccluded|NF_Bounded) )
+			STAT(GStat.OccNodesVisited++);
+
+			// Occluded subtree rejection. Subtrees holding dynamics are always traversed,
+			// since actors may be visible in empty space where the subtree drew nothing.
+			if
+			(	Coherent
+			&&	(Node->NodeFlags & NF_AllOccluded)
+			&&	Node->iRenderBound!=INDEX_NONE
+			&&	!Node->iDynamic[0] )
 			{
-				// Use bounding box rejection if occluded on the previous frame.
+				if( Coherence && ((iNode + OccFrame) & 3) && OccStamps[iNode]==OccFrame-1 )
+				{
+					// Trust last frame's result.
+					STAT(GStat.OccSubtreesSkipped++);
+					OccStamps[iNode] = OccFrame;
+					goto PopStack;
+				}
+
+				// Check the subtree's bounding box against the view, then the span buffers.
+				STAT(GStat.OccSubtreesChecked++);
 				FScreenBounds Results;
-				if( !BoundVisible(Camera,&Model->Bounds(Node->iRenderBound),iViewZone?NULL:&ZoneSpanBuffer[0],&Results,NULL) )
+				if( !BoundVisible(Camera,&Model->Bounds(Node->iRenderBound),NULL,&Results) )
 				{
+					STAT(GStat.OccSubtreesRejected++);
+					Culled = 1;
 					goto PopStack;
 				}
-				if( Results.Valid && iViewZone )
+				if( Results.Valid )
 				{
-					QWORD		ZoneMask	= 1;
-					FSpanBuffer *ZoneSpan	= &ZoneSpanBuffer[0];
-
-					for( int iZone=0; iZone<64; iZone++)
+					if( iViewZone )
 					{
-						if( ZoneSpan->ValidLines && (Node->ZoneMask & ZoneMask) && ZoneSpan->BoundIsVisible(Results) )
-							goto Visible;
+						QWORD		ZoneMask	= 1;
+						FSpanBuffer *ZoneSpan	= &ZoneSpanBuffer[0];
 
-						ZoneMask += ZoneMask;
-						ZoneSpan++;
+						for( int iZone=0; iZone<64; iZone++)
+						{
+							if( ZoneSpan->ValidLines && (Node->ZoneMask & ZoneMask) && ZoneSpan->BoundIsVisible(Results) )
+								goto Visible;
+
+							ZoneMask += ZoneMask;
+							ZoneSpan++;
+						}
 					}
+					else if( ZoneSpanBuffer[0].BoundIsVisible(Results) )
+						goto Visible;
+
 					STAT( GStat.BoxSpanOccluded++; );
+					STAT(GStat.OccSubtreesRejected++);
+					OccStamps[iNode] = OccFrame;
 					goto PopStack;
-					Visible:;
 				}
+				Visible:;
 			}
-#endif
 			if( Node->iDynamic[0] )
 				dynamicsFilter( Camera, iNode, 1, Outside );
 
@@ -1096,6 +1310,7 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 				Stack->iNode		= iNode;
 				Stack->Outside		= Outside;
 				Stack->DrewStuff	= 0;
+				Stack->Culled		= 0;
 				Stack->Pass  		= PASS_Plane;
 				
 				FNodeStack *Prev	= Stack;
@@ -1118,6 +1333,7 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 			if( iViewZone && !(Node->ZoneMask & ActiveZoneMask) )
 			{
 				STAT(GStat.MaskRejectZones++);
+				Culled = 1;
 				goto PopStack;
 			}
 
@@ -1137,7 +1353,10 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 			&&	(Sign * (Node->Plane | Camera->ViewSides[1]) > 0.0)
 			&&	(Sign * (Node->Plane | Camera->ViewSides[2]) > 0.0)
 			&&	(Sign * (Node->Plane | Camera->ViewSides[3]) > 0.0) )
+			{
+				Culled = 1;
 				goto PrePopStack;
+			}
 
 			// Make two passes through this list of coplanars.  Draw regular (solid) polys on
 			// first pass, semisolids and nonsolids on second pass.
@@ -1161,18 +1380,27 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 					// Get this zone's span buffer.
 					SpanBuffer = &ZoneSpanBuffer[iZone];
 					if( SpanBuffer->ValidLines <= 0 )
+					{
+						Culled = 1;
 						goto NextCoplanar;
+					}
 
 					// Skip if backfaced.
 					if( !IsFront && Dot<-1.0 && !(PolyFlags & (PF_TwoSided|PF_Portal)) )
+					{
+						Culled = 1;
 						goto NextCoplanar;
+					}
 
 					STAT(GStat.NodesDone++);
 
 					// Clip it.
 					NumPts = ClipBspSurf( Model, Camera, iNode, Pts );
 					if( !NumPts )
+					{
+						Culled = 1;
 						goto NextCoplanar;
+					}
 
 					// Box reject this poly if it was entirely occluded last frame.
 					if( Node->NodeFlags & NF_PolyOccluded )
@@ -1366,11 +1594,13 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 				Stack->Outside		= Outside;
 				Stack->Pass			= PASS_Back;
 				Stack->DrewStuff    = DrewStuff;
+				Stack->Culled		= Culled;
 
 				iNode				= Stack->iFarNode;
 				Outside				= Stack->FarOutside;
 				Pass				= PASS_Front;
 				DrewStuff			= 0;
+				Culled				= 0;
 
 				FNodeStack *Prev	= Stack;
 				Stack				= new(GMem)FNodeStack;
@@ -1386,6 +1616,8 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 		PrePopStack:
 		if( !DrewStuff )	Nodes(iNode).NodeFlags |=  NF_AllOccluded;
 		else				Nodes(iNode).NodeFlags &= ~NF_AllOccluded;
+		if( !DrewStuff && !Culled )
+			OccStamps[iNode] = OccFrame;
 
 		// Return from recursion, noting that the node we're returning to is guaranteed visible if the
 		// child we're processing now is visible.
@@ -1398,6 +1630,7 @@ FBspDrawList *FRender::OccludeBsp( UCamera *Camera, FSpanBuffer *Backdrop )
 		Outside		= Stack->Outside;
 		Pass		= Stack->Pass;
 		DrewStuff  |= Stack->DrewStuff;
+		Culled     |= Stack->Culled;
 	}
 
 	DoneRendering:
@@ -1750,7 +1983,11 @@ void inline RectLoop( FTexLattice **LatticeBase,int Start, int End )
 -----------------------------------------------------------------------------*/
 
 //
-// Draw a software-textured Bsp surface.
+// Draw a software-textured Bsp surface. Only one surface can be drawn at a
+// time: The lattice setup, GBlit, the TMI_/TMO_/TRO_/TLO_ mapper state, the
+// GLight rows and the current light block are all global, rendDrawAcross
+// steps the shared lattice in place, and the assembly mapper patches its own
+// code for each surface.
 //
 void DrawSoftwareTexturedBspSurf
 (
@@ -2086,11 +2323,34 @@ void FRender::DrawLatticeGrid( UCamera *Camera,FSpanBuffer *LatticeSpan )
 }
 
 //
-// Draw a flatshaded poly.
+// Return the screen pixel value of a palette color, for flatshading.
 //
-void FRender::DrawFlatPoly( UCamera *Camera,FSpanBuffer *SpanBuffer, BYTE Color )
+static DWORD FlatPixel( UCamera *Camera, BYTE Color )
 {
-	guard(FRender::DrawFlatPoly);
+	guard(FlatPixel);
+
+	DWORD Pixel = Color;
+	if( Camera->ColorBytes!=1 )
+	{
+		GGfx.DefaultPalette->Lock(LOCK_Read);
+		if		(Camera->ColorBytes!=2)			Pixel = GGfx.DefaultPalette(Color).TrueColor();
+		else if	(Camera->Caps & CC_RGB565)		Pixel = GGfx.DefaultPalette(Color).HiColor565();
+		else									Pixel = GGfx.DefaultPalette(Color).HiColor555();
+		GGfx.DefaultPalette->Unlock(LOCK_Read);
+	}
+	return Pixel;
+
+	unguard;
+}
+
+//
+// Fill a span buffer's spans with a pixel value from FlatPixel. Touches nothing
+// but the screen lines the span buffer covers, so task threads can fill separate
+// bands of the screen at once.
+//
+static void DrawFlatSpans( UCamera *Camera, FSpanBuffer *SpanBuffer, DWORD Pixel )
+{
+	guard(DrawFlatSpans);
 
 	FSpan			*Span,**Index;
 	int				m,n;
@@ -2101,64 +2361,53 @@ void FRender::DrawFlatPoly( UCamera *Camera,FSpanBuffer *SpanBuffer, BYTE Color
 	if( Camera->ColorBytes==1 )
 	{
 		BYTE *Line = &Camera->Screen [SpanBuffer->StartY * Camera->Stride];
-		while (m-- > 0)
-			{
-			Span = *Index++;
-			while (Span)
-				{
-				memset(&Line[Span->Start],Color,Span->End - Span->Start);
-				Span   = Span->Next;
-				};
+		while( m-- > 0 )
+		{
+			for( Span = *Index++; Span; Span = Span->Next )
+				memset( &Line[Span->Start], Pixel, Span->End - Span->Start );
 			Line += Camera->Stride;
-			};
 		}
-	else if (Camera->ColorBytes==2)
+	}
+	else if( Camera->ColorBytes==2 )
+	{
+		WORD *Screen,*Line = &((WORD *)Camera->Screen)[SpanBuffer->StartY * Camera->Stride];
+		while( m-- > 0 )
 		{
-		WORD *Screen,*Line,HiColor;
-		//
-		GGfx.DefaultPalette->Lock(LOCK_Read);
-		if (Camera->Caps & CC_RGB565)	HiColor = GGfx.DefaultPalette(Color).HiColor565();
-		else							HiColor = GGfx.DefaultPalette(Color).HiColor555();
-		GGfx.DefaultPalette->Unlock(LOCK_Read);
-		//
-		Line = &((WORD *)Camera->Screen)[SpanBuffer->StartY * Camera->Stride];
-		while (m-- > 0)
+			for( Span = *Index++; Span; Span = Span->Next )
 			{
-			Span = *Index++;
-			while (Span)
-				{
 				Screen = &Line[Span->Start];
 				n      = Span->End - Span->Start;
-				while (n-- > 0) *Screen++ = HiColor;
-				Span = Span->Next;
-				};
+				while( n-- > 0 ) *Screen++ = (WORD)Pixel;
+			}
 			Line += Camera->Stride;
-			};
 		}
+	}
 	else
+	{
+		DWORD *Screen,*Line = &((DWORD *)Camera->Screen)[SpanBuffer->StartY * Camera->Stride];
+		while( m-- > 0 )
 		{
-		GGfx.DefaultPalette->Lock(LOCK_Read);
-		DWORD TrueColor = GGfx.DefaultPalette(Color).TrueColor();
-		GGfx.DefaultPalette->Unlock(LOCK_Read);
-		//
-		DWORD *Screen,*Line;
-		//
-		Line = &((DWORD *)Camera->Screen)[SpanBuffer->StartY * Camera->Stride];
-		while (m-- > 0)
+			for( Span = *Index++; Span; Span = Span->Next )
 			{
-			Span = *Index++;
-			while (Span)
-				{
 				Screen = &Line[Span->Start];
 				n      = Span->End - Span->Start;
-				while (n-- > 0) *Screen++ = TrueColor;
-				Span = Span->Next;
-				};
+				while( n-- > 0 ) *Screen++ = Pixel;
+			}
 			Line += Camera->Stride;
-			};
-		};
+		}
+	}
 	unguard;
-	};
+}
+
+//
+// Draw a flatshaded poly.
+//
+void FRender::DrawFlatPoly( UCamera *Camera,FSpanBuffer *SpanBuffer, BYTE Color )
+{
+	guard(FRender::DrawFlatPoly);
+	DrawFlatSpans( Camera, SpanBuffer, FlatPixel( Camera, Color ) );
+	unguard;
+}
 
 //
 // Draw a highlighted overlay polygon.
@@ -2359,6 +2608,52 @@ void FRender::CleanupLattice( FSpanBuffer &LatticeSpan )
 	General Bsp surface rendering.
 -----------------------------------------------------------------------------*/
 
+//
+// Return whether a Bsp surface is drawn as a highlight in the flatshaded
+// rendering modes, as portals are in the zone view.
+//
+static INT FlatSurfHighlight( UCamera *Camera, FBspDrawList *Draw )
+{
+	return
+	(	Camera->Actor->RendMap==REN_Zones
+	&&	Camera->Level->Model->Nodes->NumZones>0
+	&&	(Draw->PolyFlags & PF_Portal) );
+}
+
+//
+// Return the color of a Bsp surface in the flatshaded rendering modes.
+//
+static BYTE FlatSurfColor( UCamera *Camera, FBspDrawList *Draw )
+{
+	guard(FlatSurfColor);
+
+	UModel		*Model		= Camera->Level->Model;
+	FBspNode	*Node		= &Model->Nodes(Draw->iNode);
+	UTexture	*Texture	= Model->Surfs(Draw->iSurf).Texture;
+	if( !Texture ) Texture=GGfx.DefaultTexture;
+
+	BYTE Color = Texture->MipZero.RemapIndex;
+	if( Camera->Actor->RendMap==REN_Zones && Model->Nodes->NumZones>0 )
+	{
+		if( Node->iZone[1] == 0 )
+			Color = 0x67 + ((Draw->iNode&3)<<3);
+		else
+			Color = 0x28 + (Node->iZone[1]&0x07) + ((Draw->iNode&3)<<3) + ((Node->iZone[1]&0x28)<<2);
+	}
+	else
+	{
+		int Index;
+		if (Camera->Actor->RendMap==REN_Polys)	Index=Draw->iSurf;
+		else Index=Draw->iNode;
+
+		if (Color>0x80) Color -= (Index%6) << 3;
+		else			Color += (Index%6) << 3;
+	}
+	return Color;
+
+	unguard;
+}
+
 // Draw a Bsp surface.
 void FRender::DrawBspSurf( UCamera *Camera, FBspDrawList *Draw )
 {
@@ -2416,15 +2711,9 @@ void FRender::DrawBspSurf( UCamera *Camera, FBspDrawList *Draw )
 	}
 #endif
 
-	UModel 		*Model 		= Camera->Level->Model;
-	FBspNode	*Node 		= &Model->Nodes (Draw->iNode);
-	FBspSurf	*Poly 		= &Model->Surfs (Node->iSurf);
 	DWORD		PolyFlags	= Draw->PolyFlags;
 	FSpanBuffer	TempLinearSpan;
 
-	UTexture *Texture = Model->Surfs(Draw->iSurf).Texture;
-	if( !Texture ) Texture=GGfx.DefaultTexture;
-
 	if( GEditor  && GEditor->Scan.Active ) GEditor->Scan.PreScan ();
 	if( PolyFlags & PF_Selected ) TempLinearSpan.CopyIndexFrom(Draw->Span,&GMem);
 
@@ -2435,32 +2724,13 @@ void FRender::DrawBspSurf( UCamera *Camera, FBspDrawList *Draw )
 	{
 		DrawSoftwareTexturedBspSurf(Camera,Draw);
 	}
+	else if( FlatSurfHighlight( Camera, Draw ) )
+	{
+		DrawHighlight( Camera, &Draw->Span, BrushSnapColor );
+	}
 	else
 	{
-		BYTE Color = Texture->MipZero.RemapIndex;
-		int Index;
-		if( Camera->Actor->RendMap==REN_Zones && Model->Nodes->NumZones>0 )
-		{
-			if( Node->iZone[1] == 0 )
-				Color = 0x67 + ((Draw->iNode&3)<<3);
-			else
-				Color = 0x28 + (Node->iZone[1]&0x07) + ((Draw->iNode&3)<<3) + ((Node->iZone[1]&0x28)<<2);
-
-			if( PolyFlags & PF_Portal )
-				DrawHighlight( Camera, &Draw->Span, BrushSnapColor );
-			else
-				DrawFlatPoly( Camera, &Draw->Span, Color );
-		}
-		else
-		{
-			if (Camera->Actor->RendMap==REN_Polys)	Index=Draw->iSurf;
-			else Index=Draw->iNode;
-
-			if (Color>0x80) Color -= (Index%6) << 3;
-			else			Color += (Index%6) << 3;
-
-			DrawFlatPoly( Camera, &Draw->Span, Color );
-		}
+		DrawFlatPoly( Camera, &Draw->Span, FlatSurfColor( Camera, Draw ) );
 	}
 	if( GEditor && (PolyFlags & PF_Selected) )
 	{
@@ -2727,10 +2997,42 @@ void FRender::AntialiasEdge( UCamera *Camera, FLOAT X1, FLOAT Y1, FLOAT X2, FLOA
 struct FBspDrawListPtr
 {
 	FBspDrawList *Ptr;
-	friend inline INT Compare( const FBspDrawListPtr &A, const FBspDrawListPtr &B )
-		{ return A.Ptr->Key - B.Ptr->Key; }
+	friend inline DWORD RadixKey( const FBspDrawListPtr &A )
+		{ return RadixSigned(A.Ptr->Key); }
+};
+
+//
+// Flatshaded solid surfaces for the task threads to draw in bands. This only
+// covers the flatshaded views (REN_Polys, REN_PolyCuts and REN_Zones), which
+// are debugging aids. Textured surfaces are always drawn serially, since the
+// texture mapper keeps its per-surface state in globals (GBlit, the lattice
+// setup and the current light block).
+//
+struct FFlatBands
+{
+	UCamera			*Camera;
+	FBspDrawListPtr	*Draws;		// Surfaces to draw.
+	DWORD			*Pixels;	// Pixel value of each surface.
+	INT				NumDraws;	// Number of surfaces.
+	INT				NumBands;	// Number of horizontal screen bands.
 };
 
+//
+// Draw the lines of every surface which fall in one band of the screen. Solid
+// surfaces' spans never overlap, so bands and surfaces may be drawn in any order.
+//
+static void DrawFlatBand( void *Arg, INT iBand, INT iThread )
+{
+	FFlatBands	&Bands	= *(FFlatBands*)Arg;
+	INT			Y1		= Bands.Camera->Y * (iBand+0) / Bands.NumBands;
+	INT			Y2		= Bands.Camera->Y * (iBand+1) / Bands.NumBands;
+	FSpanBuffer	Band;
+
+	for( INT i=0; i<Bands.NumDraws; i++ )
+		if( Band.WindowFrom( Bands.Draws[i].Ptr->Span, Y1, Y2 ) )
+			DrawFlatSpans( Bands.Camera, &Band, Bands.Pixels[i] );
+}
+
 //
 // Draw the entire world.
 //
@@ -2961,7 +3263,8 @@ void FRender::DrawWorld( UCamera *Camera )
 		(LastDraw[(Draw->PolyFlags & (PF_NoOcclude|PF_Portal))!=0]++)->Ptr = Draw;
 
 	// Sort solid surfaces by texture and then by palette for cache coherence.
-	QSort( FirstDraw[0], Num[0] );
+	FBspDrawListPtr *TempDraw = new(GMem,Num[0])FBspDrawListPtr;
+	RadixSort( FirstDraw[0], TempDraw, Num[0] );
 
 	if( GCameraManager->RenDev )
 	{
@@ -3044,6 +3347,19 @@ void FRender::DrawWorld( UCamera *Camera )
 		if( (Camera->Actor->ShowFlags & SHOW_Backdrop) && (Backdrop.ValidLines>0) )
 			DrawBackdrop( Camera, &Backdrop );
 
+		// In the flatshaded views, solid surfaces may be drawn in screen bands by all
+		// task threads. Textured surfaces aren't banded. The editor's scanning and
+		// selection highlights need them drawn in order.
+		DWORD *Pixels = NULL;
+		if
+		(	Banded
+		&&	GTaskPool.NumThreads>1
+		&&	!GEditor
+		&&	(	Camera->Actor->RendMap==REN_Polys
+			||	Camera->Actor->RendMap==REN_PolyCuts
+			||	Camera->Actor->RendMap==REN_Zones ) )
+			Pixels = new(GMem,Num[0])DWORD;
+
 		// Draw everything.
 		UTexture *PrevTex = (UTexture*)1;
 		for( int Pass=0; Pass<2; Pass++ )
@@ -3069,8 +3385,22 @@ void FRender::DrawWorld( UCamera *Camera )
 					Draw->Span.GetValidRange(&Poly->LastStartY,&Poly->LastEndY);
 				}
 
-				// Draw it.
-				DrawBspSurf( Camera, Draw );
+				// Draw it, or save its color for the bands.
+				if( Pass==0 && Pixels )
+					Pixels[DrawPtr-FirstDraw[0]] = FlatPixel( Camera, FlatSurfColor( Camera, Draw ) );
+				else
+					DrawBspSurf( Camera, Draw );
+			}
+			if( Pass==0 && Pixels )
+			{
+				// Draw the solid surfaces in bands before any transparent ones.
+				FFlatBands Bands;
+				Bands.Camera	= Camera;
+				Bands.Draws		= FirstDraw[0];
+				Bands.Pixels	= Pixels;
+				Bands.NumDraws	= Num[0];
+				Bands.NumBands	= Min( GTaskPool.NumThreads*4, (INT)Camera->Y );
+				GTaskPool.Run( DrawFlatBand, &Bands, Bands.NumBands );
 			}
 		}
 		if( Antialias )
@@ -3100,7 +3430,7 @@ void FRender::DrawWorld( UCamera *Camera )
 		DrawMovingBrushWires(Camera);
 
 	// Finish up.
-	STAT(GStat.GMem       = GMem.GetByteCount());
+	STAT(GStat.GMainMem   = GMem.GetByteCount());
 	STAT(GStat.GDynMem    = GDynMem.GetByteCount());
 	STAT(GStat.NodesTotal = Model->Nodes->Num);
 
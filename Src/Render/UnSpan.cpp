@@ -934,6 +934,32 @@ void FSpanBuffer::CopyIndexFrom( const FSpanBuffer &Source, FMemStack *Mem )
     STAT(unclockSlow(GStat.CopyIndexFrom));
 }
 
+//
+// Make this span buffer a read-only window onto lines Y1 to Y2-1 of an
+// existing one, sharing its index and spans. Returns 1 if any of the
+// source's lines fall in the window, 0 if none do. Allocates nothing,
+// so the window must not be released or merged into.
+//
+// Status: Not performance critical, and safe to call from task threads.
+//
+int FSpanBuffer::WindowFrom( const FSpanBuffer &Source, int Y1, int Y2 )
+{
+	guard(FSpanBuffer::WindowFrom);
+
+	StartY		= Max( Source.StartY, Y1 );
+	EndY		= Min( Source.EndY,   Y2 );
+	if( StartY >= EndY )
+		return 0;
+
+	Index		= Source.Index + (StartY - Source.StartY);
+	ValidLines	= EndY - StartY;
+	xChurn		= 0;
+	Mem			= NULL;
+	return 1;
+
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
     Lattice span downsizing.
 -----------------------------------------------------------------------------*/
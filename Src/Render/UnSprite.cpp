@@ -105,26 +105,10 @@ FDynamicsIndex* dynamicsAdd
 	}
 	else
 	{
-		// Z sort them in.  Things that must remain on top, such as sprites (not chunks) are
-		// assigned a Z value of zero.
-		FDynamicsIndex* TempIndex = Node->GetDynamic(IsBack);
-		FDynamicsIndex* PrevIndex = NULL;
-
-		while( TempIndex->Next && TempIndex->Z<=Z )
-		{
-			PrevIndex = TempIndex;
-			TempIndex = TempIndex->Next;
-		}
-		if( PrevIndex == NULL )
-		{
-			Index->Next = Node->GetDynamic(IsBack);
-			Node->SetDynamic(IsBack,Index);
-		}
-		else
-		{
-			Index->Next			= PrevIndex->Next;
-			PrevIndex->Next		= Index;
-		}
+		// Add at start of list. Final chunks are sorted by Z when
+		// they're prerendered.
+		Index->Next	= Node->GetDynamic(IsBack);
+		Node->SetDynamic( IsBack, Index );
 	}
 	Index->Type     = Type;
 	Index->Sprite	= Sprite;
@@ -511,6 +495,16 @@ void dynamicsFilter( UCamera *Camera, INDEX iNode,INT FilterDown,INT Outside )
 	Dynamics rendering and prerendering.
 ------------------------------------------------------------------------------*/
 
+//
+// Dynamics index pointer for sorting.
+//
+struct FDynamicsIndexPtr
+{
+	FDynamicsIndex *Ptr;
+	friend inline DWORD RadixKey( const FDynamicsIndexPtr &A )
+		{ return RadixFloat(A.Ptr->Z); }
+};
+
 //
 // This is called for a node's dynamic contents when the contents should be drawn.
 // At this instant in time, the span buffer is set up properly for front-to-back rendering.
@@ -534,58 +528,67 @@ void dynamicsPreRender
 	UModel 			*Model		= Camera->Level->Model;
 	FBspNode		*Node 		= &Model->Nodes(iNode);
 
-	for( FDynamicsIndex	*Index = Node->GetDynamic(IsBack); Index; Index=Index->Next )
+	// Gather the final chunks and sort them by increasing Z. Each sprite is
+	// put on the draw list in front of the ones before it, so the sprites
+	// end up drawn from back to front.
+	FMemMark DynamicsMark(GMem);
+	FDynamicsIndex *Index;
+	INT NumChunks = 0;
+	for( Index = Node->GetDynamic(IsBack); Index; Index=Index->Next )
+		NumChunks += (Index->Type==DY_FINALCHUNK);
+	FDynamicsIndexPtr *Chunks   = new(GMem,NumChunks)FDynamicsIndexPtr;
+	FDynamicsIndexPtr *TempPtrs = new(GMem,NumChunks)FDynamicsIndexPtr;
+	NumChunks = 0;
+	for( Index = Node->GetDynamic(IsBack); Index; Index=Index->Next )
+		if( Index->Type==DY_FINALCHUNK )
+			Chunks[NumChunks++].Ptr = Index;
+	RadixSort( Chunks, TempPtrs, NumChunks );
+
+	for( INT i=0; i<NumChunks; i++ )
 	{
-		FSprite	*Sprite = Index->Sprite;
-		switch( Index->Type )
+		Index           = Chunks[i].Ptr;
+		FSprite *Sprite = Index->Sprite;
+		if( !Index->Sprite->SpanBuffer )
 		{
-			case DY_FINALCHUNK:
-				if( !Index->Sprite->SpanBuffer )
-				{
-					// Creating a new span buffer for this sprite.
-					Sprite->SpanBuffer = new(GDynMem)FSpanBuffer;
-					Sprite->SpanBuffer->AllocIndex(Index->Raster->StartY,Index->Raster->EndY,&GDynMem);
+			// Creating a new span buffer for this sprite.
+			Sprite->SpanBuffer = new(GDynMem)FSpanBuffer;
+			Sprite->SpanBuffer->AllocIndex(Index->Raster->StartY,Index->Raster->EndY,&GDynMem);
 
-					if( Sprite->SpanBuffer->CopyFromRaster(*SpanBuffer,*Index->Raster) )
-					{
-						// Span buffer is non-empty, so keep it and put it on the to-draw list.
-						STAT(GStat.ChunksDrawn++);
-						Sprite->Next	= GFirstSprite;
-						GFirstSprite	= Sprite;
-						GNumSprites++;
-					}
-					else
-					{
-						// Span buffer is empty, so ditch it.
-						Sprite->SpanBuffer->Release();
-						Sprite->SpanBuffer = NULL;
-					}
-				}
-				else 
-				{
-					// Merging with the sprite's existing span buffer.
-					// Creating a temporary span buffer.
-					FMemMark Mark(GMem);
-					FSpanBuffer *Span = new(GMem)FSpanBuffer;
-					Span->AllocIndex(Index->Raster->StartY,Index->Raster->EndY,&GMem);
+			if( Sprite->SpanBuffer->CopyFromRaster(*SpanBuffer,*Index->Raster) )
+			{
+				// Span buffer is non-empty, so keep it and put it on the to-draw list.
+				STAT(GStat.ChunksDrawn++);
+				Sprite->Next	= GFirstSprite;
+				GFirstSprite	= Sprite;
+				GNumSprites++;
+			}
+			else
+			{
+				// Span buffer is empty, so ditch it.
+				Sprite->SpanBuffer->Release();
+				Sprite->SpanBuffer = NULL;
+			}
+		}
+		else 
+		{
+			// Merging with the sprite's existing span buffer.
+			// Creating a temporary span buffer.
+			FMemMark Mark(GMem);
+			FSpanBuffer *Span = new(GMem)FSpanBuffer;
+			Span->AllocIndex(Index->Raster->StartY,Index->Raster->EndY,&GMem);
 
-					if (Span->CopyFromRaster(*SpanBuffer,*Index->Raster))
-					{
-						// Temporary span buffer is non-empty, so merge it into sprite's.
-						Sprite->SpanBuffer->MergeWith(*Span);
-						STAT(GStat.ChunksDrawn++);
-					}
+			if (Span->CopyFromRaster(*SpanBuffer,*Index->Raster))
+			{
+				// Temporary span buffer is non-empty, so merge it into sprite's.
+				Sprite->SpanBuffer->MergeWith(*Span);
+				STAT(GStat.ChunksDrawn++);
+			}
 
-					// Release the temporary memory.
-					Mark.Pop();
-				}
-				break;
-			case DY_CHUNK:
-				break;
-			case DY_SPRITE:
-				break;
+			// Release the temporary memory.
+			Mark.Pop();
 		}
 	}
+	DynamicsMark.Pop();
 	unguard;
 }
 
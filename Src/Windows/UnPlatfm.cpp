@@ -26,6 +26,23 @@
 
 #define TRACK_ALLOCS 1
 
+//
+// Memory tracked for one allocation tag. The tag is the description given
+// to appMalloc up to any parenthesized detail, so "Res(Actor)" and
+// "Res(Light)" both count as "Res".
+//
+class FTrackedTag
+{
+public:
+	char				Name[NAME_SIZE];
+	int					LiveBytes;
+	int					LiveCount;
+	int					PeakBytes;
+	int					NumAllocs;
+	FTrackedTag			*HashNext;
+	FTrackedTag			*Next;
+} *GTrackedTags=NULL; // Global list of all tags.
+
 //
 // An entry that tracks one allocated memory block.
 //
@@ -34,10 +51,30 @@ class FTrackedAllocation
 public:
 	void				*Ptr;
 	int					Size;
-	char				Name[NAME_SIZE];
+	FTrackedTag			*Tag;
 	FTrackedAllocation	*Next;
+	FTrackedAllocation	*Prev;
+	FTrackedAllocation	*HashNext;
 } *GTrackedAllocations=NULL; // Global list of all allocations;
 
+// Hash tables of tags by name and allocations by pointer.
+enum {TAG_HASH=256, ALLOC_HASH=4096};
+FTrackedTag			*GTrackedTagHash[TAG_HASH];
+FTrackedAllocation	*GTrackedAllocationHash[ALLOC_HASH];
+
+//
+// Lock held while changing the tracked allocations, since task threads and
+// asynchronous file readers allocate too. It's released by the destructor
+// so that an error thrown while it's held doesn't leave it locked.
+//
+static FSpinLock GTrackedLock;
+class FTrackedLock
+{
+public:
+	FTrackedLock()	{GTrackedLock.Lock();}
+	~FTrackedLock()	{GTrackedLock.Unlock();}
+};
+
 
 int CDECL UnrealAllocationErrorHandler(size_t);
 int SlowLog=0,SlowClosed=0;
@@ -47,6 +84,21 @@ HWND FGlobalPlatform_hWndProgressBar=NULL;
 HWND FGlobalPlatform_hWndProgressText=NULL;
 
 void FGlobalPlatform_MemoryStatus(FOutputDevice &Out);
+void FGlobalPlatform_DumpTrackedTags(FOutputDevice &Out, int Csv);
+
+//
+// An output device which writes lines to a file.
+//
+class FFileOutputDevice : public FOutputDevice
+{
+public:
+	FILE *File;
+	void Write(const void *Data, int Length, ELogType MsgType)
+	{
+		fwrite( Data, Length, 1, File );
+		fputs( "\n", File );
+	}
+};
 
 /*-----------------------------------------------------------------------------
 	FGlobalPlatform Command line.
@@ -75,6 +127,42 @@ int FGlobalPlatform::Exec(const char *Cmd,FOutputDevice *Out)
 	}
 	else if (GetCMD(&Str,"MEM") )
 	{
+		if( GetCMD(&Str,"STACKS") )
+		{
+			FMemStack::Status( Out, GetCMD(&Str,"RESET") );
+			GChunkPool.Status( Out );
+			return 1;
+		}
+		if( GetCMD(&Str,"DETAIL") )
+		{
+			// Report memory by allocation tag, object class and cache id,
+			// as text or CSV, optionally to a file.
+			int Csv = GetCMD(&Str,"CSV");
+			char Filename[256]="";
+			FFileOutputDevice FileOut;
+			FOutputDevice *Dest = Out;
+			if( GetSTRING(Str,"FILE=",Filename,sizeof(Filename)) )
+			{
+				FileOut.File = fopen( Filename, "wt" );
+				if( !FileOut.File )
+				{
+					Out->Logf( LOG_ExecError, "Can't create %s", Filename );
+					return 1;
+				}
+				Dest = &FileOut;
+			}
+			if( Csv )
+				Dest->Log( "Section,Name,Count,Bytes,PeakBytes,PagedBytes" );
+			FGlobalPlatform_DumpTrackedTags( *Dest, Csv );
+			GObj.DumpClassMemory( Dest, Csv );
+			GCache.DumpCategories( Dest, Csv );
+			if( Dest == &FileOut )
+			{
+				fclose( FileOut.File );
+				Out->Logf( "Wrote memory detail to %s", Filename );
+			}
+			return 1;
+		}
 		FGlobalPlatform_MemoryStatus(*Out);
 
 		int All = GetCMD(&Str,"ALL");
@@ -84,7 +172,7 @@ int FGlobalPlatform::Exec(const char *Cmd,FOutputDevice *Out)
 		while( A )
 		{
 			if( All )
-				Out->Logf("  %s - %i",A->Name,A->Size);
+				Out->Logf("  %s - %i",A->Tag->Name,A->Size);
 			Count++;
 			Size += A->Size;
 			A = A->Next;
@@ -266,6 +354,57 @@ int FGlobalPlatform::PasswordDialog( const char *Title, const char *Prompt, char
 	Globals used by the one and only FGlobalPlatform object.
 -----------------------------------------------------------------------------*/
 
+//
+// Find or add the tag for an allocation description.
+//
+FTrackedTag *FGlobalPlatform_FindTrackedTag( const char *Name )
+{
+	guard(FGlobalPlatform_FindTrackedTag);
+
+	// Cut the description at any parenthesized detail.
+	char Key[NAME_SIZE];
+	for( int i=0; i<NAME_SIZE-1 && Name[i] && Name[i]!='('; i++ )
+		Key[i] = Name[i];
+	Key[i] = 0;
+
+	// Find it.
+	DWORD Hash = 0;
+	for( i=0; Key[i]; i++ )
+		Hash = Hash*31 + Key[i];
+	FTrackedTag **HashLink = &GTrackedTagHash[Hash % TAG_HASH];
+	for( FTrackedTag *Tag=*HashLink; Tag; Tag=Tag->HashNext )
+		if( strcmp(Tag->Name,Key)==0 )
+			return Tag;
+
+	// Add it.
+	Tag = new FTrackedTag;
+	strcpy( Tag->Name, Key );
+	Tag->LiveBytes = Tag->LiveCount = Tag->PeakBytes = Tag->NumAllocs = 0;
+	Tag->HashNext  = *HashLink;
+	Tag->Next      = GTrackedTags;
+	*HashLink      = Tag;
+	GTrackedTags   = Tag;
+	return Tag;
+
+	unguard;
+}
+
+//
+// Return the hash table link to a tracked allocation.
+//
+FTrackedAllocation **FGlobalPlatform_FindTrackedAllocation( void *Ptr )
+{
+	guard(FGlobalPlatform_FindTrackedAllocation);
+
+	for( FTrackedAllocation **Link=&GTrackedAllocationHash[((DWORD)Ptr>>4) % ALLOC_HASH]; *Link; Link=&(*Link)->HashNext )
+		if( (*Link)->Ptr == Ptr )
+			return Link;
+
+	appError ("Allocation not found");
+	return NULL;
+	unguard;
+}
+
 //
 // Add a new allocation to the list of tracked allocations.
 //
@@ -274,15 +413,28 @@ void FGlobalPlatform_AddTrackedAllocation( void *Ptr, int Size, char *Name )
 	guard(FGlobalPlatform_AddTrackedAllocation);
 
 	FTrackedAllocation *A = new FTrackedAllocation;
+	FTrackedLock Lock;
 
 	A->Ptr		= Ptr;
 	A->Size		= Size;
+	A->Tag		= FGlobalPlatform_FindTrackedTag( Name );
+	A->Prev		= NULL;
 	A->Next		= GTrackedAllocations;
 
-	strncpy(A->Name,Name,NAME_SIZE); A->Name[31]=0;
-
+	if( A->Next )
+		A->Next->Prev = A;
 	GTrackedAllocations = A;
 
+	FTrackedAllocation **HashLink = &GTrackedAllocationHash[((DWORD)Ptr>>4) % ALLOC_HASH];
+	A->HashNext = *HashLink;
+	*HashLink   = A;
+
+	// Count it.
+	A->Tag->NumAllocs++;
+	A->Tag->LiveCount++;
+	A->Tag->LiveBytes += Size;
+	A->Tag->PeakBytes  = Max( A->Tag->PeakBytes, A->Tag->LiveBytes );
+
 	unguard;
 }
 
@@ -294,23 +446,55 @@ void *FGlobalPlatform_DeleteTrackedAllocation( void *Ptr )
 {
 	guard(FGlobalPlatform_DeleteTrackedAllocation);
 
-	FTrackedAllocation **PrevLink = &GTrackedAllocations;
-	FTrackedAllocation *A         = GTrackedAllocations;
-
-	while( A )
+	FTrackedAllocation *A;
 	{
-		if( A->Ptr == Ptr )
-		{
-			void *Result = A->Ptr;
-			*PrevLink = A->Next;
-			delete A;
-			return Result;
-		}
-		PrevLink = &A->Next;
-		A        = A->Next;
+		FTrackedLock Lock;
+		FTrackedAllocation **HashLink = FGlobalPlatform_FindTrackedAllocation( Ptr );
+		A = *HashLink;
+
+		// Unlink it.
+		*HashLink = A->HashNext;
+		if( A->Prev )
+			A->Prev->Next = A->Next;
+		else
+			GTrackedAllocations = A->Next;
+		if( A->Next )
+			A->Next->Prev = A->Prev;
+
+		// Uncount it.
+		A->Tag->LiveCount--;
+		A->Tag->LiveBytes -= A->Size;
 	}
-	appError ("Allocation not found");
-	return NULL;
+	void *Result = A->Ptr;
+	delete A;
+	return Result;
+	unguard;
+}
+
+//
+// Resize a tracked allocation.
+//
+void *FGlobalPlatform_ReallocTrackedAllocation( void *Ptr, int NewSize )
+{
+	guard(FGlobalPlatform_ReallocTrackedAllocation);
+
+	FTrackedLock Lock;
+	FTrackedAllocation **HashLink = FGlobalPlatform_FindTrackedAllocation( Ptr );
+	FTrackedAllocation *A         = *HashLink;
+	*HashLink                     = A->HashNext;
+
+	// Resize it and count the change.
+	A->Ptr             = realloc( Ptr, NewSize );
+	A->Tag->LiveBytes += NewSize - A->Size;
+	A->Tag->PeakBytes  = Max( A->Tag->PeakBytes, A->Tag->LiveBytes );
+	A->Size            = NewSize;
+
+	// Rehash it at its new address.
+	HashLink    = &GTrackedAllocationHash[((DWORD)A->Ptr>>4) % ALLOC_HASH];
+	A->HashNext = *HashLink;
+	*HashLink   = A;
+	return A->Ptr;
+
 	unguard;
 }
 
@@ -323,12 +507,55 @@ void FGlobalPlatform_DumpTrackedAllocations()
 	FTrackedAllocation *A = GTrackedAllocations;
 	while( A )
 	{
-		App.Platform.Logf(LOG_Exit,"Unfreed: %s",A->Name);
+		App.Platform.Logf(LOG_Exit,"Unfreed: %s",A->Tag->Name);
 		A = A->Next;
 	}
 	unguard;
 }
 
+// Quicksort callback for sorting tags by live bytes, largest first.
+int CDECL TrackedTagCompare( const void *elem1, const void *elem2 )
+{
+	return (*(FTrackedTag**)elem2)->LiveBytes - (*(FTrackedTag**)elem1)->LiveBytes;
+}
+
+//
+// Report live and peak memory of each allocation tag.
+//
+void FGlobalPlatform_DumpTrackedTags( FOutputDevice &Out, int Csv )
+{
+	guard(FGlobalPlatform_DumpTrackedTags);
+#if CHECK_ALLOCS
+	// Sort the tags.
+	FMemMark Mark(GMem);
+	int NumTags=0;
+	for( FTrackedTag *Tag=GTrackedTags; Tag; Tag=Tag->Next )
+		NumTags++;
+	FTrackedTag **Tags = new(GMem,NumTags)FTrackedTag*;
+	NumTags = 0;
+	for( Tag=GTrackedTags; Tag; Tag=Tag->Next )
+		Tags[NumTags++] = Tag;
+	qsort( Tags, NumTags, sizeof(FTrackedTag*), TrackedTagCompare );
+
+	// Report them.
+	if( !Csv )
+		Out.Log( "Allocations by tag:" );
+	for( int i=0; i<NumTags; i++ )
+	{
+		Tag = Tags[i];
+		if( Csv )
+			Out.Logf( "Tag,%s,%i,%i,%i,0", Tag->Name, Tag->LiveCount, Tag->LiveBytes, Tag->PeakBytes );
+		else
+			Out.Logf( "  %-24s %8iK in %6i blocks, peak %8iK, %i allocated", Tag->Name, Tag->LiveBytes/1024, Tag->LiveCount, Tag->PeakBytes/1024, Tag->NumAllocs );
+	}
+	Mark.Pop();
+#else
+	if( !Csv )
+		Out.Log( "Allocation tags are only tracked when built with CHECK_ALLOCS" );
+#endif
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	FGlobalPlatform init/exit.
 -----------------------------------------------------------------------------*/
@@ -868,6 +1095,139 @@ int FGlobalPlatform::FindFile( const char *In, char *Out )
 	unguard;
 }
 
+/*-----------------------------------------------------------------------------
+	FGlobalPlatform threading.
+-----------------------------------------------------------------------------*/
+
+//
+// Start parameters for a thread created with BeginThread.
+//
+struct FGlobalPlatform_ThreadStart
+{
+	void (*ThreadProc)(void *Arg);
+	void *Arg;
+};
+
+//
+// Win32 entry point of all threads created with BeginThread.
+//
+static DWORD WINAPI FGlobalPlatform_ThreadMain( void *Start )
+{
+	FGlobalPlatform_ThreadStart ThreadStart = *(FGlobalPlatform_ThreadStart*)Start;
+	delete (FGlobalPlatform_ThreadStart*)Start;
+	ThreadStart.ThreadProc( ThreadStart.Arg );
+	return 0;
+}
+
+//
+// Return the number of processors in the system.
+//
+INT FGlobalPlatform::NumProcessors()
+{
+	guard(FGlobalPlatform::NumProcessors);
+	SYSTEM_INFO SystemInfo;
+	GetSystemInfo( &SystemInfo );
+	return Max( (INT)SystemInfo.dwNumberOfProcessors, 1 );
+	unguard;
+}
+
+//
+// Start a thread which calls ThreadProc(Arg) and exits when it returns.
+// Returns a handle which must be passed to EndThread.
+//
+DWORD FGlobalPlatform::BeginThread( void (*ThreadProc)(void *Arg), void *Arg )
+{
+	guard(FGlobalPlatform::BeginThread);
+
+	FGlobalPlatform_ThreadStart *Start = new FGlobalPlatform_ThreadStart;
+	Start->ThreadProc = ThreadProc;
+	Start->Arg        = Arg;
+
+	DWORD  ThreadId;
+	HANDLE hThread = ::CreateThread( NULL, 0, FGlobalPlatform_ThreadMain, Start, 0, &ThreadId );
+	if( !hThread )
+		appErrorf( "CreateThread failed (%i)", GetLastError() );
+
+	return (DWORD)hThread;
+	unguard;
+}
+
+//
+// Wait for a thread started with BeginThread to exit, and close it.
+//
+void FGlobalPlatform::EndThread( DWORD hThread )
+{
+	guard(FGlobalPlatform::EndThread);
+	WaitForSingleObject( (HANDLE)hThread, INFINITE );
+	CloseHandle( (HANDLE)hThread );
+	unguard;
+}
+
+//
+// Create a counting semaphore.
+//
+DWORD FGlobalPlatform::NewSemaphore( INT InitialCount )
+{
+	guard(FGlobalPlatform::NewSemaphore);
+	HANDLE hSemaphore = ::CreateSemaphore( NULL, InitialCount, MAXINT, NULL );
+	if( !hSemaphore )
+		appErrorf( "CreateSemaphore failed (%i)", GetLastError() );
+	return (DWORD)hSemaphore;
+	unguard;
+}
+
+//
+// Destroy a semaphore created with NewSemaphore.
+//
+void FGlobalPlatform::FreeSemaphore( DWORD hSemaphore )
+{
+	guard(FGlobalPlatform::FreeSemaphore);
+	CloseHandle( (HANDLE)hSemaphore );
+	unguard;
+}
+
+//
+// Increase a semaphore's count, releasing up to Count waiting threads.
+//
+void FGlobalPlatform::SignalSemaphore( DWORD hSemaphore, INT Count )
+{
+	guard(FGlobalPlatform::SignalSemaphore);
+	::ReleaseSemaphore( (HANDLE)hSemaphore, Count, NULL );
+	unguard;
+}
+
+//
+// Wait until a semaphore's count is nonzero, and decrement it.
+//
+void FGlobalPlatform::WaitSemaphore( DWORD hSemaphore )
+{
+	guard(FGlobalPlatform::WaitSemaphore);
+	WaitForSingleObject( (HANDLE)hSemaphore, INFINITE );
+	unguard;
+}
+
+//
+// Give up the rest of this thread's time slice.
+//
+void FGlobalPlatform::YieldThread()
+{
+	guard(FGlobalPlatform::YieldThread);
+	Sleep( 0 );
+	unguard;
+}
+
+//
+// Drop whole pages of a read-only file mapping from this process's working
+// set. The pages are read back from the file if they are touched again.
+//
+void FGlobalPlatform::DiscardFilePages( void *Start, INT Size )
+{
+	guard(FGlobalPlatform::DiscardFilePages);
+	// Unlocking pages which aren't locked removes them from the working set.
+	VirtualUnlock( Start, Size );
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	FGlobalPlatform Log routines.
 -----------------------------------------------------------------------------*/
@@ -1163,15 +1523,7 @@ void *VARARGS FGlobalPlatform::Realloc( void *Ptr, int NewSize, const char *Fmt,
 		}
 		else
 		{
-			for( FTrackedAllocation *A = GTrackedAllocations; A; A=A->Next )
-			{
-				if( A->Ptr == Ptr )
-					break;
-			}
-			if( !A ) appErrorf( "Allocation %s not found ",TempStr);
-			A->Ptr = realloc( Ptr, NewSize );
-			A->Size = NewSize;
-			return A->Ptr;
+			return FGlobalPlatform_ReallocTrackedAllocation( Ptr, NewSize );
 		}
 	}
 	unguardf(("(%i %s)",NewSize,TempStr));